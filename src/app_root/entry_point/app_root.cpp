@@ -1,6 +1,7 @@
 #include "app_root/entry_point/app_root.hpp"
 
 #include <qcoreapplication.h>
+#include <qtimer.h>
 
 #include "app_root/model/app_root_model.hpp"
 #include "app_root/view/app_root_view.hpp"
@@ -27,7 +28,39 @@ void AppRoot::bootstrap()
     LOG_INF("AppRoot", "Starting bootstrap...");
 
     LOG_INF("AppRoot", "Instantiating Event Broker...");
-    m_broker = std::make_unique<EventBroker::EventBroker>();
+    auto broker = std::make_unique<EventBroker::EventBroker>();
+    // The GUI thread is a consumer: events published on other threads are delivered in batches
+    // from the Qt event loop, so tabs never see a callback on a foreign thread. It is also the
+    // target of Core::Executor::gui() for subscriptions made on other threads. Delayed wakeups of
+    // conflating subscriptions become single shot timers, started on the GUI thread.
+    // Views only need recent events, so subscriptions drop their oldest events by default when
+    // the GUI falls behind; the logging subscribes lossless.
+    broker->attachGuiConsumer(
+        [this, gui = broker.get()](const std::chrono::milliseconds delay) -> void {
+            QMetaObject::invokeMethod(
+                QCoreApplication::instance(),
+                [this, gui, delay]() -> void {
+                    const auto drain = [this, gui]() -> void {
+                        if (m_broker.get() == gui)
+                        {
+                            gui->drain();
+                        }
+                    };
+                    if (delay.count() > 0)
+                    {
+                        QTimer::singleShot(delay, QCoreApplication::instance(), drain);
+                    }
+                    else
+                    {
+                        drain();
+                    }
+                },
+                Qt::QueuedConnection);
+        },
+        Core::DeliveryPolicy::DropOldest);
+    // Publishes Core::BrokerDiagnosticsEvent, to see where the time of the event handling goes.
+    broker->startDiagnostics(std::chrono::seconds(5));
+    m_broker = std::move(broker);
 
     LOG_INF("AppRoot", "Instantiating Can Handler...");
     m_can_handler = std::make_unique<CanHandler::CanCommunicationHandler>(*m_broker);
@@ -68,14 +101,16 @@ void AppRoot::start()
         QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
                          [this]() -> void { shutdown(); });
 
-    // Tabs Restart on Error while the Broker and Can Handler are fatal
+    // Tabs Restart on Error while the Broker and Can Handler are fatal. Deferred, so a tab is
+    // never replaced while it is still inside the publish of its own stop event.
     m_module_stop_connection = m_broker->subscribe<Core::ModuleStoppedEvent>(
         [this](const Core::ModuleStoppedEvent& event) -> void {
             if (event.diagnostics.wasError)
             {
                 restartModule(event);
             }
-        });
+        },
+        Core::SubscriptionOptions::lossless("module-restart").deferred());
 
     LOG_INF("AppRoot", "Application started: publishing AppStartedEvent!");
     m_broker->publish<Core::AppStartedEvent>(Core::AppStartedEvent());
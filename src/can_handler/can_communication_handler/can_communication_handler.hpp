@@ -41,7 +41,8 @@ class CanCommunicationHandler final : public Core::ILifecycle
    private:
     /**
      * @brief Method, that gets called periodically to check on new can messages over the bus.
-     * It distributes eventual new messages to the connected can handlers for further processing.
+     * It distributes eventual new messages to the connected can handlers for further processing,
+     * handing over all messages of one poll as a single burst.
      */
     void checkCanDeviceForMessages();
     /**
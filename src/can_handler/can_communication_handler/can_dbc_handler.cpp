@@ -0,0 +1,116 @@
+#include "can_dbc_handler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <ctime>
+#include <optional>
+#include <string_view>
+
+#include "core/util/dbc_signal_decoder.hpp"
+
+namespace CanHandler {
+
+namespace {
+
+/**
+ * @brief Decodes the signals of a frame into a message, reusing its signal entries.
+ * @details Multiplexed signals are only decoded if the multiplexer carries their value. Signals
+ * that do not fit into the payload of a short frame are left out.
+ */
+void decodeSignals(const Core::DbcRouting::Route& route, const std::span<const uint8_t> data,
+                   std::vector<Core::DbcCanSignal>& values)
+{
+    const auto messageSignals = route.config->signalsOf(*route.message);
+
+    std::array<char, 24> multiplexText{};
+    std::optional<std::string_view> multiplexValue;
+    const auto multiplexer = std::find_if(
+        messageSignals.begin(), messageSignals.end(), [](const auto& signal) -> bool {
+            return signal.multiplexer && signal.multiplexedBy.empty();
+        });
+    if (multiplexer != messageSignals.end())
+    {
+        if (const auto raw = Core::rawSignalValue(*multiplexer, data))
+        {
+            const auto end = std::to_chars(multiplexText.data(),
+                                           multiplexText.data() + multiplexText.size(), *raw)
+                                 .ptr;
+            multiplexValue.emplace(multiplexText.data(), end - multiplexText.data());
+        }
+    }
+
+    std::size_t count = 0;
+    for (const auto& signal : messageSignals)
+    {
+        if (!signal.multiplexedBy.empty() && signal.multiplexedBy != multiplexValue)
+        {
+            continue;
+        }
+        const auto value = Core::physicalSignalValue(signal, data);
+        if (!value)
+        {
+            continue;
+        }
+        if (count == values.size())
+        {
+            values.emplace_back();
+        }
+        // Assigned, so the names of a recycled message keep their storage.
+        values[count].name = signal.signalName;
+        values[count].value = *value;
+        ++count;
+    }
+    values.resize(count);
+}
+
+}  // namespace
+
+void CanDbcHandler::parseReceivedMessage(const sockcanpp::CanMessage* canMessage)
+{
+    parseReceivedMessages(std::span<const sockcanpp::CanMessage>(canMessage, 1));
+}
+
+void CanDbcHandler::parseReceivedMessages(const std::span<const sockcanpp::CanMessage> canMessages)
+{
+    const auto receiveTime = std::time(nullptr);
+    const auto interface = interfaceId.load(std::memory_order_relaxed);
+    const auto routing = Core::DbcSnapshotRegistry::instance().routing(interface);
+    if (!routing)
+    {
+        return;
+    }
+
+    for (const auto& canMessage : canMessages)
+    {
+        const auto frame = canMessage.getRawFrame();
+        // Error frames report bus errors, they carry no message.
+        if ((frame.can_id & CAN_ERR_FLAG) != 0)
+        {
+            continue;
+        }
+        const auto messageId = messageIdOf(frame);
+        const auto* route = routing->find(messageId);
+        if (!route)
+        {
+            continue;
+        }
+
+        auto payload = messagePool.acquire();
+        auto& message = payload.edit();
+        message.receiveTime = receiveTime;
+        message.messageId = messageId;
+        message.interfaceId = interface;
+        const auto dlc = std::min<std::size_t>(frame.can_dlc, sizeof(frame.data));
+        decodeSignals(*route, std::span<const uint8_t>(frame.data, dlc), message.signalValues);
+        receivedBatch.emplace_back().canMessage = std::move(payload);
+    }
+
+    if (!receivedBatch.empty())
+    {
+        broker.publishBatch(std::span<const Core::ReceivedCanDbcEvent>(receivedBatch));
+        receivedBatch.clear();
+    }
+}
+
+}  // namespace CanHandler
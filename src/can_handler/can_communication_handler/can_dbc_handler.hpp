@@ -4,8 +4,12 @@
 
 #ifndef CANBUSMANAGER_CAN_DBC_HANDLER_HPP
 #define CANBUSMANAGER_CAN_DBC_HANDLER_HPP
+#include <span>
+#include <vector>
+
 #include "core/event/can_event.hpp"
 #include "core/event/dbc_event.hpp"
+#include "core/util/dbc_snapshot_registry.hpp"
 #include "i_can_parser.hpp"
 
 namespace CanHandler {
@@ -16,6 +20,11 @@ namespace CanHandler {
  * messages based on the current DBC configuration and publishes the to the CAN device via the
  * CanCommunication handler. It furthermore translates incoming messages based on the current DBC
  * config into the physical values and publishes them to the event broker
+ *
+ * The DBC configs are not stored here: the routing table of a frame's interface is read from the
+ * @ref Core::DbcSnapshotRegistry, so each frame is decoded against the DBC of its own bus with a
+ * single hash lookup. Tables are loaded once per received batch, so a new DBC takes effect with
+ * the next batch and the previous one is released once the batch is done.
  */
 class CanDbcHandler final : public ICanParser
 {
@@ -26,38 +35,44 @@ class CanDbcHandler final : public ICanParser
             [this](const Core::SendCanMessageDbcEvent& event) -> void {
                 handleSendMessage(event);
             });
-        dbcConfigChangeConnection = eventBroker.subscribe<Core::DBCParsedEvent>(
-            [this](const Core::DBCParsedEvent& event) -> void { handleNewDbc(event); });
     };
     ~CanDbcHandler() override = default;
 
    private:
     /**
      * @brief Parses a CAN message based on the current DBC config, publishes the parsed message to
-     * the event broker
+     * the event broker. The message is decoded into a payload of messagePool, overwriting its
+     * fields, so decoding does not allocate once the pool has warmed up
      * @param canMessage The message to be parsed
      */
     void parseReceivedMessage(const sockcanpp::CanMessage* canMessage) override;
+    /**
+     * @brief Decodes a burst against the routing table of the interface and publishes the frames
+     * described by a DBC as one batch. Frames without a DBC message and error frames are dropped.
+     * @param canMessages The received CAN messages
+     */
+    void parseReceivedMessages(std::span<const sockcanpp::CanMessage> canMessages) override;
     /**
      * @brief Encodes a dbc based decoded message into CAN form. It then publishes it to the CAN
      * device via the CanCommunicationHandler.
      * @param event The decoded message to be published
      */
     void handleSendMessage(const Core::SendCanMessageDbcEvent& event);
-    /**
-     * @brief Updates the currently stored DBC config.
-     * @param event The new DBC config
-     */
-    void handleNewDbc(const Core::DBCParsedEvent& event);
 
     /**
      * @brief The connection containing the subscription to sending dbc based CAN message events
      */
     Core::Connection dbcSendEventConnection;
+
+    /**
+     * @brief The decoded messages, shared by reference with every subscriber of received frames
+     */
+    Core::PayloadPool<Core::DbcCanMessage> messagePool;
     /**
-     * @brief The connection containing the subscription to new DBC configs
+     * @brief Reused buffer for the events of a burst, emptied after publishing so the payloads
+     * return to messagePool once the subscribers are done with them.
      */
-    Core::Connection dbcConfigChangeConnection;
+    std::vector<Core::ReceivedCanDbcEvent> receivedBatch;
 };
 }  // namespace CanHandler
 
@@ -41,6 +41,12 @@ class CanDeviceHandler
      *
      */
     void updateCanDevice(const Core::CanDriverChangeEvent& event);
+    /**
+     * @brief Installs a receive filter on the CAN socket for the IDs that the subscribers of
+     * received frames need, as reported by @code IEventBroker::subscribedIds@endcode for both the
+     * raw and the decoded frame event. If any subscriber needs every ID the filter is removed.
+     */
+    void updateReceiveFilter();
 
     Core::IEventBroker& broker;
     /**
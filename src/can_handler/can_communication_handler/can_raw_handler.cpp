@@ -0,0 +1,39 @@
+#include "can_raw_handler.hpp"
+
+#include <algorithm>
+#include <ctime>
+
+namespace CanHandler {
+
+void CanRawHandler::parseReceivedMessages(const std::span<const sockcanpp::CanMessage> canMessages)
+{
+    const auto receiveTime = std::time(nullptr);
+    const auto interface = interfaceId.load(std::memory_order_relaxed);
+
+    receivedBatch.clear();
+    receivedBatch.reserve(canMessages.size());
+    for (const auto& canMessage : canMessages)
+    {
+        const auto frame = canMessage.getRawFrame();
+        // Error frames report bus errors, they carry no message.
+        if ((frame.can_id & CAN_ERR_FLAG) != 0)
+        {
+            continue;
+        }
+        auto& event = receivedBatch.emplace_back();
+        event.canMessage.receiveTime = receiveTime;
+        event.canMessage.messageId = messageIdOf(frame);
+        event.canMessage.interfaceId = interface;
+        event.canMessage.dlc = static_cast<uint8_t>(
+            std::min<std::size_t>(frame.can_dlc, event.canMessage.data.size()));
+        std::copy_n(reinterpret_cast<const char*>(frame.data), event.canMessage.dlc,
+                    event.canMessage.data.begin());
+    }
+
+    if (!receivedBatch.empty())
+    {
+        broker.publishBatch(std::span<const Core::ReceivedCanRawEvent>(receivedBatch));
+    }
+}
+
+}  // namespace CanHandler
@@ -4,6 +4,8 @@
 
 #ifndef CANBUSMANAGER_CAN_RAW_HANDLER_HPP
 #define CANBUSMANAGER_CAN_RAW_HANDLER_HPP
+#include <vector>
+
 #include "core/event/can_event.hpp"
 #include "i_can_parser.hpp"
 
@@ -31,6 +33,13 @@ class CanRawHandler final : ICanParser
      * @param canMessage The received CAN message
      */
     void parseReceivedMessage(const sockcanpp::CanMessage* canMessage) override;
+    /**
+     * @brief Publishes a received burst as one batch of raw events.
+     * @details Error frames are dropped, the other messages are tagged with the interface set by
+     * setInterface() and carry their CAN ID without the RTR flag.
+     * @param canMessages The received CAN messages
+     */
+    void parseReceivedMessages(std::span<const sockcanpp::CanMessage> canMessages) override;
     /**
      * @brief Handles @code SendRawCanMessageEvent by sending the encoded CAN message to the CAN
      * device via the CanCommunicationHandler
@@ -43,6 +52,10 @@ class CanRawHandler final : ICanParser
      * @brief A connection containing the subscription to sendRawCanMessage events
      */
     Core::Connection rawSendEventConnection;
+    /**
+     * @brief Reused buffer for the events of a burst, so a burst does not allocate.
+     */
+    std::vector<Core::ReceivedCanRawEvent> receivedBatch;
 };
 }  // namespace CanHandler
 
@@ -5,8 +5,15 @@
 #ifndef CANBUSMANAGER_I_CAN_HANDLER_HPP
 #define CANBUSMANAGER_I_CAN_HANDLER_HPP
 #include <CanDriver.hpp>
+#include <atomic>
+#include <cstdint>
+#include <linux/can.h>
+#include <span>
+#include <string_view>
 using sockcanpp::CanMessage;
+#include "core/dto/can_dto.hpp"
 #include "core/interface/i_event_broker.hpp"
+#include "core/util/dbc_snapshot_registry.hpp"
 
 namespace CanHandler {
 /**
@@ -29,8 +36,44 @@ class ICanParser
      * @param canMessage The received message
      */
     virtual void parseReceivedMessage(const sockcanpp::CanMessage* canMessage);
+    /**
+     * @brief Parses a burst of messages received in one poll of the CAN device.
+     * @details Parsers that can publish a whole burst at once (see IEventBroker::publishBatch)
+     * override this, by default every message is parsed on its own.
+     * @param canMessages The received messages in reception order
+     */
+    virtual void parseReceivedMessages(std::span<const sockcanpp::CanMessage> canMessages)
+    {
+        for (const auto& canMessage : canMessages)
+        {
+            parseReceivedMessage(&canMessage);
+        }
+    }
+    /**
+     * @brief Sets the interface the received messages are tagged with.
+     * @details Safe to call while messages are parsed on another thread, it takes effect with the
+     * next burst.
+     * @param interfaceName The name of the CAN device, e.g. "can0", registered in the
+     * @ref Core::DbcSnapshotRegistry on first use
+     */
+    void setInterface(const std::string_view interfaceName)
+    {
+        interfaceId.store(Core::DbcSnapshotRegistry::instance().resolveInterface(interfaceName),
+                          std::memory_order_relaxed);
+    }
+
+   protected:
+    /**
+     * @brief Returns the CAN ID of a frame without the RTR and error flags.
+     * @details Extended IDs keep CAN_EFF_FLAG, which is the bit DBC files mark extended IDs with,
+     * so a 29 bit ID never collides with an 11 bit one.
+     */
+    static auto messageIdOf(const can_frame& frame) -> uint32_t
+    {
+        return (frame.can_id & CAN_EFF_FLAG) != 0 ? frame.can_id & (CAN_EFF_FLAG | CAN_EFF_MASK)
+                                                  : frame.can_id & CAN_SFF_MASK;
+    }
 
-   private:
     /**
      * @brief The event broker to send events to
      */
@@ -40,6 +83,10 @@ class ICanParser
      * indicating if the message was sent successfully
      */
     std::function<bool(const CanMessage&)> sendFunction;
+    /**
+     * @brief The interface the messages are received on, see setInterface()
+     */
+    std::atomic<Core::InterfaceId> interfaceId{0};
 };
 }  // namespace CanHandler
 
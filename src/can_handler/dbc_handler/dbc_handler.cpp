@@ -0,0 +1,500 @@
+#include "dbc_handler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include "core/macro/console_logging.hpp"
+
+namespace CanHandler {
+
+namespace {
+
+/** @brief The section keywords of the DBC format, they end the lists of BU_ and SG_. */
+constexpr auto keywords = std::to_array<std::string_view>(
+    {"VERSION", "NS_", "NS_DESC_", "CM_", "BA_DEF_", "BA_", "VAL_", "CAT_DEF_", "CAT_", "FILTER",
+     "BA_DEF_DEF_", "EV_DATA_", "ENVVAR_DATA_", "SGTYPE_", "SGTYPE_VAL_", "BA_DEF_SGTYPE_",
+     "BA_SGTYPE_", "SIG_TYPE_REF_", "VAL_TABLE_", "SIG_GROUP_", "SIG_VALTYPE_", "SIGTYPE_VALTYPE_",
+     "BO_TX_BU_", "BA_DEF_REL_", "BA_REL_", "BA_DEF_DEF_REL_", "BU_SG_REL_", "BU_EV_REL_",
+     "BU_BO_REL_", "SG_MUL_VAL_", "BS_", "BU_", "BO_", "SG_", "EV_"});
+
+auto isKeyword(const std::string_view token) -> bool
+{
+    return std::find(keywords.begin(), keywords.end(), token) != keywords.end();
+}
+
+auto readFile(const std::string& filePath) -> std::string
+{
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Can not open DBC file " + filePath);
+    }
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+/** @brief The line of the content the tokenizer has reached, for error messages. */
+auto lineAt(const std::string_view content, const DbcTokenizer& tokens) -> std::size_t
+{
+    const auto parsed = content.substr(0, content.size() - tokens.rest().size());
+    return 1 + static_cast<std::size_t>(std::count(parsed.begin(), parsed.end(), '\n'));
+}
+
+/**
+ * @brief Reads a number that has to be followed by the given punctuation.
+ */
+template <typename T>
+auto nextNumberBefore(DbcTokenizer& tokens, const std::string_view punctuation)
+    -> std::optional<T>
+{
+    const auto number = tokens.nextNumber<T>();
+    return number && tokens.accept(punctuation) ? number : std::nullopt;
+}
+
+/**
+ * @brief Reads a single attribute value: a quoted string or a (possibly negative) number.
+ */
+auto nextAttributeValue(DbcTokenizer& tokens) -> std::string
+{
+    const auto token = tokens.next();
+    if (token == "-" || token == "+")
+    {
+        return std::string(token) + std::string(tokens.next());
+    }
+    return DbcTokenizer::unescape(token);
+}
+
+/**
+ * @brief Reads the optional object type keyword of BA_DEF_ and BA_.
+ */
+auto nextObjectType(DbcTokenizer& tokens) -> Core::DbcAttributeObjectType
+{
+    if (tokens.accept("BU_"))
+    {
+        return Core::DbcAttributeObjectType::Node;
+    }
+    if (tokens.accept("BO_"))
+    {
+        return Core::DbcAttributeObjectType::Message;
+    }
+    if (tokens.accept("SG_"))
+    {
+        return Core::DbcAttributeObjectType::Signal;
+    }
+    if (tokens.accept("EV_"))
+    {
+        return Core::DbcAttributeObjectType::EnvironmentVariable;
+    }
+    return Core::DbcAttributeObjectType::Network;
+}
+
+}  // namespace
+
+DbcHandler::~DbcHandler() = default;
+
+void DbcHandler::onStart() {}
+
+void DbcHandler::onStop() {}
+
+void DbcHandler::parseNewDbc(const Core::ParseDBCRequestEvent& event)
+{
+    Core::DBCParsedEvent parsed;
+    try
+    {
+        parsed.config = Core::FlatDbcConfig::fromConfig(parseContent(readFile(event.filePath)));
+        const std::vector<std::string> interfaces(event.interfaces.begin(),
+                                                  event.interfaces.end());
+        parsed.conflicts =
+            Core::DbcSnapshotRegistry::instance().bind(parsed.config, event.filePath, interfaces);
+    }
+    catch (const std::exception& error)
+    {
+        LOG_ERR("DbcHandler", "Parsing {} failed: {}", event.filePath, error.what());
+        Core::DBCParseErrorEvent failed;
+        failed.errorMessage = error.what();
+        failed.requestId = event.requestId;
+        failed.filePath = event.filePath;
+        m_eventBroker.publish(failed);
+        return;
+    }
+
+    parsed.requestId = event.requestId;
+    parsed.filePath = event.filePath;
+    parsed.interfaces = event.interfaces;
+    m_eventBroker.publish(parsed);
+}
+
+auto DbcHandler::parseContent(const std::string_view content) -> Core::DbcConfig
+{
+    Core::DbcConfig config;
+    DbcTokenizer tokens(content);
+    const auto malformed = [&](const std::string_view keyword) -> std::runtime_error {
+        return std::runtime_error("Malformed " + std::string(keyword) + " statement in line " +
+                                  std::to_string(lineAt(content, tokens)));
+    };
+
+    while (!tokens.atEnd())
+    {
+        const auto keyword = tokens.next();
+        if (keyword == "VERSION")
+        {
+            tokens.next();
+        }
+        else if (keyword == "NS_")
+        {
+            // The new symbols are keywords themselves, the list ends with the next section.
+            while (!tokens.atEnd() && tokens.peek() != "BS_" && tokens.peek() != "BU_")
+            {
+                tokens.next();
+            }
+        }
+        else if (keyword == "BS_")
+        {
+            while (!tokens.atEnd() && !isKeyword(tokens.peek()))
+            {
+                tokens.next();
+            }
+        }
+        else if (keyword == "BU_")
+        {
+            config.nodeDefinitions = parseNodes(tokens);
+        }
+        else if (keyword == "BO_")
+        {
+            auto message = parseMessage(tokens);
+            if (!message)
+            {
+                throw malformed(keyword);
+            }
+            config.messageDefinitions.push_back(std::move(*message));
+        }
+        else if (keyword == "VAL_" && DbcTokenizer(tokens).nextNumber<uint>())
+        {
+            // Value descriptions of environment variables have no message ID and are skipped.
+            auto values = parseSignalValue(tokens);
+            if (!values)
+            {
+                throw malformed(keyword);
+            }
+            config.signalValueDescriptions.push_back(std::move(*values));
+        }
+        else if (keyword == "CM_")
+        {
+            if (auto comment = parseComment(tokens))
+            {
+                config.comments.push_back(std::move(*comment));
+            }
+        }
+        else if (keyword == "BA_DEF_")
+        {
+            if (auto definition = parseAttributeDefinition(tokens))
+            {
+                config.attributeDefinitions.push_back(std::move(*definition));
+            }
+        }
+        else if (keyword == "BA_DEF_DEF_")
+        {
+            parseAttributeDefault(tokens, config.attributeDefinitions);
+        }
+        else if (keyword == "BA_")
+        {
+            if (auto value = parseAttributeValue(tokens))
+            {
+                config.attributeValues.push_back(std::move(*value));
+            }
+        }
+        else if (keyword == "SG_")
+        {
+            // Signals are parsed with their message, SG_ has no terminator to skip to.
+            throw malformed(keyword);
+        }
+        else
+        {
+            tokens.skipStatement();
+        }
+    }
+    return config;
+}
+
+auto DbcHandler::parseSignal(DbcTokenizer& tokens) -> std::optional<Core::DbcSignalDescription>
+{
+    Core::DbcSignalDescription signal{};
+    signal.signalName = tokens.next();
+
+    // Multiplexer indicator: M for the multiplexer, mN for a signal sent with value N, or mNM
+    // for both.
+    const auto multiplex = tokens.peek();
+    if (multiplex != ":")
+    {
+        tokens.next();
+        if (!multiplex.starts_with('M') && !multiplex.starts_with('m'))
+        {
+            return std::nullopt;
+        }
+        signal.multiplexer = multiplex.ends_with('M');
+        if (multiplex.starts_with('m'))
+        {
+            signal.multiplexedBy = multiplex.substr(1, multiplex.size() - 1 - signal.multiplexer);
+        }
+    }
+
+    if (!tokens.accept(":"))
+    {
+        return std::nullopt;
+    }
+    const auto startBit = nextNumberBefore<uint>(tokens, "|");
+    const auto signalSize = nextNumberBefore<uint>(tokens, "@");
+    const auto byteOrder = tokens.next();
+    const auto sign = tokens.next();
+    const bool scaling = tokens.accept("(");
+    const auto factor = nextNumberBefore<double>(tokens, ",");
+    const auto offset = nextNumberBefore<double>(tokens, ")");
+    const bool range = tokens.accept("[");
+    const auto minimum = nextNumberBefore<double>(tokens, "|");
+    const auto maximum = nextNumberBefore<double>(tokens, "]");
+    if (!startBit || !signalSize || (byteOrder != "0" && byteOrder != "1") ||
+        (sign != "+" && sign != "-") || !scaling || !factor || !offset || !range || !minimum ||
+        !maximum || signal.signalName.empty())
+    {
+        return std::nullopt;
+    }
+    signal.startBit = *startBit;
+    signal.signalSize = *signalSize;
+    signal.byteOrder = byteOrder == "1";
+    signal.valueType = sign == "-";
+    signal.factor = *factor;
+    signal.offset = *offset;
+    signal.minimum = *minimum;
+    signal.maximum = *maximum;
+    signal.unit = tokens.next();
+
+    do
+    {
+        if (tokens.atEnd() || isKeyword(tokens.peek()))
+        {
+            break;
+        }
+        signal.receivers.emplace_back(tokens.next());
+    } while (tokens.accept(","));
+    return signal;
+}
+
+auto DbcHandler::parseMessage(DbcTokenizer& tokens) -> std::optional<Core::DbcMessageDescription>
+{
+    Core::DbcMessageDescription message{};
+    const auto messageId = tokens.nextNumber<uint>();
+    message.messageName = tokens.next();
+    if (!messageId || message.messageName.empty() || !tokens.accept(":"))
+    {
+        return std::nullopt;
+    }
+    const auto messageSize = tokens.nextNumber<uint>();
+    if (!messageSize)
+    {
+        return std::nullopt;
+    }
+    message.messageId = *messageId;
+    message.messageSize = *messageSize;
+    message.transmitterName = tokens.next();
+
+    while (tokens.accept("SG_"))
+    {
+        auto signal = parseSignal(tokens);
+        if (!signal)
+        {
+            return std::nullopt;
+        }
+        message.signalDescriptions.push_back(std::move(*signal));
+    }
+    return message;
+}
+
+auto DbcHandler::parseValue(DbcTokenizer& tokens) -> std::optional<Core::DbcValueDescription>
+{
+    const auto value = tokens.nextNumber<double>();
+    if (!value)
+    {
+        return std::nullopt;
+    }
+    return Core::DbcValueDescription{*value, DbcTokenizer::unescape(tokens.next())};
+}
+
+auto DbcHandler::parseSignalValue(DbcTokenizer& tokens)
+    -> std::optional<Core::DbcSignalValueDescription>
+{
+    Core::DbcSignalValueDescription description{};
+    const auto messageId = tokens.nextNumber<uint>();
+    description.signalName = tokens.next();
+    if (!messageId || description.signalName.empty())
+    {
+        tokens.skipStatement();
+        return std::nullopt;
+    }
+    description.messageId = *messageId;
+
+    while (!tokens.accept(";"))
+    {
+        auto value = parseValue(tokens);
+        if (!value)
+        {
+            tokens.skipStatement();
+            return std::nullopt;
+        }
+        description.signalDescriptions.push_back(std::move(*value));
+    }
+    return description;
+}
+
+auto DbcHandler::parseNodes(DbcTokenizer& tokens) -> std::list<std::string>
+{
+    std::list<std::string> nodes;
+    tokens.accept(":");
+    while (!tokens.atEnd() && !isKeyword(tokens.peek()))
+    {
+        nodes.emplace_back(tokens.next());
+    }
+    return nodes;
+}
+
+auto DbcHandler::parseComment(DbcTokenizer& tokens) -> std::optional<std::string>
+{
+    bool valid = true;
+    if (tokens.accept("BU_") || tokens.accept("EV_"))
+    {
+        valid = !tokens.next().empty();
+    }
+    else if (tokens.accept("BO_"))
+    {
+        valid = tokens.nextNumber<uint>().has_value();
+    }
+    else if (tokens.accept("SG_"))
+    {
+        valid = tokens.nextNumber<uint>().has_value() && !tokens.next().empty();
+    }
+
+    auto comment = DbcTokenizer::unescape(tokens.next());
+    if (!valid || !tokens.accept(";"))
+    {
+        tokens.skipStatement();
+        return std::nullopt;
+    }
+    return comment;
+}
+
+auto DbcHandler::parseAttributeDefinition(DbcTokenizer& tokens)
+    -> std::optional<Core::DbcAttributeDefinition>
+{
+    Core::DbcAttributeDefinition definition{};
+    definition.objectType = nextObjectType(tokens);
+    definition.attributeName = tokens.next();
+
+    const auto valueType = tokens.next();
+    if (valueType == "INT" || valueType == "HEX" || valueType == "FLOAT")
+    {
+        definition.valueType = valueType == "INT"   ? Core::DbcAttributeValueType::Int
+                               : valueType == "HEX" ? Core::DbcAttributeValueType::Hex
+                                                    : Core::DbcAttributeValueType::Float;
+        const auto minimum = tokens.nextNumber<double>();
+        const auto maximum = tokens.nextNumber<double>();
+        if (!minimum || !maximum)
+        {
+            tokens.skipStatement();
+            return std::nullopt;
+        }
+        definition.minimum = *minimum;
+        definition.maximum = *maximum;
+    }
+    else if (valueType == "STRING")
+    {
+        definition.valueType = Core::DbcAttributeValueType::String;
+    }
+    else if (valueType == "ENUM")
+    {
+        definition.valueType = Core::DbcAttributeValueType::Enum;
+        do
+        {
+            definition.enumValues.push_back(DbcTokenizer::unescape(tokens.next()));
+        } while (tokens.accept(","));
+    }
+    else
+    {
+        tokens.skipStatement();
+        return std::nullopt;
+    }
+
+    if (!tokens.accept(";") || definition.attributeName.empty())
+    {
+        tokens.skipStatement();
+        return std::nullopt;
+    }
+    return definition;
+}
+
+auto DbcHandler::parseAttributeDefault(DbcTokenizer& tokens,
+                                       std::list<Core::DbcAttributeDefinition>& definitions)
+    -> bool
+{
+    const auto attributeName = tokens.next();
+    auto value = nextAttributeValue(tokens);
+    if (!tokens.accept(";"))
+    {
+        tokens.skipStatement();
+        return false;
+    }
+
+    const auto definition = std::find_if(
+        definitions.begin(), definitions.end(),
+        [&](const auto& candidate) -> bool { return candidate.attributeName == attributeName; });
+    if (definition == definitions.end())
+    {
+        return false;
+    }
+    definition->defaultValue = std::move(value);
+    return true;
+}
+
+auto DbcHandler::parseAttributeValue(DbcTokenizer& tokens) -> std::optional<Core::DbcAttributeValue>
+{
+    Core::DbcAttributeValue value{};
+    value.attributeName = tokens.next();
+    value.objectType = nextObjectType(tokens);
+
+    switch (value.objectType)
+    {
+        case Core::DbcAttributeObjectType::Node:
+        case Core::DbcAttributeObjectType::EnvironmentVariable:
+            value.objectName = tokens.next();
+            break;
+        case Core::DbcAttributeObjectType::Message:
+        case Core::DbcAttributeObjectType::Signal:
+        {
+            const auto messageId = tokens.nextNumber<uint>();
+            if (!messageId)
+            {
+                tokens.skipStatement();
+                return std::nullopt;
+            }
+            value.messageId = *messageId;
+            if (value.objectType == Core::DbcAttributeObjectType::Signal)
+            {
+                value.signalName = tokens.next();
+            }
+            break;
+        }
+        case Core::DbcAttributeObjectType::Network:
+            break;
+    }
+
+    value.value = nextAttributeValue(tokens);
+    if (!tokens.accept(";") || value.attributeName.empty())
+    {
+        tokens.skipStatement();
+        return std::nullopt;
+    }
+    return value;
+}
+
+}  // namespace CanHandler
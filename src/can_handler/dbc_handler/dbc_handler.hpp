@@ -4,19 +4,29 @@
 
 #ifndef CANBUSMANAGER_DBC_HANDLER_HPP
 #define CANBUSMANAGER_DBC_HANDLER_HPP
+#include <list>
+#include <optional>
+#include <string>
+#include <string_view>
+
 #include "core/event/dbc_event.hpp"
 #include "core/interface/i_lifecycle.hpp"
+#include "core/util/dbc_snapshot_registry.hpp"
+#include "dbc_tokenizer.hpp"
 namespace CanHandler {
 /**
  * @brief The DbcHandler is responsible for parsing DBC configurations from a file.
+ * Several DBCs can be loaded at once, each bound to the interfaces given in the request.
  */
 class DbcHandler final : Core::ILifecycle
 {
    public:
     explicit DbcHandler(Core::IEventBroker& eventBroker) : Core::ILifecycle(eventBroker)
     {
+        // Parsing a large DBC takes a while, so it runs on a worker instead of the GUI thread.
         parseNewDbcConnection = eventBroker.subscribe<Core::ParseDBCRequestEvent>(
-            [this](const Core::ParseDBCRequestEvent& event) -> void { parseNewDbc(event); });
+            [this](const Core::ParseDBCRequestEvent& event) -> void { parseNewDbc(event); },
+            Core::SubscriptionOptions::lossless("dbc-parser").on(Core::Executor::worker("dbc")));
     };
     ~DbcHandler() override;
 
@@ -27,53 +37,85 @@ class DbcHandler final : Core::ILifecycle
    private:
     /**
      * @brief Function called on the @ref [Core::ParseDBCRequestEvent] event, tries to parse the
-     * provided DBC, publishes an Event on success/fail
+     * provided DBC, publishes an Event on success/fail. On success the parsed config is converted
+     * once into a @ref Core::FlatDbcConfig, which is bound to the requested interfaces in the
+     * @ref Core::DbcSnapshotRegistry before the @ref Core::DBCParsedEvent is fired. ID collisions
+     * with other DBCs on the same interfaces are reported in that event. Both events carry the
+     * requestId of the request, so the request can be awaited via Core::IEventBroker::request()
      * @param event The @ref [Core::ParseDBCRequestEvent] to parse a new DBC
      */
     void parseNewDbc(const Core::ParseDBCRequestEvent& event);
     /**
-     * @brief tries to parse the start of the provided file to a signal (SG_:)
-     * @param file The provided rest of a DBC file (truncated to after the signal if a signal is
-     * parsed)
-     * @return The parsed signal or a null pointer if no signal was parsed
+     * @brief Parses the content of a DBC file.
+     * @details Statements that are not needed for decoding (e.g. VAL_TABLE_ or SIG_GROUP_) and
+     * malformed comments and attributes are skipped.
+     * @param content The whole DBC file
+     * @return The parsed configuration
+     * @throws std::runtime_error If a message, signal or value description is malformed
+     */
+    auto parseContent(std::string_view content) -> Core::DbcConfig;
+    /**
+     * @brief tries to parse a signal (SG_)
+     * @param tokens The tokenizer, positioned after the SG_ keyword
+     * @return The parsed signal or std::nullopt if the statement is malformed
+     */
+    auto parseSignal(DbcTokenizer& tokens) -> std::optional<Core::DbcSignalDescription>;
+    /**
+     * @brief tries to parse a message (BO_) including its signals
+     * @param tokens The tokenizer, positioned after the BO_ keyword. It is advanced past the last
+     * signal of the message
+     * @return The parsed message or std::nullopt if the message or one of its signals is malformed
+     */
+    auto parseMessage(DbcTokenizer& tokens) -> std::optional<Core::DbcMessageDescription>;
+    /**
+     * @brief tries to parse a single value description (a value and its quoted meaning)
+     * @param tokens The tokenizer, positioned at the value
+     * @return The parsed value description or std::nullopt if it is malformed
+     */
+    auto parseValue(DbcTokenizer& tokens) -> std::optional<Core::DbcValueDescription>;
+    /**
+     * @brief tries to parse the value descriptions of a signal (VAL_)
+     * @param tokens The tokenizer, positioned after the VAL_ keyword. It is advanced past the
+     * statement
+     * @return The parsed value descriptions or std::nullopt if the statement is malformed
      */
-    auto parseSignal(std::string& file) -> Core::DbcSignalDescription;
+    auto parseSignalValue(DbcTokenizer& tokens) -> std::optional<Core::DbcSignalValueDescription>;
     /**
-     * @brief tries to parse the start of the provided file to a message (BO_:)
-     * @param file The provided rest of a DBC file (truncated to after the signal if a message is
-     * parsed)
-     * @return The parsed message or a null pointer if no message was parsed
+     * @brief Parses the list of nodes (BU_), which ends at the next keyword
+     * @param tokens The tokenizer, positioned after the BU_ keyword
+     * @return The node names
      */
-    auto parseMessage(std::string& file) -> Core::DbcMessageDescription;
+    auto parseNodes(DbcTokenizer& tokens) -> std::list<std::string>;
     /**
-     * @brief tries to parse the start of the provided file to a value description
-     * @param file The provided rest of a DBC file (truncated to after the value description if a
-     * message is parsed)
-     * @return The parsed value description or a null pointer if no value description was parsed
+     * @brief tries to parse a comment (CM_) of the network, a node, a message or a signal
+     * @param tokens The tokenizer, positioned after the CM_ keyword. It is advanced past the
+     * statement, also if it could not be parsed
+     * @return The comment text or std::nullopt if the statement is malformed
      */
-    auto parseValue(std::string& file) -> Core::DbcValueDescription;
+    auto parseComment(DbcTokenizer& tokens) -> std::optional<std::string>;
     /**
-     * @brief tries to parse the start of the provided file to a signal value description (VAL_:)
-     * @param file The provided rest of a DBC file (truncated to after the signal value description
-     * if a message is parsed)
-     * @return The parsed signal value description or a null pointer if no signal value description
-     * was parsed
+     * @brief tries to parse an attribute definition (BA_DEF_)
+     * @param tokens The tokenizer, positioned after the BA_DEF_ keyword. It is advanced past the
+     * statement, also if it could not be parsed
+     * @return The parsed definition or std::nullopt if the statement is malformed
      */
-    auto parseSignalValue(std::string& file) -> Core::DbcSignalValueDescription;
+    auto parseAttributeDefinition(DbcTokenizer& tokens)
+        -> std::optional<Core::DbcAttributeDefinition>;
     /**
-     * @brief tries to parse the start of the provided file to a list of nodes (BU_:)
-     * @param file The provided rest of a DBC file
-     * (truncated to after the signal if a list of nodes is parsed)
-     * @return The parsed list of nodes or a null pointer if no list of nodes was parsed
+     * @brief tries to parse an attribute default (BA_DEF_DEF_) and stores it in the matching
+     * definition
+     * @param tokens The tokenizer, positioned after the BA_DEF_DEF_ keyword
+     * @param definitions The definitions parsed so far
+     * @return True if the default was parsed and a matching definition exists
      */
-    auto parseNodes(std::string& file) -> std::list<std::string>;
+    auto parseAttributeDefault(DbcTokenizer& tokens,
+                               std::list<Core::DbcAttributeDefinition>& definitions) -> bool;
     /**
-     * @brief tries to parse the start of the provided file to a comment (CM_:)
-     * @param file The provided rest of a DBC file
-     * (truncated to after the signal if a comment is parsed)
-     * @return The parsed comment or a null pointer if no comment was parsed
+     * @brief tries to parse an attribute value (BA_)
+     * @param tokens The tokenizer, positioned after the BA_ keyword
+     * @return The parsed value or std::nullopt if the statement is malformed
      */
-    auto parseComment(std::string& file) -> std::string;
+    auto parseAttributeValue(DbcTokenizer& tokens) -> std::optional<Core::DbcAttributeValue>;
 
     Core::Connection parseNewDbcConnection;
 };
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace CanHandler {
+
+/**
+ * @brief Zero-copy tokenizer for the DBC file format.
+ *
+ * @details
+ * Works on a view of the file content and hands out views into it, nothing is copied until the
+ * parser stores a value in a DTO. Tokens are identifiers/keywords, numbers, quoted strings
+ * (returned without the quotes and still escaped, see unescape()) and the single character
+ * punctuation `:`, `;`, `,`, `|`, `@`, `+`, `-`, `(`, `)`, `[` and `]`.
+ */
+class DbcTokenizer
+{
+   public:
+    explicit DbcTokenizer(std::string_view content) : m_rest(content) {}
+
+    /**
+     * @brief Returns the next token without consuming it.
+     * @return The token or an empty view at the end of the content.
+     */
+    [[nodiscard]] auto peek() const -> std::string_view
+    {
+        auto copy = *this;
+        return copy.next();
+    }
+
+    /**
+     * @brief Consumes and returns the next token.
+     * @return The token or an empty view at the end of the content.
+     */
+    auto next() -> std::string_view
+    {
+        skipWhitespace();
+        if (m_rest.empty())
+        {
+            return {};
+        }
+        if (m_rest.front() == '"')
+        {
+            const auto end = quotedEnd();
+            const auto token = m_rest.substr(1, end - 1);
+            m_rest.remove_prefix(std::min(end + 1, m_rest.size()));
+            return token;
+        }
+        std::size_t end = 0;
+        while (end < m_rest.size() && isWordCharacter(m_rest[end]))
+        {
+            ++end;
+        }
+        // The exponent sign of a number, e.g. 1E-005, is part of the number.
+        if (end > 1 && std::isdigit(static_cast<unsigned char>(m_rest.front())) &&
+            (m_rest[end - 1] == 'e' || m_rest[end - 1] == 'E') && end + 1 < m_rest.size() &&
+            (m_rest[end] == '-' || m_rest[end] == '+') &&
+            std::isdigit(static_cast<unsigned char>(m_rest[end + 1])))
+        {
+            end += 2;
+            while (end < m_rest.size() && isWordCharacter(m_rest[end]))
+            {
+                ++end;
+            }
+        }
+        end = std::max<std::size_t>(end, 1);
+        const auto token = m_rest.substr(0, end);
+        m_rest.remove_prefix(end);
+        return token;
+    }
+
+    /**
+     * @brief Consumes the next token if it equals the expected one.
+     * @return True if the token was consumed.
+     */
+    auto accept(std::string_view expected) -> bool
+    {
+        if (peek() != expected)
+        {
+            return false;
+        }
+        next();
+        return true;
+    }
+
+    /**
+     * @brief Consumes the next token and converts it to a number.
+     * @return The number or std::nullopt if the token is not a number of type T.
+     */
+    template <typename T>
+    auto nextNumber() -> std::optional<T>
+    {
+        auto token = next();
+        const bool negative = token == "-";
+        if (negative || token == "+")
+        {
+            token = next();
+        }
+        if constexpr (std::is_unsigned_v<T>)
+        {
+            // Negating would wrap around to a large value.
+            if (negative)
+            {
+                return std::nullopt;
+            }
+        }
+        T value{};
+        const auto* begin = token.data();
+        const auto* end = token.data() + token.size();
+        const auto [ptr, error] = std::from_chars(begin, end, value);
+        if (error != std::errc() || ptr != end)
+        {
+            return std::nullopt;
+        }
+        return negative ? static_cast<T>(-value) : value;
+    }
+
+    /**
+     * @brief Skips everything up to and including the next `;`.
+     * @details Used to recover from unknown or malformed statements.
+     */
+    void skipStatement()
+    {
+        while (!m_rest.empty() && m_rest.front() != ';')
+        {
+            // A `;` inside a quoted string does not end the statement.
+            m_rest.remove_prefix(m_rest.front() == '"' ? std::min(quotedEnd() + 1, m_rest.size())
+                                                       : 1);
+        }
+        m_rest.remove_prefix(std::min<std::size_t>(1, m_rest.size()));
+    }
+
+    /**
+     * @brief Resolves the escape sequences of a quoted string token, e.g. `\"` to `"`.
+     * @param token A string token as returned by next(), i.e. without the quotes
+     * @return The text of the string
+     */
+    static auto unescape(const std::string_view token) -> std::string
+    {
+        std::string text;
+        text.reserve(token.size());
+        for (std::size_t i = 0; i < token.size(); ++i)
+        {
+            if (token[i] == '\\' && i + 1 < token.size())
+            {
+                ++i;
+            }
+            text.push_back(token[i]);
+        }
+        return text;
+    }
+
+    /** @brief True if the whole content has been consumed. */
+    [[nodiscard]] auto atEnd() const -> bool
+    {
+        return peek().empty();
+    }
+
+    /** @brief The content that has not been consumed yet. */
+    [[nodiscard]] auto rest() const -> std::string_view
+    {
+        return m_rest;
+    }
+
+   private:
+    static auto isWordCharacter(const char c) -> bool
+    {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.';
+    }
+
+    /**
+     * @brief The position of the closing quote of the string at the front of the content.
+     * @details A backslash escapes the next character, so `\"` and `\\` do not end the string.
+     * @return The position or the size of the content if the string is not terminated
+     */
+    [[nodiscard]] auto quotedEnd() const -> std::size_t
+    {
+        std::size_t end = 1;
+        while (end < m_rest.size() && m_rest[end] != '"')
+        {
+            end += m_rest[end] == '\\' ? 2 : 1;
+        }
+        return std::min(end, m_rest.size());
+    }
+
+    void skipWhitespace()
+    {
+        while (!m_rest.empty() && std::isspace(static_cast<unsigned char>(m_rest.front())))
+        {
+            m_rest.remove_prefix(1);
+        }
+    }
+
+    std::string_view m_rest;
+};
+
+}  // namespace CanHandler
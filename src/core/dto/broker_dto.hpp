@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "core/enum/delivery_policy.hpp"
+#include "core/enum/event_priority.hpp"
+
+namespace Core {
+
+/**
+ * @brief Snapshot of the counters of one event subscription, e.g. to spot a subscriber that
+ * cannot keep up and loses events.
+ */
+struct SubscriptionDiagnostics {
+    /** @brief The label given at subscription, empty if none was given. */
+    std::string label;
+    /** @brief The ID of the event type, see Core::eventTypeId(). */
+    uint32_t eventType;
+    DeliveryPolicy policy;
+    /** @brief Capacity of the mailbox, zero for subscriptions delivered on the publisher. */
+    std::size_t capacity;
+    /** @brief Events put into the mailbox. */
+    uint64_t queued;
+    /** @brief Events handed to the callback. */
+    uint64_t delivered;
+    /** @brief Events discarded because the mailbox was full. */
+    uint64_t dropped;
+    /**
+     * @brief Number of measured callback invocations. Mailbox deliveries are all measured,
+     * inline ones are sampled. Zero if the broker was built without metrics.
+     */
+    uint64_t callbackSamples = 0;
+    /** @brief Duration of a callback invocation, a batch counts as one invocation. */
+    std::chrono::nanoseconds callbackP50{0};
+    std::chrono::nanoseconds callbackP99{0};
+    std::chrono::nanoseconds callbackMax{0};
+};
+
+/**
+ * @brief Snapshot of the traffic of one event type.
+ */
+struct ChannelDiagnostics {
+    /** @brief The ID of the event type, see Core::eventTypeId(). */
+    uint32_t eventType;
+    std::size_t subscribers;
+    /** @brief Events published so far, zero if the broker was built without metrics. */
+    uint64_t published;
+    /** @brief Events published per second since the previous snapshot. */
+    double publishRate;
+};
+
+/**
+ * @brief Time events of one priority lane spent in mailboxes before their callback ran.
+ */
+struct LaneDiagnostics {
+    EventPriority lane;
+    /** @brief Measured deliveries, a batch counts once; zero if built without metrics. */
+    uint64_t deliveries;
+    std::chrono::nanoseconds p50;
+    std::chrono::nanoseconds p99;
+    std::chrono::nanoseconds max;
+};
+
+}  // namespace Core
@@ -5,14 +5,25 @@
 #ifndef CANBUSMANAGER_CAN_DTO_HPP
 #define CANBUSMANAGER_CAN_DTO_HPP
 #include <array>
-#include <list>
+#include <cstdint>
+#include <ctime>
 #include <string>
+#include <vector>
 
 namespace Core {
+/**
+ * @brief Index of a CAN interface (bus), assigned by the DbcSnapshotRegistry.
+ */
+using InterfaceId = uint8_t;
+
 struct RawCanMessage {
     std::time_t receiveTime;
     std::array<char, 8> data;
-    char messageId;
+    uint32_t messageId;
+    /** @brief The interface the frame was received on or is sent to. */
+    InterfaceId interfaceId;
+    /** @brief Number of valid bytes in data. */
+    uint8_t dlc = 8;
 };
 struct DbcCanSignal {
     std::string name;
@@ -20,8 +31,11 @@ struct DbcCanSignal {
 };
 struct DbcCanMessage {
     std::time_t receiveTime;
-    std::list<DbcCanSignal> signalValues;
-    char messageId;
+    /** @brief A vector, so a message recycled by a Core::PayloadPool keeps its capacity. */
+    std::vector<DbcCanSignal> signalValues;
+    uint32_t messageId;
+    /** @brief The interface the frame was received on or is sent to. */
+    InterfaceId interfaceId;
 };
 }  // namespace Core
 #endif  // CANBUSMANAGER_CAN_DTO_HPP
@@ -6,10 +6,13 @@
 #define CANBUSMANAGER_DBC_DTO_HPP
 #include <list>
 #include <string>
+
+#include "core/enum/dbc_attribute_type.hpp"
 namespace Core {
 struct DbcSignalDescription {
     std::string signalName;
     bool multiplexer;
+    /** @brief The multiplexer value the signal is sent with (mN), empty if not multiplexed. */
     std::string multiplexedBy;
     uint startBit;
     uint signalSize;
@@ -38,11 +41,42 @@ struct DbcSignalValueDescription {
     std::string signalName;
     std::list<DbcValueDescription> signalDescriptions;
 };
+/**
+ * @brief An attribute definition (BA_DEF_) including its default value (BA_DEF_DEF_).
+ */
+struct DbcAttributeDefinition {
+    DbcAttributeObjectType objectType;
+    std::string attributeName;
+    DbcAttributeValueType valueType;
+    double minimum;
+    double maximum;
+    /** @brief The labels of an enum attribute, in the order of their indices. */
+    std::list<std::string> enumValues;
+    /** @brief The default value as written in the file, empty if there is none. */
+    std::string defaultValue;
+};
+/**
+ * @brief An attribute value (BA_) assigned to the network, a node, a message or a signal.
+ */
+struct DbcAttributeValue {
+    std::string attributeName;
+    DbcAttributeObjectType objectType;
+    /** @brief The node or environment variable name (Node, EnvironmentVariable only). */
+    std::string objectName;
+    /** @brief The message ID (Message, Signal only). */
+    uint messageId;
+    /** @brief The signal name (Signal only). */
+    std::string signalName;
+    /** @brief The value as written in the file, for enums the index of the label. */
+    std::string value;
+};
 struct DbcConfig {
     std::list<std::string> nodeDefinitions;
     std::list<DbcMessageDescription> messageDefinitions;
     std::list<DbcSignalValueDescription> signalValueDescriptions;
     std::list<std::string> comments;
+    std::list<DbcAttributeDefinition> attributeDefinitions;
+    std::list<DbcAttributeValue> attributeValues;
 };
 }  // namespace Core
 #endif  // CANBUSMANAGER_DBC_DTO_HPP
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace Core {
+
+/**
+ * @brief The kind of DBC object an attribute (BA_DEF_) applies to.
+ */
+enum class DbcAttributeObjectType { Network, Node, Message, Signal, EnvironmentVariable };
+
+/**
+ * @brief The value type of a DBC attribute definition (BA_DEF_).
+ */
+enum class DbcAttributeValueType { Int, Hex, Float, String, Enum };
+
+}  // namespace Core
@@ -0,0 +1,22 @@
+#pragma once
+
+namespace Core {
+
+/**
+ * @brief What a broker does when the mailbox of a subscription on another thread is full.
+ */
+enum class DeliveryPolicy {
+    /**
+     * @brief The publisher waits for space, nothing is lost. A publisher on the consumer thread
+     * itself can not wait, the mailbox grows instead.
+     */
+    Block,
+    /** @brief The oldest queued events are discarded to make room. */
+    DropOldest,
+    /** @brief The new events are discarded. */
+    DropNewest,
+    /** @brief Only the newest event is kept, everything queued before it is discarded. */
+    Conflate
+};
+
+}  // namespace Core
@@ -0,0 +1,19 @@
+#pragma once
+
+namespace Core {
+
+/**
+ * @brief When a subscription published to from its own consumer thread is called.
+ */
+enum class DispatchMode {
+    /** @brief Right away, inside the publish call. */
+    Immediate,
+    /**
+     * @brief Through the mailbox like events from other threads, by the next drain of the
+     * consumer, e.g. the next Qt event loop iteration. A callback publishing to the subscription
+     * never re-enters it.
+     */
+    Deferred
+};
+
+}  // namespace Core
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Core {
+
+/**
+ * @brief Lane an event type is delivered in on a consumer thread.
+ */
+enum class EventPriority {
+    /** @brief Lifecycle, configuration and other rare events, delivered before any data. */
+    Control,
+    /** @brief High volume events such as received CAN frames. */
+    Data
+};
+
+/** @brief Number of EventPriority values, e.g. to size per-lane tables. */
+inline constexpr std::size_t eventPriorityCount = 2;
+
+}  // namespace Core
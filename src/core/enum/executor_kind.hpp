@@ -0,0 +1,21 @@
+#pragma once
+
+namespace Core {
+
+/**
+ * @brief Kind of thread the callback of a subscription runs on, see Core::Executor.
+ */
+enum class ExecutorKind {
+    /** @brief The consumer thread the subscription is made on, else the publishing thread. */
+    Default,
+    /** @brief Always the publishing thread. */
+    Publisher,
+    /** @brief The Qt GUI thread. */
+    Gui,
+    /** @brief A dedicated worker thread, shared by all subscriptions naming the same worker. */
+    Worker,
+    /** @brief The shared worker pool. */
+    Pool
+};
+
+}  // namespace Core
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vector>
+
+#include "core/dto/broker_dto.hpp"
+#include "event.hpp"
+
+namespace Core {
+
+/**
+ * @brief Published periodically by the event broker with a snapshot of its diagnostics, e.g. for
+ * a statistics view or the log.
+ */
+struct BrokerDiagnosticsEvent final : public Event {
+    /** @brief Channels of event types that were published or subscribed to. */
+    std::vector<ChannelDiagnostics> channels;
+    std::vector<SubscriptionDiagnostics> subscriptions;
+    std::vector<LaneDiagnostics> lanes;
+};
+
+}  // namespace Core
@@ -13,6 +13,10 @@ namespace Core {
  */
 class CanDriverChangeEvent final : Event
 {
+   public:
+    static constexpr EventPriority priority = EventPriority::Control;
+
+   private:
     /**
      * @brief The new name of the CAN device.
      */
@@ -10,6 +10,7 @@
 #include <unordered_map>
 
 #include "core/dto/can_dto.hpp"
+#include "core/util/payload_pool.hpp"
 #include "event.hpp"
 namespace Core {
 /**
@@ -21,9 +22,11 @@ struct ReceivedCanRawEvent final : public Event {
 /**
  * @brief Structure of the received can event when a can message is received and used in dbc decoded
  * form
+ * @details The decoded message is pooled and shared, so the event is copied by reference: all
+ * subscribers, also on other threads, and anyone retaining it see the same message.
  */
 struct ReceivedCanDbcEvent final : public Event {
-    DbcCanMessage canMessage;
+    PayloadRef<DbcCanMessage> canMessage;
 };
 /**
  * @brief Structure of the send can event, when an already encoded message should be sent
@@ -38,5 +41,16 @@ struct SendCanMessageRawEvent final : public Event {
 struct SendCanMessageDbcEvent final : public Event {
     DbcCanMessage canMessage;
 };
+
+/** @brief Routes received raw frames by CAN ID and interface, see Core::KeyedEvent. */
+inline auto eventKey(const ReceivedCanRawEvent& event) -> EventKey
+{
+    return {event.canMessage.messageId, event.canMessage.interfaceId};
+}
+/** @brief Routes decoded frames by CAN ID and interface, see Core::KeyedEvent. */
+inline auto eventKey(const ReceivedCanDbcEvent& event) -> EventKey
+{
+    return {event.canMessage->messageId, event.canMessage->interfaceId};
+}
 };  // namespace Core
 #endif  // CANBUSMANAGER_CAN_EVENT_HPP
@@ -5,32 +5,59 @@
 #ifndef CANBUSMANAGER_DBC_EVENT_HPP
 #define CANBUSMANAGER_DBC_EVENT_HPP
 
-#include "core/dto/dbc_dto.hpp"
+#include <list>
+#include <string>
+
+#include "core/util/dbc_snapshot_registry.hpp"
+#include "core/util/flat_dbc_config.hpp"
 #include "event.hpp"
 namespace Core {
 
 /**
  * @brief Structure of the event fired when dbc file has successfully been parsed by the CAN
  * Handler.
+ * @details The configuration is the snapshot that was just bound in the
+ * @ref DbcSnapshotRegistry. Subscribers keep the pointer instead of copying it.
  */
 struct DBCParsedEvent final : Event {
-    DbcConfig config;
+    static constexpr EventPriority priority = EventPriority::Control;
+
+    DbcConfigPtr config;
+    /** @brief The request that was parsed, zero if it was not sent through a request. */
+    RequestId requestId = 0;
     std::string filePath;
+    /** @brief The interfaces the DBC is bound to, empty if it applies to all interfaces. */
+    std::list<std::string> interfaces;
+    /** @brief CAN IDs also described by another DBC on the same interface. */
+    std::list<DbcIdConflict> conflicts;
 };
 
 /**
  * @brief Structure of the event fired when dbc file parsing failed.
  */
 struct DBCParseErrorEvent final : Event {
+    static constexpr EventPriority priority = EventPriority::Control;
+
     std::string errorMessage;
+    /** @brief The request that failed, zero if it was not sent through a request. */
+    RequestId requestId = 0;
     std::string filePath;
 };
 
 /**
  * @brief Structure of the event fired when a dbc file is requested to be parsed.
+ * @details Answered by a DBCParsedEvent or a DBCParseErrorEvent with the same requestId, so it
+ * can be awaited through IEventBroker::request().
  */
 struct ParseDBCRequestEvent final : Event {
+    static constexpr EventPriority priority = EventPriority::Control;
+    using Response = DBCParsedEvent;
+    using Failure = DBCParseErrorEvent;
+
+    RequestId requestId = 0;
     std::string filePath;
+    /** @brief The interfaces to bind the DBC to, empty binds it to all interfaces. */
+    std::list<std::string> interfaces;
 };
 }  // namespace Core
 #endif  // CANBUSMANAGER_DBC_EVENT_HPP
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <concepts>
+#include <cstdint>
+
+#include "core/enum/event_priority.hpp"
+
 namespace Core {
 
 /**
@@ -9,4 +14,56 @@ struct Event {
     virtual ~Event() = default;
 };
 
+/**
+ * @brief Routing key of an event, used by brokers to evaluate filtered subscriptions.
+ */
+struct EventKey {
+    /** @brief The ID the event refers to, e.g. the CAN ID of a frame. */
+    uint32_t id;
+    /** @brief The interface (bus) the event belongs to. */
+    uint8_t interfaceId;
+};
+
+/**
+ * @brief An event that provides a routing key through a free function `eventKey(const Event&)`,
+ * found by argument dependent lookup.
+ */
+template <typename Event>
+concept KeyedEvent = requires(const Event& event) {
+    { eventKey(event) } -> std::same_as<EventKey>;
+};
+
+/**
+ * @brief Correlates the replies to a request with the request, see IEventBroker::request().
+ * Zero marks an event that answers no request.
+ */
+using RequestId = uint64_t;
+
+/**
+ * @brief An event that asks for a reply: it names the `Response` event type that answers it,
+ * optionally a `Failure` event type, and carries a `requestId` that replies copy.
+ */
+template <typename Request>
+concept RequestEvent = requires(Request& request) {
+    typename Request::Response;
+    { request.requestId } -> std::same_as<RequestId&>;
+};
+
+/**
+ * @brief Returns the priority of an event type: its static `priority` member, or
+ * EventPriority::Data if it declares none.
+ */
+template <typename Event>
+constexpr auto eventPriority() -> EventPriority
+{
+    if constexpr (requires { Event::priority; })
+    {
+        return Event::priority;
+    }
+    else
+    {
+        return EventPriority::Data;
+    }
+}
+
 }  // namespace Core
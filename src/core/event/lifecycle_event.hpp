@@ -11,18 +11,22 @@ namespace Core {
  * @brief Structure of the app start event fired when the application starts.
  */
 struct AppStartedEvent : public Event {
+    static constexpr EventPriority priority = EventPriority::Control;
 };
 
 /**
  * @brief Structure of the app stop event fired when the application stops.
  */
 struct AppStoppedEvent : public Event {
+    static constexpr EventPriority priority = EventPriority::Control;
 };
 
 /**
  * @brief Fired when a module of the application starts.
  */
 struct ModuleStartedEvent : public Event {
+    static constexpr EventPriority priority = EventPriority::Control;
+
     std::type_index module_index;
 
     explicit ModuleStartedEvent(std::type_index index) : module_index(std::move(index)) {}
@@ -32,6 +36,8 @@ struct ModuleStartedEvent : public Event {
  * @brief Fired when a module stops, containing performance and status data.
  */
 struct ModuleStoppedEvent : public Event {
+    static constexpr EventPriority priority = EventPriority::Control;
+
     std::type_index module_index;
     ModuleDiagnostics diagnostics;
 
@@ -1,82 +1,188 @@
 #pragma once
-#include <functional>
-#include <typeindex>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
+
+#include "core/dto/broker_dto.hpp"
+#include "core/enum/delivery_policy.hpp"
+#include "core/enum/dispatch_mode.hpp"
+#include "core/enum/executor_kind.hpp"
+#include "core/event/event.hpp"
+#include "core/util/connection.hpp"
+#include "core/util/event_ops.hpp"
+#include "core/util/inplace_delegate.hpp"
+#include "core/util/latest_values.hpp"
+#include "core/util/reply.hpp"
 
 namespace Core {
 
 /**
- * @brief A RAII-style handle for managing event subscriptions.
+ * @brief Selects the thread the callback of a subscription runs on.
+ * @details Callbacks of one subscription never run concurrently, also on the pool.
  */
-class [[nodiscard]] Connection
-{
-   public:
-    Connection() = default;
+struct Executor {
+    ExecutorKind kind = ExecutorKind::Default;
+    /** @brief The name of the worker, only used for ExecutorKind::Worker. */
+    std::string name{};
+
+    /** @brief Runs the callback inline on the publishing thread. */
+    static auto publisher() -> Executor
+    {
+        return {ExecutorKind::Publisher, {}};
+    }
+
+    /** @brief Runs the callback on the Qt GUI thread, e.g. to update a model. */
+    static auto gui() -> Executor
+    {
+        return {ExecutorKind::Gui, {}};
+    }
 
     /**
-     * @brief Internal constructor used by the Broker to wrap unsubscription logic.
-     * @param disconnect A lambda that, when called, removes the listener from the Broker.
+     * @brief Runs the callback on a worker thread of its own, e.g. for a disk writer.
+     * @param name Subscriptions naming the same worker share its thread.
      */
-    explicit Connection(std::function<void()> disconnect) : m_disconnect(std::move(disconnect)) {}
+    static auto worker(std::string name) -> Executor
+    {
+        return {ExecutorKind::Worker, std::move(name)};
+    }
+
+    /** @brief Runs the callback on the shared pool, e.g. for decoding or statistics. */
+    static auto pool() -> Executor
+    {
+        return {ExecutorKind::Pool, {}};
+    }
+};
+
+/**
+ * @brief Where a subscription is delivered and how, if it lives on another thread than the
+ * publisher.
+ */
+struct SubscriptionOptions {
+    static constexpr std::size_t defaultCapacity = 4096;
+    static constexpr std::size_t lossyCapacity = 256;
+
+    /** @brief Overflow policy of the mailbox, empty for the default of the consumer thread. */
+    std::optional<DeliveryPolicy> policy = std::nullopt;
+    /** @brief Number of deliveries the mailbox holds. */
+    std::size_t capacity = defaultCapacity;
+    /** @brief Names the subscription in the diagnostics. */
+    std::string label{};
+    /** @brief The thread the callback runs on. */
+    Executor executor{};
+    /** @brief Whether publishes on the consumer thread itself are queued as well. */
+    DispatchMode dispatch = DispatchMode::Immediate;
 
     /**
-     * @brief The Destructor ensures safety.
-     * When this handle goes out of scope, it automatically unsubscribes the listener.
+     * @brief Nothing is lost, a full mailbox makes the publisher wait, e.g. for logging.
+     * @details A thread of the subscription's own consumer can not wait for it, so there the
+     * mailbox grows beyond its capacity instead.
      */
-    ~Connection()
+    static auto lossless(std::string label) -> SubscriptionOptions
     {
-        release();
+        return {DeliveryPolicy::Block, defaultCapacity, std::move(label), {},
+                DispatchMode::Immediate};
     }
 
-    /** @brief Copying is disabled to prevent multiple objects managing the same lifetime. */
-    Connection(const Connection&) = delete;
-    auto operator=(const Connection&) -> Connection& = delete;
+    /** @brief Old events are dropped when the subscriber falls behind, e.g. for views. */
+    static auto lossy(std::string label, const std::size_t capacity = lossyCapacity)
+        -> SubscriptionOptions
+    {
+        return {DeliveryPolicy::DropOldest, capacity, std::move(label), {},
+                DispatchMode::Immediate};
+    }
 
-    /** @brief Moving transfers the subscription ownership to a new handle. */
-    Connection(Connection&& other) noexcept : m_disconnect(std::move(other.m_disconnect))
+    /**
+     * @brief Returns the options with another executor, e.g.
+     * @code SubscriptionOptions::lossless("log").on(Executor::worker("disk")) @endcode
+     */
+    auto on(Executor target) && -> SubscriptionOptions
     {
-        other.m_disconnect = nullptr;
+        executor = std::move(target);
+        return std::move(*this);
     }
 
-    /** @brief Moving updates the ownership, releasing any existing subscription first. */
-    auto operator=(Connection&& other) noexcept -> Connection&
+    /**
+     * @brief Returns the options with DispatchMode::Deferred, e.g.
+     * @code SubscriptionOptions::lossy("plot").deferred() @endcode
+     */
+    auto deferred() && -> SubscriptionOptions
     {
-        if (this != &other)
-        {
-            release();
-            m_disconnect = std::move(other.m_disconnect);
-            other.m_disconnect = nullptr;
-        }
-        return *this;
+        dispatch = DispatchMode::Deferred;
+        return std::move(*this);
+    }
+};
+
+/**
+ * @brief Selects the events of a KeyedEvent type that a filtered subscription receives.
+ * @details Brokers evaluate the filter before calling the subscriber, so a subscriber that is
+ * only interested in a few CAN IDs is not called for every frame on the bus.
+ */
+struct EventFilter {
+    static constexpr uint32_t allInterfaces = ~uint32_t{0};
+
+    /** @brief The accepted IDs, sorted and unique. Empty accepts every ID. */
+    std::vector<uint32_t> ids;
+    /** @brief Bit n accepts interface n. */
+    uint32_t interfaceMask = allInterfaces;
+
+    /**
+     * @brief Creates a filter from a set of IDs.
+     * @param acceptedIds The accepted IDs in any order, duplicates are ignored.
+     * @param mask The accepted interfaces.
+     */
+    static auto forIds(std::vector<uint32_t> acceptedIds, const uint32_t mask = allInterfaces)
+        -> EventFilter
+    {
+        std::sort(acceptedIds.begin(), acceptedIds.end());
+        acceptedIds.erase(std::unique(acceptedIds.begin(), acceptedIds.end()), acceptedIds.end());
+        return {std::move(acceptedIds), mask};
     }
 
     /**
-     * @brief Manually triggers unsubscription and clears the internal state.
+     * @brief Creates a filter from a bitmap in which bit n accepts ID n, e.g. the 2048 standard
+     * CAN IDs as 32 words.
      */
-    void release()
+    static auto forBitmap(const std::span<const uint64_t> bitmap,
+                          const uint32_t mask = allInterfaces) -> EventFilter
     {
-        if (m_disconnect)
+        EventFilter filter{{}, mask};
+        for (std::size_t word = 0; word < bitmap.size(); ++word)
         {
-            m_disconnect();
-            m_disconnect = nullptr;
+            for (auto bits = bitmap[word]; bits != 0; bits &= bits - 1)
+            {
+                filter.ids.push_back(static_cast<uint32_t>(word * 64 + std::countr_zero(bits)));
+            }
         }
+        return filter;
     }
 
-    /** @brief Checks if the handle currently manages an active subscription. */
-    explicit operator bool() const
+    [[nodiscard]] auto acceptsInterface(const uint8_t interfaceId) const -> bool
     {
-        return m_disconnect != nullptr;
+        return interfaceId < 32 && (interfaceMask & (uint32_t{1} << interfaceId)) != 0;
     }
 
-   private:
-    std::function<void()> m_disconnect;
+    [[nodiscard]] auto accepts(const EventKey& key) const -> bool
+    {
+        return acceptsInterface(key.interfaceId) &&
+               (ids.empty() || std::binary_search(ids.begin(), ids.end(), key.id));
+    }
 };
 
 /**
  * @brief Interface for a central Event Broker (Event Bus).
  * * @details
  * This interface provides a type-safe way for decoupled modules to communicate.
- * It is designed to be a wrapper around systems like 'entt::dispatcher'.
+ * It is implemented by EventBroker::EventBroker, see there for the delivery and threading model.
  */
 class IEventBroker
 {
@@ -84,42 +190,293 @@ class IEventBroker
     virtual ~IEventBroker() = default;
 
     /**
-     * @brief Dispatches an event to all registered listeners immediately.
+     * @brief Dispatches an event to all registered listeners.
+     * @details Listeners on the publishing thread are called immediately, listeners that belong to
+     * another consumer thread receive a copy of the event on that thread. There, events of
+     * EventPriority::Control types (see Core::eventPriority()) overtake queued data events.
      * * @tparam Event The event structure type.
      * @param event The event instance containing the data to be sent.
      */
     template <typename Event>
     void publish(const Event& event)
     {
-        _publish(typeid(Event), &event);
+        _publish(eventTypeId<Event>(), &event, 1, EventOps::of<Event>());
+    }
+
+    /**
+     * @brief Dispatches a batch of events of the same type, e.g. a burst of received frames.
+     * @details Batch subscribers receive the whole batch in one call, single-event subscribers are
+     * called once per event. The lookup of the subscribers and, for other threads, the copy and
+     * the queue slot are paid once per batch instead of once per event.
+     * @tparam Event The event structure type.
+     * @param events The events, in order.
+     */
+    template <typename Event>
+    void publishBatch(std::span<const Event> events)
+    {
+        if (!events.empty())
+        {
+            _publish(eventTypeId<Event>(), events.data(), events.size(), EventOps::of<Event>());
+        }
+    }
+
+    /**
+     * @brief Publishes a request and returns its pending reply, e.g.
+     * @code auto parsed = co_await broker.request(std::move(parseRequest)); @endcode
+     * @details The request gets a new requestId. The reply is the first Response event, or
+     * Failure event if the request names one, that carries the same ID. It is delivered like any
+     * subscription made on the calling thread: on its consumer thread if it is one, so a
+     * coroutine started on the GUI thread also resumes there, else on the replying thread.
+     * @tparam Request A RequestEvent type.
+     * @param request The request, its requestId is overwritten.
+     * @param options Mailbox and executor of the reply subscriptions, e.g. deferred() to resume
+     * only from the next drain if the reply may be published on the requesting thread itself.
+     * @return The pending reply, it must be kept until the reply arrived.
+     */
+    template <RequestEvent Request>
+    auto request(Request request, SubscriptionOptions options) -> Reply<typename Request::Response>
+    {
+        using Response = typename Request::Response;
+        const auto id = Detail::nextRequestId();
+        request.requestId = id;
+
+        Reply<Response> reply(id);
+        if (options.label.empty())
+        {
+            options.label = "reply";
+        }
+        reply.m_connections.push_back(subscribe<Response>(
+            [state = reply.m_state, id](const Response& response) -> void {
+                if (response.requestId == id)
+                {
+                    state->complete([&](auto& s) -> void { s.response = response; });
+                }
+            },
+            options));
+        if constexpr (requires { typename Request::Failure; })
+        {
+            using Failure = typename Request::Failure;
+            reply.m_connections.push_back(subscribe<Failure>(
+                [state = reply.m_state, id](const Failure& failure) -> void {
+                    if (failure.requestId != id)
+                    {
+                        return;
+                    }
+                    state->complete([&](auto& s) -> void {
+                        if constexpr (requires { failure.errorMessage; })
+                        {
+                            s.failure = failure.errorMessage;
+                        }
+                        else
+                        {
+                            s.failure = "Request failed";
+                        }
+                    });
+                },
+                options));
+        }
+        publish(request);
+        return reply;
+    }
+
+    /**
+     * @brief Publishes a request with the default reply options, see above.
+     * @details An overload instead of a default argument: GCC 12 frees the temporary of a
+     * default argument wrongly when the call is the operand of co_await.
+     */
+    template <RequestEvent Request>
+    auto request(Request request) -> Reply<typename Request::Response>
+    {
+        return this->request(std::move(request), SubscriptionOptions{});
     }
 
     /**
      * @brief Registers a callback function for a specific event type.
+     * @details Any callable taking the event works, e.g. a lambda or a std::function. It is stored
+     * inline in the subscription, so it must fit into an EventCallback; dispatching to it does not
+     * allocate and costs one indirect call.
      * * @tparam Event The event structure type to listen for.
      * @param callback The function to execute when the event occurs.
+     * @param options Mailbox policy, capacity and diagnostics label, used if the subscription is
+     * delivered on another thread than the publisher.
      * @return A Connection handle. You MUST store this handle; if it is destroyed,
-     * the subscription ends immediately.
+     * the subscription ends immediately. It also exposes the counters of the subscription.
      */
-    template <typename Event>
-    auto subscribe(std::function<void(const Event&)> callback) -> Connection
+    template <typename Event, typename Callback>
+        requires std::invocable<std::remove_cvref_t<Callback>&, const Event&>
+    auto subscribe(Callback&& callback, SubscriptionOptions options = {}) -> Connection
+    {
+        return _subscribe(eventTypeId<Event>(),
+                          forEachEvent<Event>(std::forward<Callback>(callback)),
+                          std::move(options));
+    }
+
+    /**
+     * @brief Registers a callback that receives events in batches.
+     * @details A single published event arrives as a batch of one. The callback is stored like
+     * in subscribe().
+     * @tparam Event The event structure type to listen for.
+     * @param callback The function to execute with each published batch.
+     * @param options Mailbox policy, capacity and diagnostics label of the subscription.
+     * @return A Connection handle, see subscribe().
+     */
+    template <typename Event, typename Callback>
+        requires std::invocable<std::remove_cvref_t<Callback>&, std::span<const Event>>
+    auto subscribeBatch(Callback&& callback, SubscriptionOptions options = {}) -> Connection
+    {
+        return _subscribe(eventTypeId<Event>(),
+                          [cb = std::forward<Callback>(callback)](
+                              const void* data, const std::size_t count) mutable -> void {
+                              cb(std::span<const Event>(static_cast<const Event*>(data), count));
+                          },
+                          std::move(options));
+    }
+
+    /**
+     * @brief Registers a callback for the events of a KeyedEvent type that pass a filter.
+     * @details The filter is evaluated by the broker, per event of a published batch, so the
+     * callback is only called for matching events.
+     * @tparam Event The event structure type to listen for, e.g. Core::ReceivedCanRawEvent.
+     * @param filter The accepted IDs and interfaces.
+     * @param callback The function to execute for each matching event.
+     * @param options Mailbox policy, capacity and diagnostics label of the subscription.
+     * @return A Connection handle, see subscribe().
+     */
+    template <KeyedEvent Event, typename Callback>
+        requires std::invocable<std::remove_cvref_t<Callback>&, const Event&>
+    auto subscribe(EventFilter filter, Callback&& callback, SubscriptionOptions options = {})
+        -> Connection
+    {
+        return _subscribeFiltered(eventTypeId<Event>(), std::move(filter),
+                                  forEachEvent<Event>(std::forward<Callback>(callback)),
+                                  std::move(options));
+    }
+
+    /**
+     * @brief Registers a conflating callback that receives only the latest event per key, at most
+     * once per @p minInterval.
+     * @details Meant for views that only show the current state, e.g. the newest value of each
+     * frame: however fast events are published, the callback runs at most at the given rate with
+     * the newest event of every key that changed since its previous call. Must be called on a
+     * consumer thread, which the callback is then delivered on.
+     * @tparam Event The event structure type to listen for, e.g. Core::ReceivedCanDbcEvent.
+     * @param minInterval Minimum time between two calls, e.g. 33 ms for 30 Hz.
+     * @param callback The function to execute with the changed events.
+     * @return A Connection handle, see subscribe().
+     * @throws std::logic_error If the calling thread is no consumer thread.
+     */
+    template <KeyedEvent Event, typename Callback>
+        requires std::invocable<std::remove_cvref_t<Callback>&, std::span<const Event>>
+    auto subscribeLatest(std::chrono::milliseconds minInterval, Callback&& callback) -> Connection
+    {
+        struct State {
+            LatestValues<Event> latest;
+            std::vector<Event> taken;
+        };
+        auto state = std::make_shared<State>();
+        return _subscribeConflated(
+            eventTypeId<Event>(), minInterval,
+            [state](const void* data, const std::size_t count) -> void {
+                state->latest.store(std::span<const Event>(static_cast<const Event*>(data), count));
+            },
+            [state, cb = std::forward<Callback>(callback)]() mutable -> void {
+                state->latest.take(state->taken);
+                if (!state->taken.empty())
+                {
+                    cb(std::span<const Event>(state->taken));
+                }
+            });
+    }
+
+    /**
+     * @brief Returns the IDs that the subscribers of an event type need on an interface.
+     * @details This is the data for a filter in the CAN driver or kernel: frames with other IDs
+     * would not reach any subscriber.
+     * @tparam Event The event structure type.
+     * @param interfaceId The interface.
+     * @return The sorted IDs, or std::nullopt if a subscriber accepts every ID on the interface
+     * and thus nothing can be filtered.
+     */
+    template <KeyedEvent Event>
+    auto subscribedIds(const uint8_t interfaceId) -> std::optional<std::vector<uint32_t>>
     {
-        return _subscribe(typeid(Event), [cb = std::move(callback)](const void* data) -> auto {
-            cb(*static_cast<const Event*>(data));
-        });
+        return _subscribedIds(eventTypeId<Event>(), interfaceId);
     }
 
+    /**
+     * @brief Returns the counters and callback durations of all current subscriptions.
+     */
+    virtual auto subscriptionDiagnostics() -> std::vector<SubscriptionDiagnostics> = 0;
+
+    /**
+     * @brief Returns the publish counts and subscriber counts of all event types in use.
+     */
+    virtual auto channelDiagnostics() -> std::vector<ChannelDiagnostics> = 0;
+
+    /**
+     * @brief Returns the queueing latency of the deliveries to consumer threads, per lane.
+     */
+    virtual auto laneDiagnostics() -> std::vector<LaneDiagnostics> = 0;
+
    protected:
     /**
      * @brief Implementation-specific logic for triggering events.
+     * @param type The ID of the event type, see eventTypeId()
+     * @param data A pointer to the first event, only valid during the call
+     * @param count The number of consecutive events, at least one
+     * @param ops Operations to copy the events if they have to outlive the call
      */
-    virtual void _publish(std::type_index type, const void* data) = 0;
+    virtual void _publish(EventTypeId type, const void* data, std::size_t count,
+                          const EventOps& ops) = 0;
 
     /**
      * @brief Implementation-specific logic for storing listeners.
      */
-    virtual auto _subscribe(std::type_index type,
-                            std::function<void(const void*)> callback) -> Connection = 0;
+    virtual auto _subscribe(EventTypeId type, EventCallback callback,
+                            SubscriptionOptions options) -> Connection = 0;
+
+    /**
+     * @brief Implementation-specific logic for storing filtered listeners.
+     * @details The callback must only be called with single events that pass the filter, the key
+     * of an event is available through EventOps::key.
+     */
+    virtual auto _subscribeFiltered(EventTypeId type, EventFilter filter, EventCallback callback,
+                                    SubscriptionOptions options) -> Connection = 0;
+
+    /**
+     * @brief Implementation-specific logic for conflating listeners.
+     * @param type The ID of the event type
+     * @param minInterval Minimum time between two flushes
+     * @param collect Called on the publishing thread with every published batch
+     * @param flush Called on the subscribing consumer thread after events were collected, at
+     * most once per @p minInterval
+     */
+    virtual auto _subscribeConflated(EventTypeId type, std::chrono::milliseconds minInterval,
+                                     EventCallback collect, InplaceDelegate<void()> flush)
+        -> Connection = 0;
+
+    /**
+     * @brief Implementation-specific logic for subscribedIds().
+     */
+    virtual auto _subscribedIds(EventTypeId type, uint8_t interfaceId)
+        -> std::optional<std::vector<uint32_t>> = 0;
+
+   private:
+    /**
+     * @brief Wraps a callback for single events into an EventCallback that walks a batch.
+     */
+    template <typename Event, typename Callback>
+    static auto forEachEvent(Callback&& callback)
+    {
+        return [cb = std::forward<Callback>(callback)](const void* data,
+                                                       const std::size_t count) mutable -> void {
+            const auto* events = static_cast<const Event*>(data);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                cb(events[i]);
+            }
+        };
+    }
 };
 
 }  // namespace Core
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "core/util/inplace_delegate.hpp"
+
+namespace Core {
+
+/**
+ * @brief Live counters of a subscription, see Core::SubscriptionDiagnostics for their meaning.
+ */
+struct SubscriptionStats {
+    std::atomic<uint64_t> queued{0};
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<uint64_t> dropped{0};
+};
+
+/**
+ * @brief A RAII-style handle for managing event subscriptions.
+ */
+class [[nodiscard]] Connection
+{
+   public:
+    Connection() = default;
+
+    /**
+     * @brief Internal constructor used by the Broker to wrap unsubscription logic.
+     * @param disconnect A lambda that, when called, removes the listener from the Broker.
+     */
+    explicit Connection(InplaceDelegate<void()> disconnect,
+                        std::shared_ptr<const SubscriptionStats> stats = nullptr)
+        : m_disconnect(std::move(disconnect)), m_stats(std::move(stats))
+    {
+    }
+
+    /**
+     * @brief The Destructor ensures safety.
+     * When this handle goes out of scope, it automatically unsubscribes the listener.
+     */
+    ~Connection()
+    {
+        release();
+    }
+
+    /** @brief Copying is disabled to prevent multiple objects managing the same lifetime. */
+    Connection(const Connection&) = delete;
+    auto operator=(const Connection&) -> Connection& = delete;
+
+    /** @brief Moving transfers the subscription ownership to a new handle. */
+    Connection(Connection&& other) noexcept
+        : m_disconnect(std::move(other.m_disconnect)), m_stats(std::move(other.m_stats))
+    {
+        other.m_disconnect = nullptr;
+    }
+
+    /** @brief Moving updates the ownership, releasing any existing subscription first. */
+    auto operator=(Connection&& other) noexcept -> Connection&
+    {
+        if (this != &other)
+        {
+            release();
+            m_disconnect = std::move(other.m_disconnect);
+            m_stats = std::move(other.m_stats);
+            other.m_disconnect = nullptr;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Manually triggers unsubscription and clears the internal state.
+     * @details Waits for callbacks of the subscription that are running on other threads, so
+     * whatever they captured may be destroyed once this returns. A callback must therefore not
+     * wait for the thread that releases its connection; publishing to a full lossless mailbox of
+     * that thread is fine, the events are queued beyond its capacity meanwhile. Releasing it from
+     * within the callback itself does not wait.
+     */
+    void release()
+    {
+        if (m_disconnect)
+        {
+            m_disconnect();
+            m_disconnect = nullptr;
+        }
+    }
+
+    /** @brief Checks if the handle currently manages an active subscription. */
+    explicit operator bool() const
+    {
+        return static_cast<bool>(m_disconnect);
+    }
+
+    /**
+     * @brief Returns the counters of the subscription, nullptr if the broker keeps none.
+     * @details They stay readable after the subscription ended.
+     */
+    [[nodiscard]] auto stats() const -> const SubscriptionStats*
+    {
+        return m_stats.get();
+    }
+
+   private:
+    InplaceDelegate<void()> m_disconnect;
+    std::shared_ptr<const SubscriptionStats> m_stats;
+};
+
+}  // namespace Core
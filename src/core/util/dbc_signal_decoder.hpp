@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "flat_dbc_config.hpp"
+
+namespace Core {
+
+/**
+ * @brief Extracts the raw value of a signal from the payload of a CAN frame.
+ * @details Intel signals (byteOrder set) start at their least significant bit, Motorola signals at
+ * their most significant bit, both counted as in DBC files: bit 0 is the least significant bit of
+ * the first byte. Signed signals are sign extended to 64 bits.
+ * @param signal The signal.
+ * @param data The payload, only its first DLC bytes.
+ * @return The raw bits, std::nullopt if the signal does not fit into the payload.
+ */
+inline auto rawSignalValue(const FlatDbcSignal& signal, const std::span<const uint8_t> data)
+    -> std::optional<uint64_t>
+{
+    const auto size = signal.signalSize;
+    if (size == 0 || size > 64)
+    {
+        return std::nullopt;
+    }
+
+    uint64_t raw = 0;
+    if (signal.byteOrder)
+    {
+        if (signal.startBit + size > data.size() * 8)
+        {
+            return std::nullopt;
+        }
+        for (auto bit = signal.startBit + size; bit-- > signal.startBit;)
+        {
+            raw = raw << 1 | ((data[bit / 8] >> (bit % 8)) & 1U);
+        }
+    }
+    else
+    {
+        // Motorola bits run from the start bit down to bit 0 of a byte, then on with bit 7 of the
+        // next byte.
+        auto bit = signal.startBit;
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            if (bit / 8 >= data.size())
+            {
+                return std::nullopt;
+            }
+            raw = raw << 1 | ((data[bit / 8] >> (bit % 8)) & 1U);
+            bit = bit % 8 == 0 ? bit + 15 : bit - 1;
+        }
+    }
+
+    if (signal.valueType && size < 64 && (raw >> (size - 1) & 1U) != 0)
+    {
+        raw |= ~uint64_t{0} << size;
+    }
+    return raw;
+}
+
+/**
+ * @brief Decodes the physical value of a signal, raw * factor + offset.
+ * @return The value, std::nullopt if the signal does not fit into the payload.
+ */
+inline auto physicalSignalValue(const FlatDbcSignal& signal, const std::span<const uint8_t> data)
+    -> std::optional<double>
+{
+    const auto raw = rawSignalValue(signal, data);
+    if (!raw)
+    {
+        return std::nullopt;
+    }
+    const auto value = signal.valueType ? static_cast<double>(static_cast<int64_t>(*raw))
+                                        : static_cast<double>(*raw);
+    return value * signal.factor + signal.offset;
+}
+
+}  // namespace Core
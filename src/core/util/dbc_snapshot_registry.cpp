@@ -0,0 +1,160 @@
+#include "dbc_snapshot_registry.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Core {
+
+auto DbcSnapshotRegistry::instance() -> DbcSnapshotRegistry&
+{
+    static DbcSnapshotRegistry registry;
+    return registry;
+}
+
+auto DbcSnapshotRegistry::resolveInterface(const std::string_view interfaceName) -> InterfaceId
+{
+    std::lock_guard lock(m_bindingMutex);
+    const auto interfaceCount = m_interfaceNames.size();
+    const auto id = registerInterface(interfaceName);
+    if (m_interfaceNames.size() != interfaceCount)
+    {
+        // DBCs bound to all interfaces also apply to the new one.
+        rebuildRouting({});
+    }
+    return id;
+}
+
+auto DbcSnapshotRegistry::interfaceName(const InterfaceId interfaceId) const -> std::string
+{
+    std::lock_guard lock(m_bindingMutex);
+    return interfaceId < m_interfaceNames.size() ? m_interfaceNames[interfaceId] : std::string();
+}
+
+auto DbcSnapshotRegistry::bind(DbcConfigPtr config, const std::string& filePath,
+                               const std::span<const std::string> interfaceNames)
+    -> std::list<DbcIdConflict>
+{
+    std::lock_guard lock(m_bindingMutex);
+    uint32_t mask = 0;
+    try
+    {
+        for (const auto& name : interfaceNames)
+        {
+            mask |= uint32_t{1} << registerInterface(name);
+        }
+    }
+    catch (...)
+    {
+        // The names registered before the failing one still get their routing tables.
+        rebuildRouting({});
+        throw;
+    }
+
+    // A reloaded file keeps its place in the load order, which decides ID collisions.
+    const auto existing =
+        std::find_if(m_bindings.begin(), m_bindings.end(),
+                     [&](const Binding& binding) -> bool { return binding.filePath == filePath; });
+    if (existing != m_bindings.end())
+    {
+        *existing = {config, filePath, interfaceNames.empty(), mask};
+    }
+    else
+    {
+        m_bindings.push_back({config, filePath, interfaceNames.empty(), mask});
+    }
+
+    // Also covers the interfaces registered above.
+    auto conflicts = rebuildRouting(filePath);
+    m_current.store(std::move(config), std::memory_order_release);
+    m_generation.fetch_add(1, std::memory_order_acq_rel);
+    return conflicts;
+}
+
+void DbcSnapshotRegistry::unbind(const std::string& filePath)
+{
+    std::lock_guard lock(m_bindingMutex);
+    std::erase_if(m_bindings,
+                  [&](const Binding& binding) -> bool { return binding.filePath == filePath; });
+    rebuildRouting({});
+    m_current.store(m_bindings.empty() ? nullptr : m_bindings.back().config,
+                    std::memory_order_release);
+    m_generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+auto DbcSnapshotRegistry::registerInterface(const std::string_view interfaceName) -> InterfaceId
+{
+    const auto it = std::find(m_interfaceNames.begin(), m_interfaceNames.end(), interfaceName);
+    if (it != m_interfaceNames.end())
+    {
+        return static_cast<InterfaceId>(it - m_interfaceNames.begin());
+    }
+    if (m_interfaceNames.size() >= maxInterfaces)
+    {
+        throw std::length_error("Too many CAN interfaces registered");
+    }
+    m_interfaceNames.emplace_back(interfaceName);
+    return static_cast<InterfaceId>(m_interfaceNames.size() - 1);
+}
+
+auto DbcSnapshotRegistry::rebuildRouting(const std::string& filePath) -> std::list<DbcIdConflict>
+{
+    std::list<DbcIdConflict> conflicts;
+
+    // Specific bindings take precedence over bindings to all interfaces, then load order.
+    std::vector<const Binding*> ordered;
+    ordered.reserve(m_bindings.size());
+    for (const auto& binding : m_bindings)
+    {
+        ordered.push_back(&binding);
+    }
+    std::stable_partition(ordered.begin(), ordered.end(), [](const Binding* binding) -> bool {
+        return !binding->allInterfaces;
+    });
+
+    // The last pass stands for the interfaces that are not registered yet, which only the
+    // bindings to all interfaces cover. It builds no table but reports their collisions, once for
+    // all interfaces, also before any interface is registered.
+    for (std::size_t id = 0; id <= m_interfaceNames.size(); ++id)
+    {
+        const bool unregistered = id == m_interfaceNames.size();
+        auto routing = std::make_shared<DbcRouting>();
+        std::unordered_map<uint32_t, const Binding*> owners;
+
+        for (const auto* binding : ordered)
+        {
+            if (!binding->allInterfaces &&
+                (unregistered || (binding->interfaceMask & (uint32_t{1} << id)) == 0))
+            {
+                continue;
+            }
+            routing->configs.push_back(binding->config);
+            for (const auto& message : binding->config->messages())
+            {
+                const auto [owner, inserted] = owners.emplace(message.messageId, binding);
+                if (inserted)
+                {
+                    routing->routes.emplace(message.messageId,
+                                            DbcRouting::Route{binding->config.get(), &message});
+                }
+                else if (!filePath.empty() &&
+                         (binding->filePath == filePath || owner->second->filePath == filePath) &&
+                         (unregistered || !owner->second->allInterfaces))
+                {
+                    conflicts.push_back({message.messageId,
+                                         unregistered ? std::string() : m_interfaceNames[id],
+                                         owner->second->filePath, binding->filePath});
+                }
+            }
+        }
+
+        if (unregistered)
+        {
+            break;
+        }
+        m_routing[id].store(routing->configs.empty() ? nullptr : std::move(routing),
+                            std::memory_order_release);
+    }
+    return conflicts;
+}
+
+}  // namespace Core
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "core/dto/can_dto.hpp"
+#include "flat_dbc_config.hpp"
+
+namespace Core {
+
+/**
+ * @brief Routing table of one CAN interface: maps every CAN ID to the DBC message describing it.
+ * @details The table keeps the configurations it refers to alive, so the raw pointers stay valid
+ * for as long as a reader holds the table.
+ */
+struct DbcRouting {
+    struct Route {
+        const FlatDbcConfig* config;
+        const FlatDbcMessage* message;
+    };
+
+    /** @brief The configurations bound to the interface, owning the routed messages. */
+    std::vector<DbcConfigPtr> configs;
+    /** @brief CAN ID -> message of the DBC that owns the ID on this interface. */
+    std::unordered_map<uint32_t, Route> routes;
+
+    /**
+     * @brief Looks up the message for a CAN ID.
+     * @return The route or nullptr if no DBC bound to the interface describes the ID.
+     */
+    [[nodiscard]] auto find(uint32_t messageId) const -> const Route*
+    {
+        const auto it = routes.find(messageId);
+        return it != routes.end() ? &it->second : nullptr;
+    }
+};
+
+/**
+ * @brief A CAN ID that is described by two DBCs bound to the same interface.
+ */
+struct DbcIdConflict {
+    uint32_t messageId;
+    /** @brief The interface of the collision, empty if both DBCs are bound to all interfaces. */
+    std::string interfaceName;
+    /** @brief The DBC that keeps routing the ID. */
+    std::string existingFilePath;
+    /** @brief The DBC whose message for the ID is ignored on this interface. */
+    std::string conflictingFilePath;
+};
+
+/**
+ * @brief Process wide holder of the loaded DBC configurations and their interface bindings.
+ *
+ * @details
+ * Several DBCs can be loaded at the same time, each bound to a set of interfaces (e.g. one DBC
+ * for the powertrain bus and one for the body bus). For every interface the registry keeps a
+ * routing table that is rebuilt whenever a binding changes, so the decoder resolves a frame with
+ * one indexed load of its interface's table and one hash lookup, without searching the DBCs.
+ *
+ * All read accessors are safe from any thread. Replacing a routing table or the current snapshot
+ * is a single atomic swap; readers that still hold the previous pointer keep it alive, and it is
+ * freed as soon as the last frame batch or view releases it. Binding and interface registration
+ * are rare and serialized by a mutex.
+ */
+class DbcSnapshotRegistry
+{
+   public:
+    /** @brief Upper bound for the number of distinct interfaces. */
+    static constexpr std::size_t maxInterfaces = 32;
+
+    DbcSnapshotRegistry() = default;
+
+    DbcSnapshotRegistry(const DbcSnapshotRegistry&) = delete;
+    auto operator=(const DbcSnapshotRegistry&) -> DbcSnapshotRegistry& = delete;
+
+    /**
+     * @brief Returns the registry shared by all modules of the application.
+     */
+    static auto instance() -> DbcSnapshotRegistry&;
+
+    /**
+     * @brief Returns the most recently loaded snapshot, which is the one shown by the views.
+     * @return The shared configuration or nullptr if no DBC has been loaded yet.
+     */
+    [[nodiscard]] auto current() const -> DbcConfigPtr
+    {
+        return m_current.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Returns a counter that is incremented with every change of the bindings.
+     * @details Allows readers to cheaply detect that their cached snapshot is outdated.
+     */
+    [[nodiscard]] auto generation() const -> uint64_t
+    {
+        return m_generation.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Returns the routing table of an interface.
+     * @param interfaceId The interface, as returned by resolveInterface().
+     * @return The table or nullptr if no DBC is bound to the interface.
+     */
+    [[nodiscard]] auto routing(InterfaceId interfaceId) const -> std::shared_ptr<const DbcRouting>
+    {
+        return interfaceId < maxInterfaces
+                   ? m_routing[interfaceId].load(std::memory_order_acquire)
+                   : nullptr;
+    }
+
+    /**
+     * @brief Returns the ID of an interface, registering it on first use.
+     * @param interfaceName The interface name, e.g. "can0".
+     * @return The ID, which stays the same for the lifetime of the registry.
+     * @throws std::length_error If more than maxInterfaces interfaces are registered.
+     */
+    auto resolveInterface(std::string_view interfaceName) -> InterfaceId;
+
+    /**
+     * @brief Returns the name of a registered interface, or an empty string.
+     */
+    [[nodiscard]] auto interfaceName(InterfaceId interfaceId) const -> std::string;
+
+    /**
+     * @brief Loads a DBC and binds it to a set of interfaces.
+     *
+     * Loading a file that is already bound replaces its previous binding and keeps its place in
+     * the load order. If another DBC bound to one of the interfaces already describes a CAN ID,
+     * that DBC keeps the ID and the collision is reported; DBCs bound to all interfaces yield to
+     * DBCs bound to specific ones. Collisions of two DBCs bound to all interfaces are reported
+     * once, also if no interface is registered yet.
+     *
+     * @param config The parsed configuration.
+     * @param filePath The file the configuration was parsed from, identifies the binding.
+     * @param interfaceNames The interfaces to bind to, empty binds to all interfaces.
+     * @return The detected ID collisions, empty if there are none.
+     * @throws std::length_error If more than maxInterfaces interfaces would be registered.
+     */
+    auto bind(DbcConfigPtr config, const std::string& filePath,
+              std::span<const std::string> interfaceNames) -> std::list<DbcIdConflict>;
+
+    /**
+     * @brief Unloads a DBC from all interfaces.
+     * @param filePath The file the configuration was loaded from.
+     */
+    void unbind(const std::string& filePath);
+
+   private:
+    struct Binding {
+        DbcConfigPtr config;
+        std::string filePath;
+        /** @brief Bound to all interfaces, including the ones registered later. */
+        bool allInterfaces;
+        /** @brief Bit mask of the bound interfaces, unused for a binding to all. */
+        uint32_t interfaceMask;
+    };
+
+    /**
+     * @brief Returns the ID of an interface, registering it if it is new, without rebuilding the
+     * routing tables. Called with m_bindingMutex held.
+     * @throws std::length_error If more than maxInterfaces interfaces are registered.
+     */
+    auto registerInterface(std::string_view interfaceName) -> InterfaceId;
+
+    /**
+     * @brief Rebuilds the routing tables of all registered interfaces.
+     * @return The ID collisions involving the binding for @p filePath.
+     */
+    auto rebuildRouting(const std::string& filePath) -> std::list<DbcIdConflict>;
+
+    std::atomic<DbcConfigPtr> m_current;
+    std::atomic<uint64_t> m_generation{0};
+    std::array<std::atomic<std::shared_ptr<const DbcRouting>>, maxInterfaces> m_routing;
+
+    /** @brief Guards the members below. */
+    mutable std::mutex m_bindingMutex;
+    /** @brief Bindings in load order, earlier bindings win ID collisions. */
+    std::vector<Binding> m_bindings;
+    /** @brief Registered interface names, indexed by InterfaceId. */
+    std::vector<std::string> m_interfaceNames;
+};
+
+}  // namespace Core
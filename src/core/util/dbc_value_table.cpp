@@ -0,0 +1,57 @@
+#include "dbc_value_table.hpp"
+
+#include <algorithm>
+
+namespace Core {
+
+DbcValueTable::DbcValueTable(const std::span<const DbcValueDescription> descriptions)
+{
+    m_sorted.reserve(descriptions.size());
+    for (const auto& description : descriptions)
+    {
+        m_sorted.push_back({std::llround(description.value), description.meaning});
+    }
+    // A later VAL_ entry for the same raw value overrides an earlier one.
+    std::stable_sort(m_sorted.begin(), m_sorted.end(), [](const Entry& a, const Entry& b) -> bool {
+        return a.rawValue < b.rawValue;
+    });
+    const auto last =
+        std::unique(m_sorted.rbegin(), m_sorted.rend(), [](const Entry& a, const Entry& b) -> bool {
+            return a.rawValue == b.rawValue;
+        });
+    m_sorted.erase(m_sorted.begin(), last.base());
+
+    if (m_sorted.empty())
+    {
+        return;
+    }
+
+    // Unsigned, the distance of e.g. INT64_MIN and INT64_MAX does not fit into an int64_t.
+    const auto distance = static_cast<uint64_t>(m_sorted.back().rawValue) -
+                          static_cast<uint64_t>(m_sorted.front().rawValue);
+    const auto denseLimit = std::max(denseMinimumSpan, m_sorted.size() * denseLoadFactor);
+    if (distance >= denseLimit || distance >= denseMaximumSpan)
+    {
+        return;
+    }
+
+    m_denseBase = m_sorted.front().rawValue;
+    m_dense.resize(static_cast<std::size_t>(distance) + 1);
+    for (const auto& entry : m_sorted)
+    {
+        m_dense[static_cast<std::size_t>(static_cast<uint64_t>(entry.rawValue) -
+                                         static_cast<uint64_t>(m_denseBase))] = entry.meaning;
+    }
+    m_sorted.clear();
+    m_sorted.shrink_to_fit();
+}
+
+auto DbcValueTable::lookupSorted(const int64_t rawValue) const -> std::string_view
+{
+    const auto it = std::lower_bound(
+        m_sorted.begin(), m_sorted.end(), rawValue,
+        [](const Entry& entry, const int64_t value) -> bool { return entry.rawValue < value; });
+    return it != m_sorted.end() && it->rawValue == rawValue ? it->meaning : std::string_view();
+}
+
+}  // namespace Core
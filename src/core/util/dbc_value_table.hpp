@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "core/dto/dbc_dto.hpp"
+
+namespace Core {
+
+/**
+ * @brief Compiled lookup table for the value descriptions (VAL_) of one signal.
+ *
+ * @details
+ * The descriptions are compiled once when the DBC snapshot is built:
+ * - If the raw values cover a small range, they are stored in a dense array indexed by
+ *   `raw - minimum`, which makes a lookup a single bounds check and array access.
+ * - Otherwise they are stored as a flat array sorted by raw value and looked up by binary search.
+ *
+ * Lookups return views into the strings of the owning @ref FlatDbcConfig and never allocate.
+ * An empty view means the value has no description.
+ */
+class DbcValueTable
+{
+   public:
+    /** @brief Dense storage is always used if the range of raw values is at most this large. */
+    static constexpr std::size_t denseMinimumSpan = 64;
+    /** @brief Otherwise dense storage is used if at least every n-th slot is occupied. */
+    static constexpr std::size_t denseLoadFactor = 4;
+    /** @brief Dense storage is never used above this range of raw values. */
+    static constexpr std::size_t denseMaximumSpan = 65536;
+
+    /**
+     * @brief Compiles the value descriptions of a signal.
+     * @param descriptions The descriptions, the strings must outlive the table.
+     */
+    explicit DbcValueTable(std::span<const DbcValueDescription> descriptions);
+
+    /**
+     * @brief Resolves a raw signal value to its description.
+     * @param rawValue The raw (unscaled) value of the signal.
+     * @return The description or an empty view if there is none.
+     */
+    [[nodiscard]] auto lookup(int64_t rawValue) const -> std::string_view
+    {
+        if (!m_dense.empty())
+        {
+            const auto slot = static_cast<uint64_t>(rawValue) - static_cast<uint64_t>(m_denseBase);
+            return slot < m_dense.size() ? m_dense[slot] : std::string_view();
+        }
+        return lookupSorted(rawValue);
+    }
+
+    /**
+     * @brief Resolves a physical value to its description using the scaling of the signal.
+     * @param physicalValue The decoded value, i.e. `raw * factor + offset`.
+     * @param factor The factor of the signal.
+     * @param offset The offset of the signal.
+     * @return The description or an empty view if there is none.
+     */
+    [[nodiscard]] auto lookupPhysical(double physicalValue, double factor,
+                                      double offset) const -> std::string_view
+    {
+        if (factor == 0.0)
+        {
+            return {};
+        }
+        return lookup(std::llround((physicalValue - offset) / factor));
+    }
+
+    /** @brief True if the table uses dense storage. */
+    [[nodiscard]] auto isDense() const -> bool
+    {
+        return !m_dense.empty();
+    }
+
+   private:
+    struct Entry {
+        int64_t rawValue;
+        std::string_view meaning;
+    };
+
+    [[nodiscard]] auto lookupSorted(int64_t rawValue) const -> std::string_view;
+
+    /** @brief Raw value stored in m_dense[0]. */
+    int64_t m_denseBase = 0;
+    /** @brief Dense storage, empty views mark raw values without description. */
+    std::vector<std::string_view> m_dense;
+    /** @brief Sparse storage, sorted by raw value. */
+    std::vector<Entry> m_sorted;
+};
+
+}  // namespace Core
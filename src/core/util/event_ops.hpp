@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+#include "core/event/event.hpp"
+#include "core/util/inplace_delegate.hpp"
+
+namespace Core {
+
+/**
+ * @brief The type-erased callback a broker stores per subscription.
+ * @details Receives a pointer to the first event and the number of events.
+ */
+using EventCallback = InplaceDelegate<void(const void*, std::size_t)>;
+
+/**
+ * @brief Dense ID of an event type, used by brokers to index their channels.
+ */
+using EventTypeId = uint32_t;
+
+namespace Detail {
+inline auto nextEventTypeId() -> EventTypeId
+{
+    static std::atomic<EventTypeId> next{0};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+}  // namespace Detail
+
+/**
+ * @brief Returns the ID of an event type.
+ * @details IDs are handed out in order of first use starting at zero, so they stay small enough
+ * to index an array. They are stable for the lifetime of the process, not across runs.
+ */
+template <typename Event>
+auto eventTypeId() -> EventTypeId
+{
+    static const EventTypeId id = Detail::nextEventTypeId();
+    return id;
+}
+
+/**
+ * @brief Type-erased copy and destroy operations of an event type.
+ * @details Brokers that deliver events on other threads use these to keep a copy of a batch of
+ * events beyond the publish call.
+ */
+struct EventOps {
+    void* (*clone)(const void* events, std::size_t count);
+    void (*destroy)(void* events, std::size_t count);
+    /** @brief Size of one event, the stride within a batch. */
+    std::size_t size;
+    /** @brief Returns the routing key of one event, nullptr if the type is not a KeyedEvent. */
+    EventKey (*key)(const void* event);
+    /** @brief The lane the events are delivered in on consumer threads. */
+    EventPriority priority;
+
+    /** @brief Returns the operations of an event type. */
+    template <typename Event>
+    static auto of() -> const EventOps&
+    {
+        static constexpr EventOps ops{
+            [](const void* events, const std::size_t count) -> void* {
+                auto* copy = static_cast<Event*>(::operator new(sizeof(Event) * count));
+                std::uninitialized_copy_n(static_cast<const Event*>(events), count, copy);
+                return copy;
+            },
+            [](void* events, const std::size_t count) -> void {
+                std::destroy_n(static_cast<Event*>(events), count);
+                ::operator delete(events);
+            },
+            sizeof(Event), keyFunction<Event>(), eventPriority<Event>()};
+        return ops;
+    }
+
+   private:
+    template <typename Event>
+    static constexpr auto keyFunction() -> EventKey (*)(const void*)
+    {
+        if constexpr (KeyedEvent<Event>)
+        {
+            return [](const void* event) -> EventKey {
+                return eventKey(*static_cast<const Event*>(event));
+            };
+        }
+        else
+        {
+            return nullptr;
+        }
+    }
+};
+
+}  // namespace Core
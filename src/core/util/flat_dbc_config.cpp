@@ -0,0 +1,395 @@
+#include "flat_dbc_config.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <iterator>
+#include <type_traits>
+
+namespace Core {
+
+namespace {
+
+/** @brief Attributes of the Vector DBC conventions that are resolved into the descriptions. */
+constexpr std::string_view cycleTimeAttribute = "GenMsgCycleTime";
+constexpr std::string_view sendTypeAttribute = "GenMsgSendType";
+constexpr std::string_view startValueAttribute = "GenSigStartValue";
+
+template <typename T>
+auto parseNumber(const std::string_view text) -> std::optional<T>
+{
+    T value{};
+    const auto [ptr, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc() || ptr != text.data() + text.size())
+    {
+        return std::nullopt;
+    }
+    return value;
+}
+
+/**
+ * @brief Enum values are stored as the index of their label, resolves them to the label.
+ */
+auto resolveEnum(const DbcAttributeDefinition& definition, const std::string& value) -> std::string
+{
+    if (definition.valueType != DbcAttributeValueType::Enum)
+    {
+        return value;
+    }
+    const auto index = parseNumber<std::size_t>(value);
+    if (!index || *index >= definition.enumValues.size())
+    {
+        return value;
+    }
+    return *std::next(definition.enumValues.begin(), static_cast<std::ptrdiff_t>(*index));
+}
+
+/**
+ * @brief Incremental 64 bit FNV-1a hash.
+ */
+class Fnv1a
+{
+   public:
+    void add(const std::string_view text)
+    {
+        add(static_cast<uint64_t>(text.size()));
+        for (const auto c : text)
+        {
+            addByte(static_cast<uint8_t>(c));
+        }
+    }
+
+    template <typename Value>
+        requires std::is_arithmetic_v<Value>
+    void add(const Value value)
+    {
+        // Hashes the value as integer bytes in little endian order, independent of the platform.
+        uint64_t bits = 0;
+        if constexpr (std::is_floating_point_v<Value>)
+        {
+            bits = std::bit_cast<uint64_t>(static_cast<double>(value));
+        }
+        else
+        {
+            bits = static_cast<uint64_t>(value);
+        }
+        for (std::size_t i = 0; i < sizeof(bits); ++i)
+        {
+            addByte(static_cast<uint8_t>(bits >> (8 * i)));
+        }
+    }
+
+    [[nodiscard]] auto value() const -> uint64_t
+    {
+        return m_hash;
+    }
+
+   private:
+    void addByte(const uint8_t byte)
+    {
+        m_hash = (m_hash ^ byte) * 0x100000001B3ULL;
+    }
+
+    uint64_t m_hash = 0xCBF29CE484222325ULL;
+};
+
+}  // namespace
+
+auto FlatDbcConfig::fromConfig(const DbcConfig& config) -> std::shared_ptr<const FlatDbcConfig>
+{
+    // The constructor is private, so make_shared is not available here.
+    std::shared_ptr<FlatDbcConfig> flat(new FlatDbcConfig());
+
+    std::size_t signalCount = 0;
+    std::size_t receiverCount = 0;
+    for (const auto& message : config.messageDefinitions)
+    {
+        signalCount += message.signalDescriptions.size();
+        for (const auto& signal : message.signalDescriptions)
+        {
+            receiverCount += signal.receivers.size();
+        }
+    }
+    std::size_t valueCount = 0;
+    for (const auto& valueDescription : config.signalValueDescriptions)
+    {
+        valueCount += valueDescription.signalDescriptions.size();
+    }
+
+    // Reserve everything up front: the indexes below store views into these vectors.
+    flat->m_messages.reserve(config.messageDefinitions.size());
+    flat->m_signals.reserve(signalCount);
+    flat->m_receivers.reserve(receiverCount);
+    flat->m_valueDescriptions.reserve(valueCount);
+    flat->m_nodeDefinitions.assign(config.nodeDefinitions.begin(), config.nodeDefinitions.end());
+    flat->m_comments.assign(config.comments.begin(), config.comments.end());
+
+    for (const auto& message : config.messageDefinitions)
+    {
+        const auto messageIndex = static_cast<uint32_t>(flat->m_messages.size());
+        auto& flatMessage = flat->m_messages.emplace_back();
+        flatMessage.messageId = message.messageId;
+        flatMessage.messageName = message.messageName;
+        flatMessage.messageSize = message.messageSize;
+        flatMessage.transmitterName = message.transmitterName;
+        flatMessage.signalRange = {static_cast<uint32_t>(flat->m_signals.size()),
+                                   static_cast<uint32_t>(message.signalDescriptions.size())};
+
+        for (const auto& signal : message.signalDescriptions)
+        {
+            auto& flatSignal = flat->m_signals.emplace_back();
+            flatSignal.signalName = signal.signalName;
+            flatSignal.multiplexer = signal.multiplexer;
+            flatSignal.multiplexedBy = signal.multiplexedBy;
+            flatSignal.startBit = signal.startBit;
+            flatSignal.signalSize = signal.signalSize;
+            flatSignal.byteOrder = signal.byteOrder;
+            flatSignal.valueType = signal.valueType;
+            flatSignal.factor = signal.factor;
+            flatSignal.offset = signal.offset;
+            flatSignal.minimum = signal.minimum;
+            flatSignal.maximum = signal.maximum;
+            flatSignal.unit = signal.unit;
+            flatSignal.messageIndex = messageIndex;
+            flatSignal.receivers = {static_cast<uint32_t>(flat->m_receivers.size()),
+                                    static_cast<uint32_t>(signal.receivers.size())};
+            flat->m_receivers.insert(flat->m_receivers.end(), signal.receivers.begin(),
+                                     signal.receivers.end());
+        }
+    }
+
+    for (uint32_t i = 0; i < flat->m_messages.size(); ++i)
+    {
+        const auto& message = flat->m_messages[i];
+        flat->m_messagesById.emplace(message.messageId, i);
+        flat->m_messagesByName.emplace(message.messageName, i);
+    }
+    for (uint32_t i = 0; i < flat->m_signals.size(); ++i)
+    {
+        const auto& signal = flat->m_signals[i];
+        flat->m_signalsByName.emplace(SignalKey{signal.messageIndex, signal.signalName}, i);
+    }
+
+    // VAL_ entries are stored separately in the DBC, attach them to their signals.
+    for (const auto& valueDescription : config.signalValueDescriptions)
+    {
+        const auto message = flat->m_messagesById.find(valueDescription.messageId);
+        if (message == flat->m_messagesById.end())
+        {
+            continue;
+        }
+        const auto signal =
+            flat->m_signalsByName.find(SignalKey{message->second, valueDescription.signalName});
+        if (signal == flat->m_signalsByName.end())
+        {
+            continue;
+        }
+        flat->m_signals[signal->second].valueDescriptions = {
+            static_cast<uint32_t>(flat->m_valueDescriptions.size()),
+            static_cast<uint32_t>(valueDescription.signalDescriptions.size())};
+        flat->m_valueDescriptions.insert(flat->m_valueDescriptions.end(),
+                                         valueDescription.signalDescriptions.begin(),
+                                         valueDescription.signalDescriptions.end());
+    }
+
+    for (auto& signal : flat->m_signals)
+    {
+        if (signal.valueDescriptions.count == 0)
+        {
+            continue;
+        }
+        signal.valueTable = static_cast<int32_t>(flat->m_valueTables.size());
+        flat->m_valueTables.emplace_back(flat->valueDescriptionsOf(signal));
+    }
+
+    flat->indexAttributes(config);
+    flat->m_contentHash = flat->computeContentHash();
+
+    return flat;
+}
+
+auto FlatDbcConfig::computeContentHash() const -> uint64_t
+{
+    Fnv1a hash;
+    for (const auto& message : m_messages)
+    {
+        hash.add(message.messageId);
+        hash.add(message.messageName);
+        hash.add(message.messageSize);
+        for (const auto& signal : signalsOf(message))
+        {
+            hash.add(signal.signalName);
+            hash.add(signal.multiplexer);
+            hash.add(signal.multiplexedBy);
+            hash.add(signal.startBit);
+            hash.add(signal.signalSize);
+            hash.add(signal.byteOrder);
+            hash.add(signal.valueType);
+            hash.add(signal.factor);
+            hash.add(signal.offset);
+            hash.add(signal.unit);
+            for (const auto& description : valueDescriptionsOf(signal))
+            {
+                hash.add(description.value);
+                hash.add(description.meaning);
+            }
+        }
+    }
+    return hash.value();
+}
+
+auto FlatDbcConfig::findMessage(const uint32_t messageId) const -> const FlatDbcMessage*
+{
+    const auto it = m_messagesById.find(messageId);
+    return it != m_messagesById.end() ? &m_messages[it->second] : nullptr;
+}
+
+auto FlatDbcConfig::findMessage(const std::string_view messageName) const -> const FlatDbcMessage*
+{
+    const auto it = m_messagesByName.find(messageName);
+    return it != m_messagesByName.end() ? &m_messages[it->second] : nullptr;
+}
+
+auto FlatDbcConfig::findSignal(const uint32_t messageId,
+                               const std::string_view signalName) const -> const FlatDbcSignal*
+{
+    const auto message = m_messagesById.find(messageId);
+    if (message == m_messagesById.end())
+    {
+        return nullptr;
+    }
+    const auto it = m_signalsByName.find(SignalKey{message->second, signalName});
+    return it != m_signalsByName.end() ? &m_signals[it->second] : nullptr;
+}
+
+auto FlatDbcConfig::findAttributeDefinition(const std::string_view attributeName) const
+    -> const DbcAttributeDefinition*
+{
+    const auto it = m_attributesByName.find(attributeName);
+    return it != m_attributesByName.end() ? &m_attributeDefinitions[it->second] : nullptr;
+}
+
+auto FlatDbcConfig::networkAttribute(const std::string_view attributeName) const
+    -> std::string_view
+{
+    return attribute(DbcAttributeObjectType::Network, 0, attributeName);
+}
+
+auto FlatDbcConfig::messageAttribute(const FlatDbcMessage& message,
+                                     const std::string_view attributeName) const
+    -> std::string_view
+{
+    const auto index = static_cast<uint32_t>(&message - m_messages.data());
+    return attribute(DbcAttributeObjectType::Message, index, attributeName);
+}
+
+auto FlatDbcConfig::signalAttribute(const FlatDbcSignal& signal,
+                                    const std::string_view attributeName) const -> std::string_view
+{
+    const auto index = static_cast<uint32_t>(&signal - m_signals.data());
+    return attribute(DbcAttributeObjectType::Signal, index, attributeName);
+}
+
+auto FlatDbcConfig::attribute(const DbcAttributeObjectType objectType, const uint32_t objectIndex,
+                              const std::string_view attributeName) const -> std::string_view
+{
+    const auto definition = m_attributesByName.find(attributeName);
+    if (definition == m_attributesByName.end())
+    {
+        return {};
+    }
+    const auto value =
+        m_attributeValuesByKey.find(attributeKey(objectType, definition->second, objectIndex));
+    if (value != m_attributeValuesByKey.end())
+    {
+        return m_attributeValues[value->second];
+    }
+    return m_attributeDefinitions[definition->second].defaultValue;
+}
+
+void FlatDbcConfig::indexAttributes(const DbcConfig& config)
+{
+    m_attributeDefinitions.assign(config.attributeDefinitions.begin(),
+                                  config.attributeDefinitions.end());
+    for (uint32_t i = 0; i < m_attributeDefinitions.size(); ++i)
+    {
+        auto& definition = m_attributeDefinitions[i];
+        definition.defaultValue = resolveEnum(definition, definition.defaultValue);
+        m_attributesByName.emplace(definition.attributeName, i);
+    }
+
+    m_attributeValues.reserve(config.attributeValues.size());
+    for (const auto& value : config.attributeValues)
+    {
+        const auto definition = m_attributesByName.find(value.attributeName);
+        if (definition == m_attributesByName.end())
+        {
+            continue;
+        }
+
+        std::optional<uint32_t> objectIndex;
+        switch (value.objectType)
+        {
+            case DbcAttributeObjectType::Network:
+                objectIndex = 0;
+                break;
+            case DbcAttributeObjectType::Node:
+                if (const auto node = std::find(m_nodeDefinitions.begin(), m_nodeDefinitions.end(),
+                                                value.objectName);
+                    node != m_nodeDefinitions.end())
+                {
+                    objectIndex = static_cast<uint32_t>(node - m_nodeDefinitions.begin());
+                }
+                break;
+            case DbcAttributeObjectType::Message:
+                if (const auto message = m_messagesById.find(value.messageId);
+                    message != m_messagesById.end())
+                {
+                    objectIndex = message->second;
+                }
+                break;
+            case DbcAttributeObjectType::Signal:
+                if (const auto* signal = findSignal(value.messageId, value.signalName))
+                {
+                    objectIndex = static_cast<uint32_t>(signal - m_signals.data());
+                }
+                break;
+            case DbcAttributeObjectType::EnvironmentVariable:
+                // Environment variables are not part of the flat representation.
+                break;
+        }
+        if (!objectIndex)
+        {
+            continue;
+        }
+
+        const auto key = attributeKey(value.objectType, definition->second, *objectIndex);
+        auto resolved = resolveEnum(m_attributeDefinitions[definition->second], value.value);
+        // A later BA_ for the same object overrides an earlier one.
+        if (const auto existing = m_attributeValuesByKey.find(key);
+            existing != m_attributeValuesByKey.end())
+        {
+            m_attributeValues[existing->second] = std::move(resolved);
+            continue;
+        }
+        m_attributeValuesByKey.emplace(key, static_cast<uint32_t>(m_attributeValues.size()));
+        m_attributeValues.push_back(std::move(resolved));
+    }
+
+    for (auto& message : m_messages)
+    {
+        message.cycleTimeMs =
+            parseNumber<uint32_t>(messageAttribute(message, cycleTimeAttribute)).value_or(0);
+        message.sendType = messageAttribute(message, sendTypeAttribute);
+    }
+    for (auto& signal : m_signals)
+    {
+        // The start value is stored raw, the descriptions carry physical values.
+        if (const auto raw = parseNumber<double>(signalAttribute(signal, startValueAttribute)))
+        {
+            signal.startValue = *raw * signal.factor + signal.offset;
+        }
+    }
+}
+
+}  // namespace Core
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "core/dto/dbc_dto.hpp"
+#include "dbc_value_table.hpp"
+
+namespace Core {
+
+/**
+ * @brief A contiguous range of elements inside one of the flat arrays of a FlatDbcConfig.
+ */
+struct IndexRange {
+    uint32_t begin = 0;
+    uint32_t count = 0;
+};
+
+/**
+ * @brief Flat counterpart of @ref DbcSignalDescription.
+ * @details Receivers and value descriptions are not owned by the signal, they are ranges into the
+ * shared arrays of the owning FlatDbcConfig.
+ */
+struct FlatDbcSignal {
+    std::string signalName;
+    bool multiplexer = false;
+    std::string multiplexedBy;
+    uint32_t startBit = 0;
+    uint32_t signalSize = 0;
+    bool byteOrder = false;
+    bool valueType = false;
+    double factor = 1.0;
+    double offset = 0.0;
+    double minimum = 0.0;
+    double maximum = 0.0;
+    std::string unit;
+    /** @brief Index of the owning message in FlatDbcConfig::messages(). */
+    uint32_t messageIndex = 0;
+    /** @brief Range inside FlatDbcConfig::receivers(). */
+    IndexRange receivers;
+    /** @brief Range inside FlatDbcConfig::valueDescriptions(). */
+    IndexRange valueDescriptions;
+    /** @brief Index of the compiled value table, -1 if the signal has no value descriptions. */
+    int32_t valueTable = -1;
+    /** @brief Physical start value from the GenSigStartValue attribute, if defined. */
+    std::optional<double> startValue;
+};
+
+/**
+ * @brief Flat counterpart of @ref DbcMessageDescription.
+ */
+struct FlatDbcMessage {
+    uint32_t messageId = 0;
+    std::string messageName;
+    uint32_t messageSize = 0;
+    std::string transmitterName;
+    /** @brief Range inside FlatDbcConfig::signalDescriptions(). */
+    IndexRange signalRange;
+    /** @brief Cycle time from the GenMsgCycleTime attribute, 0 if the message is not cyclic. */
+    uint32_t cycleTimeMs = 0;
+    /** @brief Send type from the GenMsgSendType attribute (e.g. "Cyclic"), empty if undefined. */
+    std::string sendType;
+};
+
+/**
+ * @brief Immutable, contiguous representation of a parsed DBC file.
+ *
+ * @details
+ * The list based @ref DbcConfig is what the parser produces. It is converted once into this
+ * representation: all messages and all signals are stored in one vector each, and hash indexes
+ * allow lookups of messages by ID or name and of signals by name without a linear scan.
+ *
+ * Instances are only handed out as @ref DbcConfigPtr (`std::shared_ptr<const FlatDbcConfig>`), so
+ * all modules share the same data instead of copying it. Because the indexes refer to the stored
+ * strings, the object can neither be copied nor moved.
+ */
+class FlatDbcConfig
+{
+   public:
+    /**
+     * @brief Converts a parsed DBC configuration into its flat representation.
+     * @param config The configuration as produced by the DBC parser.
+     * @return The shared, immutable flat configuration.
+     */
+    static auto fromConfig(const DbcConfig& config) -> std::shared_ptr<const FlatDbcConfig>;
+
+    FlatDbcConfig(const FlatDbcConfig&) = delete;
+    auto operator=(const FlatDbcConfig&) -> FlatDbcConfig& = delete;
+    FlatDbcConfig(FlatDbcConfig&&) = delete;
+    auto operator=(FlatDbcConfig&&) -> FlatDbcConfig& = delete;
+    ~FlatDbcConfig() = default;
+
+    /** @brief All messages, in the order of the DBC file. */
+    [[nodiscard]] auto messages() const -> std::span<const FlatDbcMessage>
+    {
+        return m_messages;
+    }
+
+    /** @brief All signals of all messages, grouped by message. */
+    [[nodiscard]] auto signalDescriptions() const -> std::span<const FlatDbcSignal>
+    {
+        return m_signals;
+    }
+
+    /** @brief The signals of one message. */
+    [[nodiscard]] auto signalsOf(const FlatDbcMessage& message) const
+        -> std::span<const FlatDbcSignal>
+    {
+        return slice(std::span<const FlatDbcSignal>(m_signals), message.signalRange);
+    }
+
+    /** @brief The receiving nodes of one signal. */
+    [[nodiscard]] auto receiversOf(const FlatDbcSignal& signal) const
+        -> std::span<const std::string>
+    {
+        return slice(std::span<const std::string>(m_receivers), signal.receivers);
+    }
+
+    /** @brief The value descriptions (VAL_) of one signal. */
+    [[nodiscard]] auto valueDescriptionsOf(const FlatDbcSignal& signal) const
+        -> std::span<const DbcValueDescription>
+    {
+        return slice(std::span<const DbcValueDescription>(m_valueDescriptions),
+                     signal.valueDescriptions);
+    }
+
+    /**
+     * @brief The compiled value table of one signal.
+     * @return The table or nullptr if the signal has no value descriptions.
+     */
+    [[nodiscard]] auto valueTableOf(const FlatDbcSignal& signal) const -> const DbcValueTable*
+    {
+        return signal.valueTable >= 0 ? &m_valueTables[signal.valueTable] : nullptr;
+    }
+
+    /**
+     * @brief Resolves a decoded value of a signal to its value description (enum text).
+     * @details Used for decoded output and exports, does not allocate.
+     * @param signal The signal the value belongs to.
+     * @param physicalValue The decoded physical value.
+     * @return The description or an empty view if there is none.
+     */
+    [[nodiscard]] auto describeValue(const FlatDbcSignal& signal,
+                                     double physicalValue) const -> std::string_view
+    {
+        const auto* table = valueTableOf(signal);
+        return table ? table->lookupPhysical(physicalValue, signal.factor, signal.offset)
+                     : std::string_view();
+    }
+
+    /**
+     * @brief Returns a hash of everything that decoding depends on: the messages, the layout and
+     * scaling of their signals and the value descriptions.
+     * @details Stable across runs and platforms, so it can be stored, e.g. in session files, to
+     * recognize the DBC data was decoded with.
+     */
+    [[nodiscard]] auto contentHash() const -> uint64_t
+    {
+        return m_contentHash;
+    }
+
+    /** @brief The message owning a signal. */
+    [[nodiscard]] auto messageOf(const FlatDbcSignal& signal) const -> const FlatDbcMessage&
+    {
+        return m_messages[signal.messageIndex];
+    }
+
+    [[nodiscard]] auto nodeDefinitions() const -> std::span<const std::string>
+    {
+        return m_nodeDefinitions;
+    }
+
+    [[nodiscard]] auto comments() const -> std::span<const std::string>
+    {
+        return m_comments;
+    }
+
+    /** @brief All attribute definitions (BA_DEF_), including their defaults. */
+    [[nodiscard]] auto attributeDefinitions() const -> std::span<const DbcAttributeDefinition>
+    {
+        return m_attributeDefinitions;
+    }
+
+    /**
+     * @brief Looks up an attribute definition by its name.
+     * @return The definition or nullptr if the attribute is not defined.
+     */
+    [[nodiscard]] auto findAttributeDefinition(std::string_view attributeName) const
+        -> const DbcAttributeDefinition*;
+
+    /**
+     * @brief Returns the value of a network attribute.
+     * @return The assigned value, otherwise the default value, otherwise an empty view. Enum
+     * values are resolved to their label.
+     */
+    [[nodiscard]] auto networkAttribute(std::string_view attributeName) const -> std::string_view;
+
+    /** @brief Returns the value of a message attribute, see networkAttribute(). */
+    [[nodiscard]] auto messageAttribute(const FlatDbcMessage& message,
+                                        std::string_view attributeName) const -> std::string_view;
+
+    /** @brief Returns the value of a signal attribute, see networkAttribute(). */
+    [[nodiscard]] auto signalAttribute(const FlatDbcSignal& signal,
+                                       std::string_view attributeName) const -> std::string_view;
+
+    /**
+     * @brief Looks up a message by its CAN ID.
+     * @return The message or nullptr if the ID is not part of the DBC.
+     */
+    [[nodiscard]] auto findMessage(uint32_t messageId) const -> const FlatDbcMessage*;
+
+    /**
+     * @brief Looks up a message by its name.
+     * @return The message or nullptr if no message has that name.
+     */
+    [[nodiscard]] auto findMessage(std::string_view messageName) const -> const FlatDbcMessage*;
+
+    /**
+     * @brief Looks up a signal by the CAN ID of its message and its name.
+     * @return The signal or nullptr if it does not exist.
+     */
+    [[nodiscard]] auto findSignal(uint32_t messageId,
+                                  std::string_view signalName) const -> const FlatDbcSignal*;
+
+   private:
+    FlatDbcConfig() = default;
+
+    /**
+     * @brief Indexes the attribute definitions and values and resolves the well known
+     * attributes (cycle time, send type, start value) into the message and signal descriptions.
+     */
+    void indexAttributes(const DbcConfig& config);
+
+    /** @brief Computes contentHash() from the flat arrays, FNV-1a over their fields. */
+    [[nodiscard]] auto computeContentHash() const -> uint64_t;
+
+    /** @brief Key of m_attributeValues. */
+    static auto attributeKey(DbcAttributeObjectType objectType, uint32_t attributeIndex,
+                             uint32_t objectIndex) -> uint64_t
+    {
+        return (static_cast<uint64_t>(objectType) << 56) |
+               (static_cast<uint64_t>(attributeIndex) << 32) | objectIndex;
+    }
+
+    [[nodiscard]] auto attribute(DbcAttributeObjectType objectType, uint32_t objectIndex,
+                                 std::string_view attributeName) const -> std::string_view;
+
+    template <typename T>
+    static auto slice(std::span<const T> all, IndexRange range) -> std::span<const T>
+    {
+        return all.subspan(range.begin, range.count);
+    }
+
+    /**
+     * @brief Key of the signal index: signal names are only unique within their message.
+     */
+    struct SignalKey {
+        uint32_t messageIndex;
+        std::string_view signalName;
+
+        auto operator==(const SignalKey&) const -> bool = default;
+    };
+
+    struct SignalKeyHash {
+        auto operator()(const SignalKey& key) const noexcept -> std::size_t
+        {
+            return std::hash<std::string_view>{}(key.signalName) ^
+                   (static_cast<std::size_t>(key.messageIndex) * 0x9E3779B97F4A7C15ULL);
+        }
+    };
+
+    std::vector<FlatDbcMessage> m_messages;
+    std::vector<FlatDbcSignal> m_signals;
+    std::vector<std::string> m_receivers;
+    std::vector<DbcValueDescription> m_valueDescriptions;
+    /** @brief Compiled value tables, referring to the strings in m_valueDescriptions. */
+    std::vector<DbcValueTable> m_valueTables;
+    std::vector<std::string> m_nodeDefinitions;
+    std::vector<std::string> m_comments;
+
+    std::vector<DbcAttributeDefinition> m_attributeDefinitions;
+    /** @brief Assigned attribute values with enum indices resolved to their labels. */
+    std::vector<std::string> m_attributeValues;
+
+    /** @brief CAN ID -> index in m_messages. */
+    std::unordered_map<uint32_t, uint32_t> m_messagesById;
+    /** @brief Message name -> index in m_messages. Views into m_messages. */
+    std::unordered_map<std::string_view, uint32_t> m_messagesByName;
+    /** @brief (message, signal name) -> index in m_signals. Views into m_signals. */
+    std::unordered_map<SignalKey, uint32_t, SignalKeyHash> m_signalsByName;
+    /** @brief Attribute name -> index in m_attributeDefinitions. */
+    std::unordered_map<std::string_view, uint32_t> m_attributesByName;
+    /** @brief attributeKey() -> index in m_attributeValues. */
+    std::unordered_map<uint64_t, uint32_t> m_attributeValuesByKey;
+
+    uint64_t m_contentHash = 0;
+};
+
+/**
+ * @brief Shared handle to an immutable DBC configuration, passed between modules.
+ */
+using DbcConfigPtr = std::shared_ptr<const FlatDbcConfig>;
+
+}  // namespace Core
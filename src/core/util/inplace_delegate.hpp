@@ -0,0 +1,160 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Core {
+
+/**
+ * @brief Default inline storage of an InplaceDelegate, enough for a lambda capturing a few
+ * pointers or a std::function.
+ */
+inline constexpr std::size_t defaultDelegateCapacity = 48;
+
+template <typename Signature, std::size_t Capacity = defaultDelegateCapacity>
+class InplaceDelegate;
+
+/**
+ * @brief A move-only callable wrapper that stores its target inline and never allocates.
+ *
+ * @details
+ * Unlike std::function the target is always kept in the object itself; a callable that does not
+ * fit into @p Capacity bytes is rejected at compile time instead of being moved to the heap.
+ * Calling the delegate is a single indirect call to a function that invokes the concrete
+ * callable, so small lambdas are inlined into it.
+ *
+ * @tparam R The return type.
+ * @tparam Args The argument types.
+ * @tparam Capacity Size of the inline storage in bytes.
+ */
+template <typename R, typename... Args, std::size_t Capacity>
+class InplaceDelegate<R(Args...), Capacity>
+{
+   public:
+    InplaceDelegate() = default;
+    InplaceDelegate(std::nullptr_t) noexcept {}  // NOLINT(google-explicit-constructor)
+
+    /**
+     * @brief Stores a callable, e.g. a lambda.
+     * @details Implicit like std::function, so lambdas can be passed where a delegate is expected.
+     */
+    template <typename Callable>
+        requires(!std::same_as<std::remove_cvref_t<Callable>, InplaceDelegate> &&
+                 std::is_invocable_r_v<R, std::remove_cvref_t<Callable>&, Args...>)
+    InplaceDelegate(Callable&& callable)  // NOLINT(google-explicit-constructor)
+    {
+        using Stored = std::remove_cvref_t<Callable>;
+        static_assert(sizeof(Stored) <= Capacity,
+                      "Callable does not fit into the inline storage of the delegate");
+        static_assert(alignof(Stored) <= alignof(std::max_align_t),
+                      "Callable is over-aligned for the inline storage of the delegate");
+        static_assert(std::is_nothrow_move_constructible_v<Stored>,
+                      "Callable must be nothrow move constructible");
+
+        ::new (static_cast<void*>(m_storage)) Stored(std::forward<Callable>(callable));
+        m_invoke = [](void* storage, Args... args) -> R {
+            return std::invoke(*static_cast<Stored*>(storage), std::forward<Args>(args)...);
+        };
+        m_manage = &manage<Stored>;
+    }
+
+    /**
+     * @brief Binds a member function to an instance.
+     * @tparam Method The member function, e.g. &Model::onFrame.
+     * @param instance The object to call the member function on, must outlive the delegate.
+     */
+    template <auto Method, typename T>
+    static auto bind(T* instance) -> InplaceDelegate
+    {
+        return InplaceDelegate([instance](Args... args) -> R {
+            return std::invoke(Method, instance, std::forward<Args>(args)...);
+        });
+    }
+
+    InplaceDelegate(const InplaceDelegate&) = delete;
+    auto operator=(const InplaceDelegate&) -> InplaceDelegate& = delete;
+
+    InplaceDelegate(InplaceDelegate&& other) noexcept
+    {
+        moveFrom(other);
+    }
+
+    auto operator=(InplaceDelegate&& other) noexcept -> InplaceDelegate&
+    {
+        if (this != &other)
+        {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    auto operator=(std::nullptr_t) noexcept -> InplaceDelegate&
+    {
+        reset();
+        return *this;
+    }
+
+    ~InplaceDelegate()
+    {
+        reset();
+    }
+
+    /**
+     * @brief Invokes the stored callable. Must not be called on an empty delegate.
+     */
+    auto operator()(Args... args) const -> R
+    {
+        return m_invoke(m_storage, std::forward<Args>(args)...);
+    }
+
+    /** @brief Checks if a callable is stored. */
+    explicit operator bool() const noexcept
+    {
+        return m_invoke != nullptr;
+    }
+
+   private:
+    enum class Operation { Move, Destroy };
+
+    template <typename Stored>
+    static void manage(const Operation operation, void* storage, void* target) noexcept
+    {
+        auto* stored = static_cast<Stored*>(storage);
+        if (operation == Operation::Move)
+        {
+            ::new (target) Stored(std::move(*stored));
+        }
+        stored->~Stored();
+    }
+
+    void moveFrom(InplaceDelegate& other) noexcept
+    {
+        if (other.m_manage)
+        {
+            other.m_manage(Operation::Move, other.m_storage, m_storage);
+        }
+        m_invoke = std::exchange(other.m_invoke, nullptr);
+        m_manage = std::exchange(other.m_manage, nullptr);
+    }
+
+    void reset() noexcept
+    {
+        if (m_manage)
+        {
+            m_manage(Operation::Destroy, m_storage, nullptr);
+        }
+        m_invoke = nullptr;
+        m_manage = nullptr;
+    }
+
+    alignas(std::max_align_t) mutable std::byte m_storage[Capacity];
+    R (*m_invoke)(void*, Args...) = nullptr;
+    void (*m_manage)(Operation, void*, void*) noexcept = nullptr;
+};
+
+}  // namespace Core
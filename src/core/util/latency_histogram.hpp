@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace Core {
+
+/**
+ * @brief Lock-free histogram of latencies with logarithmic buckets.
+ *
+ * @details
+ * Every power of two is split into eight buckets, so a reported percentile is at most 12.5% above
+ * the true value while the whole range up to centuries fits into a few kilobytes. Recording is a
+ * few relaxed atomic increments and safe from any thread.
+ */
+class LatencyHistogram
+{
+   public:
+    /**
+     * @brief Adds one measurement.
+     * @param latency The measured latency, negative values count as zero.
+     */
+    void record(const std::chrono::nanoseconds latency) noexcept
+    {
+        const auto value = latency.count() > 0 ? static_cast<uint64_t>(latency.count()) : 0;
+        m_buckets[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+
+        auto max = m_max.load(std::memory_order_relaxed);
+        while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /** @brief Returns the number of measurements. */
+    [[nodiscard]] auto count() const noexcept -> uint64_t
+    {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Returns the largest measurement. */
+    [[nodiscard]] auto max() const noexcept -> std::chrono::nanoseconds
+    {
+        return std::chrono::nanoseconds(m_max.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief Returns the latency below which the given fraction of the measurements lie.
+     * @param fraction E.g. 0.99 for the 99th percentile.
+     * @return The upper bound of the bucket holding the percentile, zero without measurements.
+     */
+    [[nodiscard]] auto percentile(const double fraction) const noexcept -> std::chrono::nanoseconds
+    {
+        const auto total = count();
+        if (total == 0)
+        {
+            return std::chrono::nanoseconds::zero();
+        }
+        const auto rank = static_cast<uint64_t>(fraction * static_cast<double>(total - 1)) + 1;
+        uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket < bucketCount; ++bucket)
+        {
+            seen += m_buckets[bucket].load(std::memory_order_relaxed);
+            if (seen >= rank)
+            {
+                return std::min(std::chrono::nanoseconds(upperBound(bucket)), max());
+            }
+        }
+        return max();
+    }
+
+   private:
+    static constexpr unsigned subBucketBits = 3;
+    static constexpr uint64_t subBuckets = uint64_t{1} << subBucketBits;
+    /** @brief Small values have a bucket each, every higher power of two has subBuckets. */
+    static constexpr std::size_t bucketCount = (64 - subBucketBits + 1) * subBuckets;
+
+    static constexpr auto bucketOf(const uint64_t value) -> std::size_t
+    {
+        if (value < subBuckets)
+        {
+            return value;
+        }
+        const auto exponent = static_cast<unsigned>(std::bit_width(value)) - 1;
+        const auto shift = exponent - subBucketBits;
+        const auto mantissa = (value >> shift) & (subBuckets - 1);
+        return (shift + 1) * subBuckets + mantissa;
+    }
+
+    static constexpr auto upperBound(const std::size_t bucket) -> uint64_t
+    {
+        if (bucket < subBuckets)
+        {
+            return bucket;
+        }
+        const auto shift = bucket / subBuckets - 1;
+        const auto lower = (subBuckets + bucket % subBuckets) << shift;
+        return lower + ((uint64_t{1} << shift) - 1);
+    }
+
+    std::array<std::atomic<uint64_t>, bucketCount> m_buckets{};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_max{0};
+};
+
+}  // namespace Core
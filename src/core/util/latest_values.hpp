@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "core/event/event.hpp"
+
+namespace Core {
+
+/**
+ * @brief Keeps the newest event per routing key until it is taken, e.g. the latest frame of every
+ * CAN ID on every interface.
+ *
+ * @details
+ * Used by conflating subscriptions: publishers overwrite the pending value of a key as often as
+ * events arrive, the consumer takes the changed keys at its own pace. Memory stays bounded by the
+ * number of distinct keys, no matter how far the consumer lags behind.
+ *
+ * @tparam Event A KeyedEvent type.
+ */
+template <KeyedEvent Event>
+class LatestValues
+{
+   public:
+    /**
+     * @brief Stores events, replacing the pending value of their keys. Safe from any thread.
+     * @param events The events in publish order, later events win.
+     */
+    void store(std::span<const Event> events)
+    {
+        std::lock_guard lock(m_mutex);
+        for (const auto& event : events)
+        {
+            const auto [it, inserted] =
+                m_slots.try_emplace(packKey(eventKey(event)), m_pending.size());
+            if (inserted)
+            {
+                m_pending.push_back(event);
+            }
+            else
+            {
+                m_pending[it->second] = event;
+            }
+        }
+    }
+
+    /**
+     * @brief Moves the pending values into @p out, one per changed key in order of first change.
+     * @param out Receives the values, its previous content is discarded. Passing the same vector
+     * on every call reuses its capacity.
+     */
+    void take(std::vector<Event>& out)
+    {
+        out.clear();
+        std::lock_guard lock(m_mutex);
+        out.swap(m_pending);
+        m_slots.clear();
+    }
+
+   private:
+    static auto packKey(const EventKey& key) -> uint64_t
+    {
+        return (uint64_t{key.interfaceId} << 32) | key.id;
+    }
+
+    std::mutex m_mutex;
+    /** @brief Key -> index into m_pending. */
+    std::unordered_map<uint64_t, std::size_t> m_slots;
+    std::vector<Event> m_pending;
+};
+
+}  // namespace Core
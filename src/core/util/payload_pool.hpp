@@ -0,0 +1,321 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace Core {
+
+template <typename T>
+class PayloadPool;
+
+/**
+ * @brief Shared, reference counted handle to a payload of a PayloadPool.
+ *
+ * @details
+ * Copying a handle only increments the counter stored next to the payload, so an event carrying
+ * a handle can be retained, queued for other threads and forwarded without copying the payload.
+ * When the last handle goes away the payload returns to its pool. Handles may outlive the pool.
+ *
+ * Payloads are shared between all holders and must not be changed once the handle was copied,
+ * e.g. after publishing it.
+ *
+ * @tparam T The payload type.
+ */
+template <typename T>
+class PayloadRef
+{
+   public:
+    PayloadRef() = default;
+
+    PayloadRef(const PayloadRef& other) noexcept : m_block(other.m_block)
+    {
+        if (m_block)
+        {
+            m_block->references.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    PayloadRef(PayloadRef&& other) noexcept : m_block(std::exchange(other.m_block, nullptr)) {}
+
+    auto operator=(PayloadRef other) noexcept -> PayloadRef&
+    {
+        std::swap(m_block, other.m_block);
+        return *this;
+    }
+
+    ~PayloadRef()
+    {
+        if (m_block && m_block->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            PayloadPool<T>::recycle(m_block);
+        }
+    }
+
+    auto operator*() const -> const T&
+    {
+        return m_block->value;
+    }
+
+    auto operator->() const -> const T*
+    {
+        return &m_block->value;
+    }
+
+    /**
+     * @brief Gives write access to the payload, only allowed while this is the only handle.
+     */
+    auto edit() -> T&
+    {
+        return m_block->value;
+    }
+
+    /** @brief Checks if the handle refers to a payload. */
+    explicit operator bool() const noexcept
+    {
+        return m_block != nullptr;
+    }
+
+    /** @brief Returns the number of handles to the payload, a snapshot if shared across threads. */
+    [[nodiscard]] auto useCount() const noexcept -> uint32_t
+    {
+        return m_block ? m_block->references.load(std::memory_order_relaxed) : 0;
+    }
+
+   private:
+    friend class PayloadPool<T>;
+
+    explicit PayloadRef(typename PayloadPool<T>::Block* block) noexcept : m_block(block) {}
+
+    typename PayloadPool<T>::Block* m_block = nullptr;
+};
+
+/**
+ * @brief Slab allocator for payloads shared through PayloadRef, e.g. decoded CAN frames.
+ *
+ * @details
+ * Payloads live in slabs that are allocated on demand, the first one of @p slabSize blocks and
+ * every further one twice as large as the previous one. Slabs are only released with the pool, so
+ * once the pool has grown to the number of payloads in flight no further heap allocation happens.
+ * Recycled payloads are not destroyed: acquire() returns them with their previous content, and
+ * containers inside them keep their capacity when overwritten.
+ *
+ * The free blocks form a lock-free stack, so the producer acquiring payloads never waits for the
+ * threads that drop the last handles; only growing takes a lock.
+ *
+ * @tparam T The payload type, must be default constructible.
+ */
+template <typename T>
+class PayloadPool
+{
+   public:
+    static constexpr std::size_t defaultSlabSize = 256;
+
+    explicit PayloadPool(const std::size_t slabSize = defaultSlabSize)
+        : m_arena(new Arena(slabSize == 0 ? 1 : slabSize))
+    {
+    }
+
+    PayloadPool(const PayloadPool&) = delete;
+    auto operator=(const PayloadPool&) -> PayloadPool& = delete;
+
+    /** @brief Handles still in use keep the slabs alive until they are released. */
+    ~PayloadPool()
+    {
+        Arena::release(m_arena);
+    }
+
+    /**
+     * @brief Takes a payload from the pool.
+     * @return The only handle to the payload. It may hold the content of an earlier payload, so
+     * every field must be assigned before it is shared.
+     * @throws std::length_error If the pool would exceed 2^32 - 2 payloads.
+     */
+    auto acquire() -> PayloadRef<T>
+    {
+        auto* block = m_arena->pop();
+        block->references.store(1, std::memory_order_relaxed);
+        return PayloadRef<T>(block);
+    }
+
+    /** @brief Returns the number of payloads allocated so far. */
+    [[nodiscard]] auto capacity() const -> std::size_t
+    {
+        return Arena::firstIndexOf(m_arena->slabSize,
+                                   m_arena->slabCount.load(std::memory_order_acquire));
+    }
+
+    /** @brief Returns the number of payloads that are not in use, a snapshot across threads. */
+    [[nodiscard]] auto available() const -> std::size_t
+    {
+        return m_arena->available.load(std::memory_order_relaxed);
+    }
+
+   private:
+    friend class PayloadRef<T>;
+
+    struct Arena;
+
+    struct Block {
+        T value;
+        std::atomic<uint32_t> references{0};
+        /** @brief The index + 1 of the next free block while the block is free, 0 for none. */
+        std::atomic<uint32_t> next{0};
+        Arena* arena = nullptr;
+        /** @brief The position of the block over all slabs. */
+        uint32_t index = 0;
+    };
+
+    /**
+     * @brief The slabs and the free list, shared by the pool and its blocks in use.
+     * @details The head of the free list packs the index + 1 of the first free block into the
+     * lower half and a tag into the upper half, which every update increments. A block that was
+     * taken and returned between the load and the exchange of another thread thus fails that
+     * exchange instead of linking a stale successor (the ABA problem).
+     */
+    struct Arena {
+        static constexpr std::size_t maxSlabs = 32;
+
+        explicit Arena(const std::size_t size) : slabSize(size) {}
+
+        Arena(const Arena&) = delete;
+        auto operator=(const Arena&) -> Arena& = delete;
+
+        ~Arena()
+        {
+            for (auto& slab : slabs)
+            {
+                delete[] slab.load(std::memory_order_relaxed);
+            }
+        }
+
+        auto pop() -> Block*
+        {
+            auto head = free.load(std::memory_order_acquire);
+            for (;;)
+            {
+                const auto first = static_cast<uint32_t>(head);
+                if (first == 0)
+                {
+                    grow();
+                    head = free.load(std::memory_order_acquire);
+                    continue;
+                }
+                auto* block = at(first - 1);
+                const auto next = block->next.load(std::memory_order_relaxed);
+                if (free.compare_exchange_weak(head, pack(head, next), std::memory_order_acquire,
+                                               std::memory_order_acquire))
+                {
+                    available.fetch_sub(1, std::memory_order_relaxed);
+                    users.fetch_add(1, std::memory_order_relaxed);
+                    return block;
+                }
+            }
+        }
+
+        void push(Block* block)
+        {
+            prepend(*block, *block);
+            available.fetch_add(1, std::memory_order_relaxed);
+            release(this);
+        }
+
+        /** @brief Links the free blocks first to last, already chained, in front of the list. */
+        void prepend(Block& first, Block& last)
+        {
+            auto head = free.load(std::memory_order_relaxed);
+            do
+            {
+                last.next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            } while (!free.compare_exchange_weak(head, pack(head, first.index + 1),
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed));
+        }
+
+        void grow()
+        {
+            std::lock_guard lock(growMutex);
+            // Another thread may have grown the pool or returned blocks meanwhile.
+            if (static_cast<uint32_t>(free.load(std::memory_order_acquire)) != 0)
+            {
+                return;
+            }
+            const auto slab = slabCount.load(std::memory_order_relaxed);
+            const auto first = firstIndexOf(slabSize, slab);
+            const auto size = firstIndexOf(slabSize, slab + 1) - first;
+            if (slab == maxSlabs || first + size >= std::numeric_limits<uint32_t>::max())
+            {
+                throw std::length_error("Payload pool exceeds its maximum size");
+            }
+
+            auto* blocks = new Block[size];
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                blocks[i].arena = this;
+                blocks[i].index = static_cast<uint32_t>(first + i);
+                blocks[i].next.store(i + 1 < size ? static_cast<uint32_t>(first + i + 2) : 0,
+                                     std::memory_order_relaxed);
+            }
+            slabs[slab].store(blocks, std::memory_order_release);
+            slabCount.store(slab + 1, std::memory_order_release);
+            available.fetch_add(size, std::memory_order_relaxed);
+            prepend(blocks[0], blocks[size - 1]);
+        }
+
+        /** @brief Returns the block at an index, its slab must be allocated. */
+        [[nodiscard]] auto at(const uint32_t index) const -> Block*
+        {
+            const auto slab = static_cast<std::size_t>(std::bit_width(index / slabSize + 1) - 1);
+            return slabs[slab].load(std::memory_order_acquire) +
+                   (index - firstIndexOf(slabSize, slab));
+        }
+
+        /** @brief Returns the index of the first block of a slab, the blocks of all before it. */
+        static constexpr auto firstIndexOf(const std::size_t slabSize, const std::size_t slab)
+            -> std::size_t
+        {
+            return slabSize * ((std::size_t{1} << slab) - 1);
+        }
+
+        /** @brief Returns a new head with the tag of @p head incremented. */
+        static constexpr auto pack(const uint64_t head, const uint32_t first) -> uint64_t
+        {
+            return ((head >> 32) + 1) << 32 | first;
+        }
+
+        /** @brief Drops one user, the last one deletes the arena. */
+        static void release(Arena* arena)
+        {
+            if (arena->users.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                delete arena;
+            }
+        }
+
+        const std::size_t slabSize;
+        std::array<std::atomic<Block*>, maxSlabs> slabs{};
+        std::atomic<std::size_t> slabCount{0};
+        /** @brief Serializes grow(). */
+        std::mutex growMutex;
+        /** @brief The head of the free list, see Arena. */
+        std::atomic<uint64_t> free{0};
+        std::atomic<std::size_t> available{0};
+        /** @brief The pool itself and every block in use. */
+        std::atomic<std::size_t> users{1};
+    };
+
+    static void recycle(Block* block)
+    {
+        block->arena->push(block);
+    }
+
+    Arena* m_arena;
+};
+
+}  // namespace Core
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/event/event.hpp"
+#include "core/util/connection.hpp"
+
+namespace Core {
+
+class IEventBroker;
+
+/**
+ * @brief Thrown when a request is answered by its Failure event, see IEventBroker::request().
+ */
+class RequestError : public std::runtime_error
+{
+   public:
+    using std::runtime_error::runtime_error;
+};
+
+namespace Detail {
+inline auto nextRequestId() -> RequestId
+{
+    static std::atomic<RequestId> next{1};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+}  // namespace Detail
+
+/**
+ * @brief The pending reply to a request, see IEventBroker::request().
+ *
+ * @details
+ * Can be awaited in a coroutine (see Core::Task), which then resumes on the thread the reply is
+ * delivered on, or waited for like a future. A reply that arrives before it is awaited is kept.
+ * Destroying the Reply ends the subscriptions, a later reply is ignored.
+ *
+ * @tparam Response The event type answering the request.
+ */
+template <typename Response>
+class Reply
+{
+   public:
+    Reply(Reply&&) noexcept = default;
+    auto operator=(Reply&&) noexcept -> Reply& = default;
+
+    /** @brief Returns the ID the replies to the request carry. */
+    [[nodiscard]] auto requestId() const -> RequestId
+    {
+        return m_id;
+    }
+
+    /** @brief Checks if the response or the failure arrived. */
+    [[nodiscard]] auto ready() const -> bool
+    {
+        std::lock_guard lock(m_state->mutex);
+        return m_state->done();
+    }
+
+    /**
+     * @brief Waits for the reply, at most for @p timeout.
+     * @return True if it arrived.
+     */
+    template <typename Rep, typename Period>
+    auto waitFor(const std::chrono::duration<Rep, Period> timeout) const -> bool
+    {
+        std::unique_lock lock(m_state->mutex);
+        return m_state->arrived.wait_for(lock, timeout, [&]() -> bool { return m_state->done(); });
+    }
+
+    /**
+     * @brief Waits for the reply and takes the response. Must not be called on the thread that
+     * delivers the reply, e.g. the GUI thread for requests made there, which would never return.
+     * @throws RequestError If the request failed.
+     */
+    auto get() -> Response
+    {
+        std::unique_lock lock(m_state->mutex);
+        m_state->arrived.wait(lock, [&]() -> bool { return m_state->done(); });
+        return m_state->take();
+    }
+
+    auto await_ready() const -> bool
+    {
+        return ready();
+    }
+
+    /** @brief Suspends the awaiting coroutine, unless the reply arrived meanwhile. */
+    auto await_suspend(const std::coroutine_handle<> awaiting) -> bool
+    {
+        std::lock_guard lock(m_state->mutex);
+        if (m_state->done())
+        {
+            return false;
+        }
+        m_state->continuation = awaiting;
+        return true;
+    }
+
+    /** @throws RequestError If the request failed. */
+    auto await_resume() -> Response
+    {
+        std::lock_guard lock(m_state->mutex);
+        return m_state->take();
+    }
+
+   private:
+    friend class IEventBroker;
+
+    struct State {
+        std::mutex mutex;
+        std::condition_variable arrived;
+        std::optional<Response> response;
+        std::optional<std::string> failure;
+        std::coroutine_handle<> continuation;
+
+        [[nodiscard]] auto done() const -> bool
+        {
+            return response.has_value() || failure.has_value();
+        }
+
+        auto take() -> Response
+        {
+            if (failure)
+            {
+                throw RequestError(*failure);
+            }
+            return std::move(*response);
+        }
+
+        /** @brief Stores the first reply and resumes the awaiting coroutine, if any. */
+        template <typename Store>
+        void complete(Store&& store)
+        {
+            std::coroutine_handle<> awaiting;
+            {
+                std::lock_guard lock(mutex);
+                if (done())
+                {
+                    return;
+                }
+                store(*this);
+                awaiting = std::exchange(continuation, nullptr);
+            }
+            arrived.notify_all();
+            if (awaiting)
+            {
+                awaiting.resume();
+            }
+        }
+    };
+
+    explicit Reply(const RequestId id) : m_state(std::make_shared<State>()), m_id(id) {}
+
+    std::shared_ptr<State> m_state;
+    RequestId m_id;
+    std::vector<Connection> m_connections;
+};
+
+}  // namespace Core
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+
+namespace Core {
+
+/**
+ * @brief Return type of a fire-and-forget coroutine, e.g. a workflow on the GUI thread that
+ * awaits the replies of its requests (see Core::Reply) instead of blocking.
+ *
+ * @details
+ * The coroutine starts running when it is called and frees itself when it finishes. It resumes
+ * on the thread that delivers the awaited reply, which is the consumer thread it was started on.
+ * Exceptions must be handled inside the coroutine, one escaping it terminates the application.
+ *
+ * @code
+ * auto loadDbc(Core::IEventBroker& broker, std::string path) -> Core::Task
+ * {
+ *     Core::ParseDBCRequestEvent request;
+ *     request.filePath = std::move(path);
+ *     const auto parsed = co_await broker.request(std::move(request));
+ *     ...
+ * }
+ * @endcode
+ */
+struct Task {
+    struct promise_type {
+        auto get_return_object() noexcept -> Task
+        {
+            return {};
+        }
+
+        auto initial_suspend() noexcept -> std::suspend_never
+        {
+            return {};
+        }
+
+        auto final_suspend() noexcept -> std::suspend_never
+        {
+            return {};
+        }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() noexcept
+        {
+            std::terminate();
+        }
+    };
+};
+
+}  // namespace Core
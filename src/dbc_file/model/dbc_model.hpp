@@ -107,7 +107,7 @@ class DbcModel : public QAbstractItemModel
      * @brief Rebuilds the internal DbcItem tree structure from the DTO.
      * @caller Internal (onDbcParsed).
      */
-    void setupData(const Core::DbcConfig& data);
+    void setupData(const Core::FlatDbcConfig& data);
 
     // --- Members ---
 
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+namespace EventBroker {
+
+/**
+ * @brief Epoch based reclamation of objects that readers reach through a plain atomic pointer.
+ *
+ * @details
+ * Readers enter a critical section with an EpochGuard, load the pointer and may use the object
+ * until the guard ends. Entering only stores the global epoch into a record owned by the calling
+ * thread, so readers on different threads never write to a shared cache line, unlike copying a
+ * std::shared_ptr, whose reference count every reader increments and decrements.
+ *
+ * A writer replaces the pointer first and then tags the old object with retire(). The object may be
+ * deleted once its tag is below safeEpoch(): every reader that could still have loaded the old
+ * pointer entered its critical section at an epoch up to the tag. Writers keep their retired
+ * objects themselves and reclaim them on their next write.
+ *
+ * Pointer loads by readers and stores by writers must be sequentially consistent, on x86 the loads
+ * are still plain moves. Every thread gets one record on its first critical section; records are
+ * never freed, the record of an exited thread is taken over by the next new thread.
+ */
+class EpochDomain
+{
+   public:
+    /** @brief The state of one thread, padded so threads never share the cache line. */
+    struct alignas(64) Record {
+        /** @brief The epoch the thread entered its critical section at, zero outside. */
+        std::atomic<uint64_t> epoch{0};
+        /** @brief The nesting depth of the critical sections, only used by the owning thread. */
+        uint32_t depth = 0;
+        std::atomic<bool> used{true};
+        Record* next = nullptr;
+    };
+
+    /** @brief Returns the record of the calling thread, registering it on first use. */
+    static auto record() -> Record&
+    {
+        thread_local const Registration registration;
+        return *registration.record;
+    }
+
+    /** @brief Returns the current epoch, which readers enter at. */
+    static auto current() -> uint64_t
+    {
+        return m_epoch.load(std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Advances the epoch, called after a writer replaced a pointer.
+     * @return The tag of the replaced object.
+     */
+    static auto retire() -> uint64_t
+    {
+        return m_epoch.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    /** @brief Returns the epoch objects retired below may be deleted at. */
+    static auto safeEpoch() -> uint64_t
+    {
+        auto oldest = std::numeric_limits<uint64_t>::max();
+        for (const auto* record = m_records.load(std::memory_order_acquire); record != nullptr;
+             record = record->next)
+        {
+            const auto epoch = record->epoch.load(std::memory_order_seq_cst);
+            if (epoch != 0 && epoch < oldest)
+            {
+                oldest = epoch;
+            }
+        }
+        return oldest;
+    }
+
+   private:
+    /** @brief Owns the record of a thread and hands it back when the thread exits. */
+    struct Registration {
+        Record* record = claim();
+
+        Registration() = default;
+        Registration(const Registration&) = delete;
+        auto operator=(const Registration&) -> Registration& = delete;
+
+        ~Registration()
+        {
+            record->used.store(false, std::memory_order_release);
+        }
+    };
+
+    static auto claim() -> Record*
+    {
+        for (auto* record = m_records.load(std::memory_order_acquire); record != nullptr;
+             record = record->next)
+        {
+            bool used = false;
+            if (record->used.compare_exchange_strong(used, true, std::memory_order_acquire))
+            {
+                return record;
+            }
+        }
+        auto* record = new Record;
+        record->next = m_records.load(std::memory_order_relaxed);
+        while (!m_records.compare_exchange_weak(record->next, record, std::memory_order_release,
+                                                std::memory_order_relaxed))
+        {
+        }
+        return record;
+    }
+
+    /** @brief Starts at one, zero marks a record outside of a critical section. */
+    static inline std::atomic<uint64_t> m_epoch{1};
+    static inline std::atomic<Record*> m_records{nullptr};
+};
+
+/**
+ * @brief A read side critical section of the EpochDomain, may be nested.
+ */
+class EpochGuard
+{
+   public:
+    EpochGuard() : m_record(EpochDomain::record())
+    {
+        if (m_record.depth++ == 0)
+        {
+            m_record.epoch.store(EpochDomain::current(), std::memory_order_seq_cst);
+        }
+    }
+
+    EpochGuard(const EpochGuard&) = delete;
+    auto operator=(const EpochGuard&) -> EpochGuard& = delete;
+
+    ~EpochGuard()
+    {
+        if (--m_record.depth == 0)
+        {
+            m_record.epoch.store(0, std::memory_order_release);
+        }
+    }
+
+   private:
+    EpochDomain::Record& m_record;
+};
+
+}  // namespace EventBroker
@@ -0,0 +1,1152 @@
+#include "event_broker.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+#include "core/event/broker_event.hpp"
+
+namespace EventBroker {
+
+namespace {
+
+/** @brief The consumer whose events the calling thread is delivering in drain(), if any. */
+thread_local const void* drainingConsumer = nullptr;
+
+}  // namespace
+
+thread_local const EventBroker::CallbackGuard* EventBroker::CallbackGuard::innermost = nullptr;
+
+inline EventBroker::CallbackGuard::CallbackGuard(Subscriber& subscriber)
+    : m_subscriber(subscriber), m_outer(innermost)
+{
+    m_subscriber.inFlight.fetch_add(1, std::memory_order_seq_cst);
+    innermost = this;
+}
+
+inline EventBroker::CallbackGuard::~CallbackGuard()
+{
+    innermost = m_outer;
+    m_subscriber.inFlight.fetch_sub(1, std::memory_order_seq_cst);
+    // A disconnect clears active before it reads the count, so it is waiting if this sees it.
+    if (!m_subscriber.active.load(std::memory_order_seq_cst))
+    {
+        m_subscriber.inFlight.notify_all();
+    }
+}
+
+inline auto EventBroker::CallbackGuard::active() const -> bool
+{
+    return m_subscriber.active.load(std::memory_order_seq_cst);
+}
+
+auto EventBroker::CallbackGuard::ownCallbacks(const Subscriber& subscriber) -> uint32_t
+{
+    uint32_t own = 0;
+    for (const auto* guard = innermost; guard; guard = guard->m_outer)
+    {
+        own += &guard->m_subscriber == &subscriber ? 1 : 0;
+    }
+    return own;
+}
+
+void EventBroker::Consumer::advance()
+{
+    progress.fetch_add(1, std::memory_order_seq_cst);
+    if (waiting.load(std::memory_order_seq_cst) > 0)
+    {
+        progress.notify_all();
+    }
+}
+
+void EventBroker::Consumer::awaitProgress(const uint32_t observed)
+{
+    // Counted before the value is compared, so advance() either notifies or is seen here.
+    waiting.fetch_add(1, std::memory_order_seq_cst);
+    progress.wait(observed, std::memory_order_seq_cst);
+    waiting.fetch_sub(1, std::memory_order_relaxed);
+}
+
+EventBroker::~EventBroker()
+{
+    // Joined without the lock, the workers take it to unregister. A callback may still start
+    // another worker meanwhile, hence the loop.
+    for (;;)
+    {
+        std::vector<std::jthread> threads;
+        {
+            std::lock_guard lock(m_mutex);
+            threads.swap(m_threads);
+        }
+        if (threads.empty())
+        {
+            break;
+        }
+        for (auto& thread : threads)
+        {
+            thread.request_stop();
+        }
+    }
+
+    std::lock_guard lock(m_mutex);
+    for (auto& [thread, consumer] : m_consumers)
+    {
+        discard(*consumer);
+    }
+    for (auto& [name, consumer] : m_workers)
+    {
+        discard(*consumer);
+    }
+    if (m_pool)
+    {
+        discard(*m_pool);
+    }
+}
+
+void EventBroker::attachConsumer(Wakeup wakeup, const Core::DeliveryPolicy defaultPolicy,
+                                 const std::size_t runQueueCapacity)
+{
+    auto consumer =
+        std::make_shared<Consumer>(std::move(wakeup), defaultPolicy, runQueueCapacity);
+    std::lock_guard lock(m_mutex);
+    m_consumers[std::this_thread::get_id()] = std::move(consumer);
+}
+
+void EventBroker::attachGuiConsumer(Wakeup wakeup, const Core::DeliveryPolicy defaultPolicy,
+                                    const std::size_t runQueueCapacity)
+{
+    attachConsumer(std::move(wakeup), defaultPolicy, runQueueCapacity);
+    std::lock_guard lock(m_mutex);
+    m_gui = m_consumers[std::this_thread::get_id()];
+}
+
+void EventBroker::detachConsumer()
+{
+    std::shared_ptr<Consumer> consumer;
+    {
+        std::lock_guard lock(m_mutex);
+        const auto it = m_consumers.find(std::this_thread::get_id());
+        if (it == m_consumers.end())
+        {
+            return;
+        }
+        consumer = std::move(it->second);
+        m_consumers.erase(it);
+        if (m_gui == consumer)
+        {
+            m_gui = nullptr;
+        }
+    }
+    discard(*consumer);
+}
+
+auto EventBroker::drain(const std::size_t maxEvents) -> std::size_t
+{
+    const auto consumer = currentConsumer();
+    if (!consumer)
+    {
+        return 0;
+    }
+
+    // Cleared before draining: a producer that schedules from now on triggers a new wakeup.
+    consumer->wakeupPending.exchange(false, std::memory_order_acq_rel);
+
+    const auto outer = std::exchange(drainingConsumer, consumer.get());
+    flushConflated(*consumer);
+
+    std::size_t delivered = 0;
+    while (delivered < maxEvents)
+    {
+        // The lanes are checked in order of priority before every mailbox, so a control event
+        // posted meanwhile is delivered next instead of behind the remaining data mailboxes.
+        std::shared_ptr<Subscriber> subscriber;
+        std::size_t lane = 0;
+        while (lane < consumer->runQueues.size() && !consumer->runQueues[lane].tryPop(subscriber))
+        {
+            ++lane;
+        }
+        if (!subscriber)
+        {
+            break;
+        }
+        consumer->advance();
+        delivered += deliverMailbox(std::move(subscriber), static_cast<Core::EventPriority>(lane),
+                                    maxEvents - delivered);
+    }
+    drainingConsumer = outer;
+
+    const auto pending =
+        std::any_of(consumer->runQueues.begin(), consumer->runQueues.end(),
+                    [](const auto& queue) -> bool { return queue.sizeApprox() > 0; });
+    if (pending && !consumer->wakeupPending.exchange(true, std::memory_order_acq_rel))
+    {
+        consumer->wakeup(std::chrono::milliseconds::zero());
+    }
+    return delivered;
+}
+
+auto EventBroker::deliverMailbox(std::shared_ptr<Subscriber> subscriber,
+                                 const Core::EventPriority lane, const std::size_t budget)
+    -> std::size_t
+{
+    auto& mailbox = *subscriber->mailbox;
+    auto& consumer = *subscriber->consumer;
+#if BROKER_METRICS
+    auto& latency = m_laneLatency[static_cast<std::size_t>(lane)];
+#endif
+
+    std::size_t delivered = 0;
+    Delivery delivery;
+    while (delivered < budget && (mailbox.queue.tryPop(delivery) || takeSpilled(mailbox, delivery)))
+    {
+        consumer.advance();
+        const CallbackGuard guard(*subscriber);
+        if (guard.active())
+        {
+#if BROKER_METRICS
+            const auto start = std::chrono::steady_clock::now();
+            latency.record(start - delivery.published);
+#endif
+            subscriber->callback(delivery.events.get(), delivery.count);
+#if BROKER_METRICS
+            subscriber->callbackDuration.record(std::chrono::steady_clock::now() - start);
+#endif
+            subscriber->stats->delivered.fetch_add(delivery.count, std::memory_order_relaxed);
+            delivered += delivery.count;
+        }
+        delivery = Delivery();
+    }
+
+    // Cleared only now, so no other thread of a pool delivers to the subscriber meanwhile. An
+    // exchange, so it observes every delivery whose producer still saw the flag set. Anything
+    // left, e.g. when out of budget, is delivered by the next call behind the other subscribers.
+    mailbox.scheduled.exchange(false, std::memory_order_acq_rel);
+    if ((mailbox.queue.sizeApprox() > 0 || mailbox.overflowing.load(std::memory_order_acquire)) &&
+        !mailbox.scheduled.exchange(true, std::memory_order_acq_rel))
+    {
+        schedule(std::move(subscriber), lane);
+    }
+    return delivered;
+}
+
+void EventBroker::runConsumer(const std::stop_token stop, const Core::DeliveryPolicy defaultPolicy)
+{
+    // Shared with the wakeup, which subscribers made here may still call after the loop ended.
+    const auto signal = std::make_shared<Signal>();
+    attachConsumer(
+        [signal](const std::chrono::milliseconds delay) -> void { signal->notify(delay); },
+        defaultPolicy);
+    serve(stop, *signal);
+    detachConsumer();
+}
+
+void EventBroker::serve(const std::stop_token& stop, Signal& signal)
+{
+    while (!stop.stop_requested())
+    {
+        signal.wait(stop);
+        while (drain() > 0)
+        {
+        }
+    }
+}
+
+void EventBroker::Signal::notify(const std::chrono::milliseconds delay)
+{
+    {
+        std::lock_guard lock(mutex);
+        if (delay <= std::chrono::milliseconds::zero())
+        {
+            ++generation;
+        }
+        deadline = std::min(deadline, std::chrono::steady_clock::now() + delay);
+    }
+    // All threads of the pool compete for the run queues, the idle ones wait again.
+    condition.notify_all();
+}
+
+void EventBroker::Signal::wait(const std::stop_token& stop)
+{
+    std::unique_lock lock(mutex);
+    const auto seen = generation;
+    while (generation == seen && !stop.stop_requested() &&
+           std::chrono::steady_clock::now() < deadline)
+    {
+        // Re-evaluated after every notification, since a wakeup may move the deadline. Passed as a
+        // copy, the wait reads it again after releasing the lock.
+        const auto until = deadline;
+        condition.wait_until(lock, stop, until, [&]() -> bool { return generation != seen; });
+    }
+    // Only a passed deadline is reset, an immediate wakeup leaves a pending delayed one intact.
+    if (std::chrono::steady_clock::now() >= deadline)
+    {
+        deadline = idleDeadline();
+    }
+}
+
+auto EventBroker::Signal::idleDeadline() -> std::chrono::steady_clock::time_point
+{
+    return std::chrono::steady_clock::now() + std::chrono::hours(1);
+}
+
+inline void EventBroker::invoke(Subscriber& subscriber, const void* events,
+                                const std::size_t count)
+{
+#if BROKER_METRICS
+    // Two clock reads would cost as much as the rest of an inline delivery, so only a sample of
+    // the calls is measured.
+    thread_local uint32_t calls = 0;
+    if (++calls % callbackSampleInterval == 0)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        subscriber.callback(events, count);
+        subscriber.callbackDuration.record(std::chrono::steady_clock::now() - start);
+        return;
+    }
+#endif
+    subscriber.callback(events, count);
+}
+
+inline void EventBroker::Publication::deliver(const std::shared_ptr<Subscriber>& subscriber,
+                                              const std::size_t offset, const std::size_t length)
+{
+    if (subscriber->conflation)
+    {
+        const CallbackGuard guard(*subscriber);
+        if (guard.active())
+        {
+            subscriber->callback(static_cast<const std::byte*>(data) + offset * ops.size, length);
+            scheduleFlush(*subscriber->consumer, *subscriber->conflation);
+        }
+        return;
+    }
+    if (!subscriber->mailbox || (subscriber->consumer->thread == thread && !subscriber->deferred))
+    {
+        const CallbackGuard guard(*subscriber);
+        if (!guard.active())
+        {
+            return;
+        }
+        invoke(*subscriber, static_cast<const std::byte*>(data) + offset * ops.size, length);
+        subscriber->stats->delivered.fetch_add(length, std::memory_order_relaxed);
+        return;
+    }
+    if (!subscriber->active.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    if (!copy)
+    {
+        copy = std::shared_ptr<const void>(
+            ops.clone(data, count),
+            [destroy = ops.destroy, n = count](void* events) -> void { destroy(events, n); });
+#if BROKER_METRICS
+        copied = std::chrono::steady_clock::now();
+#endif
+    }
+    // Aliases the shared copy, so a single event of the batch keeps the whole copy alive.
+    Delivery delivery{std::shared_ptr<const void>(
+                          copy, static_cast<const std::byte*>(copy.get()) + offset * ops.size),
+                      length};
+#if BROKER_METRICS
+    delivery.published = copied;
+#endif
+    post(subscriber, std::move(delivery), ops.priority);
+}
+
+void EventBroker::_publish(const Core::EventTypeId type, const void* data, const std::size_t count,
+                           const Core::EventOps& ops)
+{
+    auto& channel = getChannel(type);
+    Publication publication{data, count, ops, std::this_thread::get_id(), nullptr};
+    const EpochGuard guard;
+    if (!ops.key)
+    {
+#if BROKER_METRICS
+        channel.published.fetch_add(count, std::memory_order_relaxed);
+#endif
+        dispatch(*channel.subscribers.load(std::memory_order_seq_cst), publication, 0, count);
+        return;
+    }
+
+    // Dispatches each run of events of the same partition, a batch from one bus is a single run.
+    const auto* bytes = static_cast<const std::byte*>(data);
+    std::size_t begin = 0;
+    while (begin < count)
+    {
+        const auto index = partitionOf(ops.key(bytes + begin * ops.size).interfaceId);
+        auto end = begin + 1;
+        while (end < count && partitionOf(ops.key(bytes + end * ops.size).interfaceId) == index)
+        {
+            ++end;
+        }
+        auto& partition = channel.partitions[index];
+#if BROKER_METRICS
+        partition.published.fetch_add(end - begin, std::memory_order_relaxed);
+#endif
+        dispatch(*partition.subscribers.load(std::memory_order_seq_cst), publication, begin, end);
+        begin = end;
+    }
+}
+
+void EventBroker::dispatch(const Channel::Subscribers& subscribers, Publication& publication,
+                           const std::size_t begin, const std::size_t end)
+{
+    for (const auto& subscriber : subscribers.all)
+    {
+        publication.deliver(subscriber, begin, end - begin);
+    }
+
+    const auto& ops = publication.ops;
+    if (!subscribers.hasFiltered() || !ops.key)
+    {
+        return;
+    }
+    const auto* bytes = static_cast<const std::byte*>(publication.data);
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        const auto key = ops.key(bytes + i * ops.size);
+        for (const auto& subscriber : subscribers.anyId)
+        {
+            if (subscriber->filter->acceptsInterface(key.interfaceId))
+            {
+                publication.deliver(subscriber, i, 1);
+            }
+        }
+        const auto it = subscribers.byId.find(key.id);
+        if (it == subscribers.byId.end())
+        {
+            continue;
+        }
+        for (const auto& subscriber : it->second)
+        {
+            if (subscriber->filter->acceptsInterface(key.interfaceId))
+            {
+                publication.deliver(subscriber, i, 1);
+            }
+        }
+    }
+}
+
+auto EventBroker::_subscribe(const Core::EventTypeId type, Core::EventCallback callback,
+                             Core::SubscriptionOptions options) -> Core::Connection
+{
+    auto subscriber = std::make_shared<Subscriber>();
+    subscriber->callback = std::move(callback);
+    return addSubscriber(type, std::move(subscriber), options);
+}
+
+auto EventBroker::_subscribeFiltered(const Core::EventTypeId type, Core::EventFilter filter,
+                                     Core::EventCallback callback,
+                                     Core::SubscriptionOptions options) -> Core::Connection
+{
+    auto subscriber = std::make_shared<Subscriber>();
+    subscriber->callback = std::move(callback);
+    subscriber->filter = Core::EventFilter::forIds(std::move(filter.ids), filter.interfaceMask);
+    return addSubscriber(type, std::move(subscriber), options);
+}
+
+auto EventBroker::_subscribedIds(const Core::EventTypeId type, const uint8_t interfaceId)
+    -> std::optional<std::vector<uint32_t>>
+{
+    const EpochGuard guard;
+    const auto* subscribers = getChannel(type).subscribers.load(std::memory_order_seq_cst);
+    if (!subscribers->all.empty())
+    {
+        return std::nullopt;
+    }
+    for (const auto& subscriber : subscribers->anyId)
+    {
+        if (subscriber->filter->acceptsInterface(interfaceId))
+        {
+            return std::nullopt;
+        }
+    }
+
+    std::vector<uint32_t> ids;
+    for (const auto& [id, list] : subscribers->byId)
+    {
+        if (std::any_of(list.begin(), list.end(), [&](const auto& subscriber) -> bool {
+                return subscriber->filter->acceptsInterface(interfaceId);
+            }))
+        {
+            ids.push_back(id);
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+auto EventBroker::_subscribeConflated(const Core::EventTypeId type,
+                                      const std::chrono::milliseconds minInterval,
+                                      Core::EventCallback collect,
+                                      Core::InplaceDelegate<void()> flush) -> Core::Connection
+{
+    const auto consumer = currentConsumer();
+    if (!consumer)
+    {
+        throw std::logic_error("Conflating subscriptions must be made on a consumer thread");
+    }
+
+    auto subscriber = std::make_shared<Subscriber>();
+    subscriber->callback = std::move(collect);
+    subscriber->conflation = std::make_unique<Conflation>();
+    subscriber->conflation->flush = std::move(flush);
+    subscriber->conflation->minInterval = minInterval;
+    {
+        std::lock_guard lock(consumer->conflatedMutex);
+        consumer->conflated.push_back(subscriber);
+    }
+    return addSubscriber(type, std::move(subscriber), {});
+}
+
+auto EventBroker::subscriptionDiagnostics() -> std::vector<Core::SubscriptionDiagnostics>
+{
+    std::vector<Core::SubscriptionDiagnostics> diagnostics;
+    std::unordered_set<const Subscriber*> visited;
+    const auto collect = [&](const Subscriber& subscriber) -> void {
+        if (!visited.insert(&subscriber).second)
+        {
+            return;
+        }
+        const auto& stats = *subscriber.stats;
+        auto policy = Core::DeliveryPolicy::Block;
+        if (subscriber.conflation)
+        {
+            policy = Core::DeliveryPolicy::Conflate;
+        }
+        else if (subscriber.mailbox)
+        {
+            policy = subscriber.mailbox->policy;
+        }
+        auto& entry = diagnostics.emplace_back();
+        entry.label = subscriber.label;
+        entry.eventType = subscriber.type;
+        entry.policy = policy;
+        entry.capacity = subscriber.mailbox ? subscriber.mailbox->queue.capacity() : 0;
+        entry.queued = stats.queued.load(std::memory_order_relaxed);
+        entry.delivered = stats.delivered.load(std::memory_order_relaxed);
+        entry.dropped = stats.dropped.load(std::memory_order_relaxed);
+#if BROKER_METRICS
+        const auto& duration = subscriber.callbackDuration;
+        entry.callbackSamples = duration.count();
+        entry.callbackP50 = duration.percentile(0.5);
+        entry.callbackP99 = duration.percentile(0.99);
+        entry.callbackMax = duration.max();
+#endif
+    };
+
+    const EpochGuard guard;
+    for (const auto& channel : channels)
+    {
+        const auto* subscribers = channel.subscribers.load(std::memory_order_seq_cst);
+        for (const auto& subscriber : subscribers->all)
+        {
+            collect(*subscriber);
+        }
+        for (const auto& subscriber : subscribers->anyId)
+        {
+            collect(*subscriber);
+        }
+        for (const auto& [id, list] : subscribers->byId)
+        {
+            for (const auto& subscriber : list)
+            {
+                collect(*subscriber);
+            }
+        }
+    }
+    return diagnostics;
+}
+
+auto EventBroker::laneDiagnostics() -> std::vector<Core::LaneDiagnostics>
+{
+    std::vector<Core::LaneDiagnostics> diagnostics;
+    for (std::size_t lane = 0; lane < Core::eventPriorityCount; ++lane)
+    {
+        auto& entry = diagnostics.emplace_back();
+        entry.lane = static_cast<Core::EventPriority>(lane);
+#if BROKER_METRICS
+        const auto& latency = m_laneLatency[lane];
+        entry.deliveries = latency.count();
+        entry.p50 = latency.percentile(0.5);
+        entry.p99 = latency.percentile(0.99);
+        entry.max = latency.max();
+#endif
+    }
+    return diagnostics;
+}
+
+auto EventBroker::channelDiagnostics() -> std::vector<Core::ChannelDiagnostics>
+{
+    std::vector<Core::ChannelDiagnostics> diagnostics;
+    std::lock_guard lock(m_mutex);
+    const auto now = std::chrono::steady_clock::now();
+    const auto elapsed = std::chrono::duration<double>(now - m_sampledAt).count();
+    m_sampledAt = now;
+    for (std::size_t type = 0; type < channels.size(); ++type)
+    {
+        auto& channel = channels[type];
+        std::size_t subscribers = 0;
+        {
+            const EpochGuard guard;
+            subscribers = channel.subscribers.load(std::memory_order_seq_cst)->count;
+        }
+        const auto published = channel.publishedEvents();
+        if (subscribers == 0 && published == 0)
+        {
+            continue;
+        }
+        const auto recent = static_cast<double>(published - channel.sampledPublished);
+        channel.sampledPublished = published;
+        diagnostics.push_back({static_cast<Core::EventTypeId>(type), subscribers, published,
+                               elapsed > 0 ? recent / elapsed : 0.0});
+    }
+    return diagnostics;
+}
+
+void EventBroker::startDiagnostics(const std::chrono::milliseconds interval)
+{
+    std::lock_guard lock(m_mutex);
+    if (std::exchange(m_diagnosticsStarted, true))
+    {
+        return;
+    }
+    m_threads.emplace_back([this, interval](const std::stop_token& stop) -> void {
+        std::mutex mutex;
+        std::condition_variable_any condition;
+        std::unique_lock lock(mutex);
+        while (!condition.wait_for(lock, stop, interval, []() -> bool { return false; }) &&
+               !stop.stop_requested())
+        {
+            Core::BrokerDiagnosticsEvent event;
+            event.channels = channelDiagnostics();
+            event.subscriptions = subscriptionDiagnostics();
+            event.lanes = laneDiagnostics();
+            publish(event);
+        }
+    });
+}
+
+auto EventBroker::executorConsumer(const Core::Executor& executor) -> std::shared_ptr<Consumer>
+{
+    switch (executor.kind)
+    {
+        case Core::ExecutorKind::Default:
+            return currentConsumer();
+        case Core::ExecutorKind::Publisher:
+            return nullptr;
+        default:
+            break;
+    }
+
+    std::lock_guard lock(m_mutex);
+    if (executor.kind == Core::ExecutorKind::Gui)
+    {
+        if (!m_gui)
+        {
+            throw std::logic_error("No GUI consumer is attached to the event broker");
+        }
+        return m_gui;
+    }
+    if (executor.kind == Core::ExecutorKind::Worker)
+    {
+        auto& worker = m_workers[executor.name];
+        if (!worker)
+        {
+            worker = startWorkers(1);
+        }
+        return worker;
+    }
+    if (!m_pool)
+    {
+        const auto hardwareThreads = static_cast<std::size_t>(std::thread::hardware_concurrency());
+        m_pool = startWorkers(std::clamp<std::size_t>(hardwareThreads / 2, 1, maxPoolThreads));
+    }
+    return m_pool;
+}
+
+auto EventBroker::startWorkers(const std::size_t threads) -> std::shared_ptr<Consumer>
+{
+    auto signal = std::make_shared<Signal>();
+    auto consumer = std::make_shared<Consumer>(
+        [signal](const std::chrono::milliseconds delay) -> void { signal->notify(delay); },
+        Core::DeliveryPolicy::Block, defaultRunQueueCapacity);
+    consumer->thread = std::thread::id();
+
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        // The thread blocks on m_mutex until the caller releases it.
+        m_threads.emplace_back([this, consumer, signal](const std::stop_token& stop) -> void {
+            {
+                std::lock_guard lock(m_mutex);
+                m_consumers[std::this_thread::get_id()] = consumer;
+            }
+            serve(stop, *signal);
+            std::lock_guard lock(m_mutex);
+            m_consumers.erase(std::this_thread::get_id());
+        });
+    }
+    return consumer;
+}
+
+auto EventBroker::addSubscriber(const Core::EventTypeId type,
+                                std::shared_ptr<Subscriber> subscriber,
+                                const Core::SubscriptionOptions& options) -> Core::Connection
+{
+    subscriber->consumer =
+        subscriber->conflation ? currentConsumer() : executorConsumer(options.executor);
+    subscriber->type = type;
+    subscriber->label = options.label;
+    subscriber->deferred = options.dispatch == Core::DispatchMode::Deferred;
+    if (subscriber->deferred && !subscriber->consumer)
+    {
+        throw std::logic_error("Deferred subscriptions must be delivered on a consumer thread");
+    }
+    if (subscriber->consumer && !subscriber->conflation)
+    {
+        const auto policy = options.policy.value_or(subscriber->consumer->defaultPolicy);
+        // A conflating mailbox only ever holds the newest delivery.
+        subscriber->mailbox = std::make_unique<Mailbox>(
+            policy, policy == Core::DeliveryPolicy::Conflate ? 1 : options.capacity);
+    }
+
+    auto& channel = getChannel(type);
+    channel.add(subscriber);
+
+    // Channels live as long as the broker, so the reference stays valid.
+    auto stats = subscriber->stats;
+    return Core::Connection(
+        [this, &channel, subscriber]() -> void {
+            subscriber->active.store(false, std::memory_order_seq_cst);
+            channel.remove(subscriber.get());
+            // Callbacks capture their owner, which may be destroyed as soon as this returns.
+            waitForCallbacks(*subscriber);
+        },
+        std::move(stats));
+}
+
+void EventBroker::waitForCallbacks(const Subscriber& subscriber)
+{
+    const auto own = CallbackGuard::ownCallbacks(subscriber);
+    auto inFlight = subscriber.inFlight.load(std::memory_order_seq_cst);
+    if (inFlight <= own)
+    {
+        return;
+    }
+
+    // Producers that wait for space in a mailbox of this consumer spill instead from now on.
+    const auto consumer = currentConsumer();
+    if (consumer)
+    {
+        consumer->releasing.fetch_add(1, std::memory_order_seq_cst);
+        consumer->advance();
+    }
+    while (inFlight > own)
+    {
+        subscriber.inFlight.wait(inFlight, std::memory_order_seq_cst);
+        inFlight = subscriber.inFlight.load(std::memory_order_seq_cst);
+    }
+    if (consumer)
+    {
+        consumer->releasing.fetch_sub(1, std::memory_order_seq_cst);
+    }
+}
+
+void EventBroker::post(const std::shared_ptr<Subscriber>& subscriber, Delivery delivery,
+                       const Core::EventPriority lane)
+{
+    auto& mailbox = *subscriber->mailbox;
+    auto& stats = *subscriber->stats;
+    const auto count = delivery.count;
+
+    Delivery evicted;
+    if (mailbox.policy == Core::DeliveryPolicy::Conflate)
+    {
+        while (mailbox.queue.tryPop(evicted))
+        {
+            stats.dropped.fetch_add(evicted.count, std::memory_order_relaxed);
+        }
+    }
+    bool queued = false;
+    if (mailbox.overflowing.load(std::memory_order_acquire))
+    {
+        spill(mailbox, std::move(delivery));
+        queued = true;
+    }
+    while (!queued && !mailbox.queue.tryPush(std::move(delivery)))
+    {
+        switch (mailbox.policy)
+        {
+            case Core::DeliveryPolicy::Block:
+            {
+                auto& consumer = *subscriber->consumer;
+                // Loaded before the checks, so space freed or a release begun after them ends
+                // the wait.
+                const auto observed = consumer.progress.load(std::memory_order_seq_cst);
+                // Waiting on a thread of the consumer would wait for itself forever, as would
+                // a callback the consumer waits for to release its connection.
+                if (isConsumerThread(consumer) ||
+                    consumer.releasing.load(std::memory_order_seq_cst) > 0)
+                {
+                    spill(mailbox, std::move(delivery));
+                    queued = true;
+                    break;
+                }
+                queued = mailbox.queue.tryPush(std::move(delivery));
+                if (!queued)
+                {
+                    consumer.awaitProgress(observed);
+                }
+                break;
+            }
+            case Core::DeliveryPolicy::DropNewest:
+                stats.dropped.fetch_add(count, std::memory_order_relaxed);
+                return;
+            case Core::DeliveryPolicy::DropOldest:
+            case Core::DeliveryPolicy::Conflate:
+                // The consumer may have emptied the mailbox in the meantime, then just retry.
+                if (mailbox.queue.tryPop(evicted))
+                {
+                    stats.dropped.fetch_add(evicted.count, std::memory_order_relaxed);
+                }
+                break;
+        }
+    }
+    stats.queued.fetch_add(count, std::memory_order_relaxed);
+
+    if (!mailbox.scheduled.exchange(true, std::memory_order_acq_rel))
+    {
+        schedule(subscriber, lane);
+    }
+}
+
+void EventBroker::spill(Mailbox& mailbox, Delivery delivery)
+{
+    std::lock_guard lock(mailbox.overflowMutex);
+    mailbox.overflow.push_back(std::move(delivery));
+    mailbox.overflowing.store(true, std::memory_order_release);
+}
+
+auto EventBroker::takeSpilled(Mailbox& mailbox, Delivery& delivery) -> bool
+{
+    if (!mailbox.overflowing.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+    std::lock_guard lock(mailbox.overflowMutex);
+    if (mailbox.overflow.empty())
+    {
+        return false;
+    }
+    delivery = std::move(mailbox.overflow.front());
+    mailbox.overflow.pop_front();
+    mailbox.overflowing.store(!mailbox.overflow.empty(), std::memory_order_release);
+    return true;
+}
+
+void EventBroker::schedule(std::shared_ptr<Subscriber> subscriber, const Core::EventPriority lane)
+{
+    auto& consumer = *subscriber->consumer;
+    auto& runQueue = consumer.runQueues[static_cast<std::size_t>(lane)];
+    // Every subscriber is in a run queue at most once, so it only fills up if the consumer has
+    // more subscriptions with pending deliveries than its capacity.
+    while (!runQueue.tryPush(std::move(subscriber)))
+    {
+        const auto observed = consumer.progress.load(std::memory_order_seq_cst);
+        if (runQueue.tryPush(std::move(subscriber)))
+        {
+            break;
+        }
+        consumer.awaitProgress(observed);
+    }
+    if (!consumer.wakeupPending.exchange(true, std::memory_order_acq_rel))
+    {
+        consumer.wakeup(std::chrono::milliseconds::zero());
+    }
+}
+
+void EventBroker::discard(Consumer& consumer)
+{
+    // The run queue and the conflating subscriptions refer back to the consumer.
+    std::shared_ptr<Subscriber> subscriber;
+    for (auto& runQueue : consumer.runQueues)
+    {
+        while (runQueue.tryPop(subscriber))
+        {
+            Delivery delivery;
+            while (subscriber->mailbox->queue.tryPop(delivery) ||
+                   takeSpilled(*subscriber->mailbox, delivery))
+            {
+            }
+        }
+    }
+    // Producers waiting for the emptied mailboxes retry.
+    consumer.advance();
+    std::lock_guard lock(consumer.conflatedMutex);
+    consumer.conflated.clear();
+}
+
+void EventBroker::scheduleFlush(Consumer& consumer, Conflation& conflation)
+{
+    if (conflation.scheduled.exchange(true, std::memory_order_acq_rel))
+    {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    const auto due = std::chrono::steady_clock::duration(
+        conflation.nextFlush.load(std::memory_order_acquire));
+    const auto delay = std::max(std::chrono::ceil<std::chrono::milliseconds>(due - now),
+                                std::chrono::milliseconds::zero());
+    conflation.wakeupAt.store((now + delay).count(), std::memory_order_release);
+    consumer.wakeup(delay);
+}
+
+void EventBroker::flushConflated(Consumer& consumer)
+{
+    std::vector<std::shared_ptr<Subscriber>> conflated;
+    {
+        std::lock_guard lock(consumer.conflatedMutex);
+        std::erase_if(consumer.conflated, [](const auto& subscriber) -> bool {
+            return !subscriber->active.load(std::memory_order_acquire);
+        });
+        conflated = consumer.conflated;
+    }
+
+    // Called without the lock, so flush callbacks may subscribe and unsubscribe.
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    for (const auto& subscriber : conflated)
+    {
+        auto& conflation = *subscriber->conflation;
+        if (!conflation.scheduled.load(std::memory_order_acquire))
+        {
+            continue;
+        }
+        const auto due = std::chrono::steady_clock::duration(
+            conflation.nextFlush.load(std::memory_order_acquire));
+        if (now < due)
+        {
+            // Drained before the flush is due. If that was the requested wakeup itself, e.g. a
+            // coarse timer firing early, ask again for the rest; otherwise it is still pending.
+            const auto wakeupAt = std::chrono::steady_clock::duration(
+                conflation.wakeupAt.load(std::memory_order_acquire));
+            if (now >= wakeupAt)
+            {
+                const auto delay = std::chrono::ceil<std::chrono::milliseconds>(due - now);
+                conflation.wakeupAt.store((now + delay).count(), std::memory_order_release);
+                consumer.wakeup(delay);
+            }
+            continue;
+        }
+        conflation.nextFlush.store((now + conflation.minInterval).count(),
+                                   std::memory_order_release);
+        // Cleared before flushing: events collected from now on schedule the next flush.
+        conflation.scheduled.store(false, std::memory_order_release);
+        const CallbackGuard guard(*subscriber);
+        if (guard.active())
+        {
+#if BROKER_METRICS
+            const auto start = std::chrono::steady_clock::now();
+#endif
+            conflation.flush();
+#if BROKER_METRICS
+            subscriber->callbackDuration.record(std::chrono::steady_clock::now() - start);
+#endif
+        }
+    }
+}
+
+auto EventBroker::isConsumerThread(const Consumer& consumer) -> bool
+{
+    return consumer.thread == std::this_thread::get_id() || drainingConsumer == &consumer;
+}
+
+auto EventBroker::currentConsumer() -> std::shared_ptr<Consumer>
+{
+    std::lock_guard lock(m_mutex);
+    const auto it = m_consumers.find(std::this_thread::get_id());
+    return it != m_consumers.end() ? it->second : nullptr;
+}
+
+auto EventBroker::getChannel(const Core::EventTypeId type) -> Channel&
+{
+    if (type >= maxEventTypes)
+    {
+        throw std::length_error("Too many event types used with the event broker");
+    }
+    return channels[type];
+}
+
+EventBroker::Channel::~Channel()
+{
+    // No publisher is left, the current snapshots are owned by nothing else.
+    const auto release = [](const std::atomic<const Subscribers*>& slot) -> void {
+        const auto* current = slot.load(std::memory_order_relaxed);
+        if (current != &emptySubscribers())
+        {
+            delete current;
+        }
+    };
+    release(subscribers);
+    for (const auto& partition : partitions)
+    {
+        release(partition.subscribers);
+    }
+}
+
+void EventBroker::Channel::add(const std::shared_ptr<Subscriber>& subscriber)
+{
+    std::lock_guard lock(writeMutex);
+    replace(subscribers, withSubscriber(*subscribers.load(std::memory_order_relaxed), subscriber));
+    for (std::size_t index = 0; index < partitions.size(); ++index)
+    {
+        if (covers(*subscriber, index))
+        {
+            auto& partition = partitions[index].subscribers;
+            replace(partition,
+                    withSubscriber(*partition.load(std::memory_order_relaxed), subscriber));
+        }
+    }
+    reclaim();
+}
+
+void EventBroker::Channel::remove(const Subscriber* subscriber)
+{
+    std::lock_guard lock(writeMutex);
+    if (auto updated = withoutSubscriber(*subscribers.load(std::memory_order_relaxed), subscriber))
+    {
+        replace(subscribers, std::move(updated));
+    }
+    for (std::size_t index = 0; index < partitions.size(); ++index)
+    {
+        auto& partition = partitions[index].subscribers;
+        if (!covers(*subscriber, index))
+        {
+            continue;
+        }
+        const auto* current = partition.load(std::memory_order_relaxed);
+        if (auto updated = withoutSubscriber(*current, subscriber))
+        {
+            replace(partition, std::move(updated));
+        }
+    }
+    reclaim();
+}
+
+void EventBroker::Channel::replace(std::atomic<const Subscribers*>& slot,
+                                   std::unique_ptr<const Subscribers> updated)
+{
+    const auto* previous = slot.exchange(updated.release(), std::memory_order_seq_cst);
+    if (previous != &emptySubscribers())
+    {
+        retired.emplace_back(EpochDomain::retire(), previous);
+    }
+}
+
+void EventBroker::Channel::reclaim()
+{
+    // Publishers still dispatching keep their snapshots until a later write of the channel.
+    const auto safe = EpochDomain::safeEpoch();
+    std::erase_if(retired, [safe](const auto& entry) -> bool { return entry.first < safe; });
+}
+
+auto EventBroker::Channel::publishedEvents() const -> uint64_t
+{
+    uint64_t published = 0;
+#if BROKER_METRICS
+    published = this->published.load(std::memory_order_relaxed);
+    for (const auto& partition : partitions)
+    {
+        published += partition.published.load(std::memory_order_relaxed);
+    }
+#endif
+    return published;
+}
+
+auto EventBroker::Channel::withSubscriber(const Subscribers& current,
+                                          const std::shared_ptr<Subscriber>& subscriber)
+    -> std::unique_ptr<const Subscribers>
+{
+    auto updated = std::make_unique<Subscribers>(current);
+    ++updated->count;
+    if (!subscriber->filter)
+    {
+        updated->all.push_back(subscriber);
+    }
+    else if (subscriber->filter->ids.empty())
+    {
+        updated->anyId.push_back(subscriber);
+    }
+    else
+    {
+        for (const auto id : subscriber->filter->ids)
+        {
+            updated->byId[id].push_back(subscriber);
+        }
+    }
+    return updated;
+}
+
+auto EventBroker::Channel::withoutSubscriber(const Subscribers& current,
+                                             const Subscriber* subscriber)
+    -> std::unique_ptr<const Subscribers>
+{
+    const auto matches = [subscriber](const auto& candidate) -> bool {
+        return candidate.get() == subscriber;
+    };
+
+    auto updated = std::make_unique<Subscribers>(current);
+    bool removed = std::erase_if(updated->all, matches) > 0;
+    removed |= std::erase_if(updated->anyId, matches) > 0;
+    if (subscriber->filter)
+    {
+        for (const auto id : subscriber->filter->ids)
+        {
+            const auto it = updated->byId.find(id);
+            if (it == updated->byId.end() || std::erase_if(it->second, matches) == 0)
+            {
+                continue;
+            }
+            removed = true;
+            if (it->second.empty())
+            {
+                updated->byId.erase(it);
+            }
+        }
+    }
+    if (!removed)
+    {
+        return nullptr;
+    }
+    --updated->count;
+    return updated;
+}
+
+auto EventBroker::Channel::emptySubscribers() -> const Subscribers&
+{
+    static const Subscribers empty;
+    return empty;
+}
+
+auto EventBroker::Channel::covers(const Subscriber& subscriber, const std::size_t partition)
+    -> bool
+{
+    if (!subscriber.filter)
+    {
+        return true;
+    }
+    for (uint8_t interfaceId = 0; interfaceId < 32; ++interfaceId)
+    {
+        if (partitionOf(interfaceId) == partition &&
+            subscriber.filter->acceptsInterface(interfaceId))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace EventBroker
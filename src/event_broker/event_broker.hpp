@@ -5,82 +5,680 @@
 #ifndef CANBUSSIMULATOR_EVENTBROKER_HPP
 #define CANBUSSIMULATOR_EVENTBROKER_HPP
 
-#include <entt/entt.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "core/interface/i_event_broker.hpp"
+#include "core/util/latency_histogram.hpp"
+#include "epoch_reclamation.hpp"
+#include "mpmc_queue.hpp"
+
+/**
+ * @brief Set to 0 to build the broker without metrics, see the CMake option ENABLE_BROKER_METRICS.
+ */
+#ifndef BROKER_METRICS
+#define BROKER_METRICS 1
+#endif
+
 namespace EventBroker {
 /**
  * @brief A implementation of the @code IEventBroker. Implements the virtual methods of the
  * IEventBroker to subscribe to and publish events.
- * @details It is based on Entt dispatchers: For every event type a dispatcher is registered
- * It provides all logic to subscribe/publish events for that event type.
+ * @details For every event type a channel holds the subscribers of that event type. Channels live
+ * in a flat table indexed by Core::eventTypeId(), so finding the subscribers of a published event
+ * is one indexed load without hashing or locking.
+ *
+ * Events can be published from any thread. A thread that registers itself via attachConsumer()
+ * becomes a consumer thread: subscriptions made on it are delivered on it. If such an event is
+ * published on another thread, a copy is put into the bounded lock-free mailbox of the
+ * subscription and the consumer delivers them when it calls drain(), e.g. from the Qt event loop
+ * or from runConsumer() on a worker thread. Subscriptions made on other threads, and publishes on
+ * the consumer thread itself, are delivered immediately on the publishing thread.
+ *
+ * Every mailbox has its own Core::DeliveryPolicy, so a slow view that drops old frames never holds
+ * back the logging of the same frames. Mailboxes with pending deliveries are put into the run
+ * queue of their consumer once, which drain() works through.
+ *
+ * Every consumer has one run queue per Core::EventPriority. drain() serves the control lane
+ * before every data mailbox, so e.g. a stop event never waits behind a backlog of CAN frames.
+ * The time deliveries spend queued is measured per lane, see laneDiagnostics().
+ *
+ * Filtered subscriptions are indexed by the IDs they accept, so a published frame only visits the
+ * subscribers of its own CAN ID instead of every subscriber of the event type.
+ *
+ * Channels of KeyedEvent types, i.e. the CAN data events, are partitioned by interface: a frame is
+ * dispatched through the partition of its bus, which holds the subscribers filtering on that bus
+ * and the unfiltered ones, the merged view of all buses. Receive threads of different buses
+ * therefore publish without contending with each other, up to interfacePartitions buses. A batch
+ * that mixes buses reaches batch subscribers as several calls, one per run of the same partition.
+ *
+ * Conflating subscriptions collect on the publishing thread and are flushed by drain() on their
+ * consumer thread, rate limited through delayed wakeups.
+ *
+ * A subscription can also choose its thread through a Core::Executor: the GUI consumer (see
+ * attachGuiConsumer()), a named worker or the shared pool. Workers and the pool are consumers
+ * whose threads the broker starts on first use and joins on destruction.
+ *
+ * Subscriptions with Core::DispatchMode::Deferred are queued even when published to from their
+ * own consumer thread, so the GUI receives them batched once per event loop iteration and a
+ * callback that publishes never re-enters a deferred subscriber. A consumer may also ignore its
+ * wakeups and call drain() from a timer with a fixed tick instead, which bounds the work per tick
+ * by maxEvents; conflating subscriptions are then flushed on the first tick they are due.
+ *
+ * Unless built with BROKER_METRICS set to 0, the broker counts the published events per channel,
+ * measures how long deliveries wait in mailboxes per lane and measures the duration of callbacks
+ * per subscription: every delivery from a mailbox, and every callbackSampleInterval-th inline call
+ * of a thread, so measuring costs inline deliveries little. See channelDiagnostics(),
+ * subscriptionDiagnostics(), laneDiagnostics() and startDiagnostics().
  */
 class EventBroker final : public Core::IEventBroker
 {
+   public:
+    /** @brief Default number of subscriptions with pending deliveries a consumer can track. */
+    static constexpr std::size_t defaultRunQueueCapacity = 1024;
+    /** @brief Default maximum number of events delivered by a single drain() call. */
+    static constexpr std::size_t defaultBatchSize = 256;
+    /** @brief Upper bound for the number of distinct event types. */
+    static constexpr std::size_t maxEventTypes = 256;
+    /** @brief Upper bound for the number of threads of the shared pool. */
+    static constexpr std::size_t maxPoolThreads = 4;
+    /** @brief Number of interface partitions of the channels of KeyedEvent types. */
+    static constexpr std::size_t interfacePartitions = 8;
+    /** @brief Every how many inline callbacks of a thread one is measured. */
+    static constexpr uint32_t callbackSampleInterval = 16;
+
+    /**
+     * @brief Requests a drain() call on a consumer thread after a delay, zero meaning as soon as
+     * possible.
+     */
+    using Wakeup = std::function<void(std::chrono::milliseconds delay)>;
+
+    EventBroker() = default;
+    ~EventBroker() override;
+
+    EventBroker(const EventBroker&) = delete;
+    auto operator=(const EventBroker&) -> EventBroker& = delete;
+
+    /**
+     * @brief Registers the calling thread as a consumer thread.
+     * @param wakeup Called by a producer when a mailbox of the consumer becomes non-empty, e.g.
+     * to post a drain() call into the Qt event loop, or with a delay when a conflating
+     * subscription is due later. It is called from the producing thread and must neither block
+     * nor publish.
+     * @param defaultPolicy The policy of subscriptions made on this thread that do not choose one.
+     * @param runQueueCapacity The number of subscriptions on this thread that can have pending
+     * deliveries at the same time.
+     */
+    void attachConsumer(Wakeup wakeup,
+                        Core::DeliveryPolicy defaultPolicy = Core::DeliveryPolicy::Block,
+                        std::size_t runQueueCapacity = defaultRunQueueCapacity);
+
+    /**
+     * @brief Registers the calling thread as a consumer thread and as the target of
+     * Core::Executor::gui(), see attachConsumer().
+     */
+    void attachGuiConsumer(Wakeup wakeup,
+                           Core::DeliveryPolicy defaultPolicy = Core::DeliveryPolicy::Block,
+                           std::size_t runQueueCapacity = defaultRunQueueCapacity);
+
+    /**
+     * @brief Unregisters the calling thread. Events still queued for it are discarded.
+     */
+    void detachConsumer();
+
+    /**
+     * @brief Delivers events queued for the calling consumer thread and flushes its conflating
+     * subscriptions that are due.
+     * @param maxEvents Upper bound of events delivered by this call; a batch is never split, so
+     * the bound is exceeded by at most one batch. If more are queued, the
+     * wakeup is triggered again so the remaining ones are delivered by the next call.
+     * @return The number of delivered events.
+     */
+    auto drain(std::size_t maxEvents = defaultBatchSize) -> std::size_t;
+
+    /**
+     * @brief Registers the calling thread as consumer and delivers its events until a stop is
+     * requested. Intended as the body of a worker thread (e.g. a std::jthread).
+     * @param stop Token ending the loop.
+     * @param defaultPolicy The policy of subscriptions that do not choose one, see
+     * attachConsumer().
+     */
+    void runConsumer(std::stop_token stop,
+                     Core::DeliveryPolicy defaultPolicy = Core::DeliveryPolicy::Block);
+
+    auto subscriptionDiagnostics() -> std::vector<Core::SubscriptionDiagnostics> override;
+    auto laneDiagnostics() -> std::vector<Core::LaneDiagnostics> override;
+    /** @details Publish rates cover the time since the previous call. */
+    auto channelDiagnostics() -> std::vector<Core::ChannelDiagnostics> override;
+
+    /**
+     * @brief Publishes a Core::BrokerDiagnosticsEvent from a broker thread every @p interval,
+     * until the broker is destroyed. Only the first call starts publishing.
+     */
+    void startDiagnostics(std::chrono::milliseconds interval);
+
    protected:
     /**
      * @brief The method, that is called if an event should be published by the event broker
-     * @param type The type ID of the event
-     * @param data A pointer to the event
+     * @param type The ID of the event type
+     * @param data A pointer to the first event
+     * @param count The number of events
+     * @param ops Used to copy the events for subscribers on other consumer threads
      */
-    void _publish(std::type_index type, const void* data) override;
+    void _publish(Core::EventTypeId type, const void* data, std::size_t count,
+                  const Core::EventOps& ops) override;
     /**
      * @brief The method, that is called if you want to subscribe to an event
-     * @param type The type ID of the event
+     * @param type The ID of the event type
      * @param callback A callback function, that is called on that event
+     * @param options The mailbox of the subscription, if it is delivered on a consumer thread
      * @return A connection, that is responsible for keeping the subscription alive. If destroyed
      * the subscription ends
+     * @throws std::logic_error If a deferred subscription would be delivered on the publisher.
+     */
+    auto _subscribe(Core::EventTypeId type, Core::EventCallback callback,
+                    Core::SubscriptionOptions options) -> Core::Connection override;
+    /**
+     * @brief Subscribes to the events of a type that pass a filter
+     * @param type The ID of the event type
+     * @param filter The accepted IDs and interfaces
+     * @param callback A callback function, that is called with each matching event
+     * @param options The mailbox of the subscription, see _subscribe()
+     * @return A connection, see _subscribe()
+     */
+    auto _subscribeFiltered(Core::EventTypeId type, Core::EventFilter filter,
+                            Core::EventCallback callback, Core::SubscriptionOptions options)
+        -> Core::Connection override;
+    /**
+     * @brief Collects the IDs the subscribers of an event type need on an interface
+     * @param type The ID of the event type
+     * @param interfaceId The interface
+     * @return The sorted IDs or std::nullopt if any ID is needed
      */
-    auto _subscribe(std::type_index type,
-                    std::function<void(const void*)> callback) -> Core::Connection override;
+    auto _subscribedIds(Core::EventTypeId type, uint8_t interfaceId)
+        -> std::optional<std::vector<uint32_t>> override;
+    /**
+     * @brief Subscribes a conflating consumer to an event type
+     * @param type The ID of the event type
+     * @param minInterval Minimum time between two flushes
+     * @param collect Called inline by publishers
+     * @param flush Called by drain() on the calling consumer thread
+     * @return A connection, see _subscribe()
+     * @throws std::logic_error If the calling thread is no consumer thread
+     */
+    auto _subscribeConflated(Core::EventTypeId type, std::chrono::milliseconds minInterval,
+                             Core::EventCallback collect, Core::InplaceDelegate<void()> flush)
+        -> Core::Connection override;
 
    private:
+    struct Subscriber;
+
     /**
-     * @brief A chanel is associated with one event type id and contains the dispatcher for that
-     * event
+     * @brief A queued batch of events for a subscriber on a consumer thread.
+     * @details The copy of the batch is shared by all subscribers it is queued for.
      */
-    struct Channel {
-        entt::dispatcher dispatcher;
+    struct Delivery {
+        std::shared_ptr<const void> events;
+        std::size_t count = 0;
+#if BROKER_METRICS
+        /** @brief Time the batch was copied, to measure how long it stays queued. */
+        std::chrono::steady_clock::time_point published;
+#endif
+    };
 
-        /**
-         * @brief Publishes an event to the dispatcher
-         * @param event The event to be published
-         */
-        void trigger(const void* event)
+    /**
+     * @brief The bounded queue of a subscription delivered on a consumer thread.
+     */
+    struct Mailbox {
+        Mailbox(Core::DeliveryPolicy overflowPolicy, std::size_t capacity)
+            : queue(capacity), policy(overflowPolicy)
         {
-            dispatcher.trigger(event);
         }
 
+        BoundedMpmcQueue<Delivery> queue;
+        Core::DeliveryPolicy policy;
+        /** @brief Set while the subscriber is in the run queue, so it is put there only once. */
+        std::atomic<bool> scheduled{false};
         /**
-         * @brief Returns the sink of the dispatcher for subscriptions
-         * @return
+         * @brief Deliveries a thread of the consumer could not wait to queue, see spill().
+         * Delivered after the queue, guarded by overflowMutex.
          */
-        auto sink()
+        std::deque<Delivery> overflow;
+        std::mutex overflowMutex;
+        /** @brief Set while overflow is not empty. */
+        std::atomic<bool> overflowing{false};
+    };
+
+    /**
+     * @brief One or more threads that receive their events via the mailboxes of their
+     * subscriptions.
+     */
+    struct Consumer {
+        using RunQueue = BoundedMpmcQueue<std::shared_ptr<Subscriber>>;
+
+        Consumer(Wakeup wakeupFunction, Core::DeliveryPolicy policy, std::size_t runQueueCapacity)
+            : runQueues{RunQueue(runQueueCapacity), RunQueue(runQueueCapacity)},
+              wakeup(std::move(wakeupFunction)),
+              defaultPolicy(policy)
         {
-            return dispatcher.sink<const void*>();
         }
+
+        /**
+         * @brief The subscribers with pending deliveries in order of their first delivery, one
+         * queue per Core::EventPriority.
+         */
+        std::array<RunQueue, Core::eventPriorityCount> runQueues;
+        Wakeup wakeup;
+        Core::DeliveryPolicy defaultPolicy;
+        /** @brief Set by the first producer after a drain, so wakeup is only called once. */
+        std::atomic<bool> wakeupPending{false};
+        /** @brief Publishes on this thread are delivered inline, none for workers and the pool. */
+        std::thread::id thread = std::this_thread::get_id();
+
+        /** @brief Guards the conflating subscriptions. */
+        std::mutex conflatedMutex;
+        /** @brief The conflating subscriptions flushed by this consumer. */
+        std::vector<std::shared_ptr<Subscriber>> conflated;
+
+        /**
+         * @brief Bumped whenever the consumer frees space in a mailbox or a run queue, or one of
+         * its threads starts releasing. Producers wait for it to change, see awaitProgress().
+         */
+        std::atomic<uint32_t> progress{0};
+        /** @brief The producers waiting in awaitProgress(). */
+        std::atomic<uint32_t> waiting{0};
+        /**
+         * @brief Threads of the consumer waiting in a release for callbacks on other threads,
+         * which may themselves wait for the consumer, see waitForCallbacks().
+         */
+        std::atomic<uint32_t> releasing{0};
+
+        /** @brief Bumps progress and wakes the waiting producers. */
+        void advance();
+        /** @brief Waits until progress differs from @p observed, loaded before the last check. */
+        void awaitProgress(uint32_t observed);
     };
 
     /**
-     * @brief Gets the channel for a specific event type
-     * @param type The type id of the event
-     * @return The associated channel
+     * @brief Flush state of a conflating subscription.
+     */
+    struct Conflation {
+        Core::InplaceDelegate<void()> flush;
+        std::chrono::steady_clock::duration minInterval;
+        /** @brief Earliest time of the next flush, as steady clock ticks. */
+        std::atomic<std::chrono::steady_clock::rep> nextFlush{0};
+        /** @brief Time of the requested wakeup, as steady clock ticks. */
+        std::atomic<std::chrono::steady_clock::rep> wakeupAt{0};
+        /** @brief Set by the first publisher after a flush, so only one wakeup is requested. */
+        std::atomic<bool> scheduled{false};
+    };
+
+    /**
+     * @brief A single subscription.
+     */
+    struct Subscriber {
+        Core::EventCallback callback;
+        /** @brief The consumer thread to deliver on, nullptr to deliver on the publisher. */
+        std::shared_ptr<Consumer> consumer;
+        /** @brief Cleared on unsubscription, so events that are still queued are skipped. */
+        std::atomic<bool> active{true};
+        /** @brief Callbacks that are running or about to check active, see CallbackGuard. */
+        std::atomic<uint32_t> inFlight{0};
+        /** @brief The filter of a filtered subscription, empty for plain subscriptions. */
+        std::optional<Core::EventFilter> filter;
+        /** @brief Set for conflating subscriptions, whose callback collects inline. */
+        std::unique_ptr<Conflation> conflation;
+        /** @brief Set for subscriptions delivered on a consumer thread, except conflating ones. */
+        std::unique_ptr<Mailbox> mailbox;
+        std::shared_ptr<Core::SubscriptionStats> stats =
+            std::make_shared<Core::SubscriptionStats>();
+        std::string label;
+        Core::EventTypeId type = 0;
+        /** @brief Set for Core::DispatchMode::Deferred, so it is never called inline. */
+        bool deferred = false;
+#if BROKER_METRICS
+        /** @brief Duration of the callback, or of the flush of a conflating subscription. */
+        Core::LatencyHistogram callbackDuration;
+#endif
+    };
+
+    /**
+     * @brief A chanel is associated with one event type id and contains the subscribers of that
+     * event.
+     * @details The subscriber lists are copy-on-write: publishers read the current snapshot inside
+     * an EpochGuard, without locking and without touching a reference count, so callbacks may
+     * subscribe or unsubscribe while an event is dispatched. Replaced snapshots are retired and
+     * deleted by a later write once no publisher can still read them, see EpochDomain.
+     *
+     * Events of KeyedEvent types are dispatched through the partition of their interface instead,
+     * which holds its own snapshot of the subscribers accepting that interface and its own
+     * counter. Receive threads of different buses thus never write to the same cache line.
      */
-    auto getChannel(const std::type_index type) -> Channel&
+    struct Channel {
+        using SubscriberList = std::vector<std::shared_ptr<Subscriber>>;
+
+        /**
+         * @brief Immutable snapshot of the subscribers of a channel.
+         */
+        struct Subscribers {
+            /** @brief Plain subscriptions, they receive whole batches. */
+            SubscriberList all;
+            /** @brief Filtered subscriptions that accept every ID on some interfaces. */
+            SubscriberList anyId;
+            /** @brief Filtered subscriptions by accepted ID, a frame only visits its own list. */
+            std::unordered_map<uint32_t, SubscriberList> byId;
+            /** @brief The number of distinct subscribers in the lists. */
+            std::size_t count = 0;
+
+            [[nodiscard]] auto hasFiltered() const -> bool
+            {
+                return !anyId.empty() || !byId.empty();
+            }
+        };
+
+        /**
+         * @brief The subscribers for the interfaces mapped to one partition, see partitionOf().
+         */
+        struct alignas(64) Partition {
+            std::atomic<const Subscribers*> subscribers{&emptySubscribers()};
+#if BROKER_METRICS
+            std::atomic<uint64_t> published{0};
+#endif
+        };
+
+        /** @brief All subscribers, dispatched to for event types without routing key. */
+        std::atomic<const Subscribers*> subscribers{&emptySubscribers()};
+        std::array<Partition, interfacePartitions> partitions;
+        /** @brief Serializes writers of the subscriber lists. */
+        std::mutex writeMutex;
+        /** @brief Replaced snapshots by their EpochDomain::retire() tag, guarded by writeMutex. */
+        std::vector<std::pair<uint64_t, std::unique_ptr<const Subscribers>>> retired;
+#if BROKER_METRICS
+        std::atomic<uint64_t> published{0};
+#endif
+        /** @brief The published events at the previous channelDiagnostics(), guarded by m_mutex. */
+        uint64_t sampledPublished = 0;
+
+        Channel() = default;
+        Channel(const Channel&) = delete;
+        auto operator=(const Channel&) -> Channel& = delete;
+        ~Channel();
+
+        void add(const std::shared_ptr<Subscriber>& subscriber);
+        void remove(const Subscriber* subscriber);
+        /** @brief Publishes a snapshot and retires the one it replaces, called under writeMutex. */
+        void replace(std::atomic<const Subscribers*>& slot,
+                     std::unique_ptr<const Subscribers> updated);
+        /** @brief Deletes the retired snapshots no publisher can read anymore. */
+        void reclaim();
+
+        /** @brief Returns the events published so far, over all partitions. */
+        [[nodiscard]] auto publishedEvents() const -> uint64_t;
+
+        /** @brief The shared empty snapshot, so unused channels allocate nothing. */
+        static auto emptySubscribers() -> const Subscribers&;
+
+        /** @brief Checks if a subscriber accepts any interface mapped to a partition. */
+        static auto covers(const Subscriber& subscriber, std::size_t partition) -> bool;
+        /** @brief Returns a copy of a snapshot with a subscriber added. */
+        static auto withSubscriber(const Subscribers& current,
+                                   const std::shared_ptr<Subscriber>& subscriber)
+            -> std::unique_ptr<const Subscribers>;
+        /** @brief Returns a copy of a snapshot without a subscriber, nullptr if it is not in it. */
+        static auto withoutSubscriber(const Subscribers& current, const Subscriber* subscriber)
+            -> std::unique_ptr<const Subscribers>;
+    };
+
+    /** @brief Returns the partition of the channels that events of an interface go through. */
+    static constexpr auto partitionOf(const uint8_t interfaceId) -> std::size_t
     {
-        auto& ptr = channels[type];
-        if (!ptr)
-        {
-            ptr = std::make_unique<Channel>();
-        }
-        return *ptr;
+        return interfaceId % interfacePartitions;
     }
 
     /**
-     * @brief A map containing the associations between channels and event type ids
+     * @brief State of a single publish call.
+     */
+    struct Publication {
+        const void* data;
+        std::size_t count;
+        const Core::EventOps& ops;
+        std::thread::id thread = std::this_thread::get_id();
+        /** @brief Copy of the batch shared by all subscribers on other threads, made on demand. */
+        std::shared_ptr<const void> copy;
+#if BROKER_METRICS
+        /** @brief Time the copy was made, to measure how long it stays queued. */
+        std::chrono::steady_clock::time_point copied;
+#endif
+
+        /**
+         * @brief Delivers a part of the batch to a subscriber, inline or through its mailbox.
+         * @param subscriber The subscriber.
+         * @param offset Index of the first event to deliver.
+         * @param length Number of events to deliver.
+         */
+        void deliver(const std::shared_ptr<Subscriber>& subscriber, std::size_t offset,
+                     std::size_t length);
+    };
+
+    /**
+     * @brief Wakes the threads of a consumer the broker runs itself, see runConsumer().
+     */
+    struct Signal {
+        std::mutex mutex;
+        std::condition_variable_any condition;
+        /** @brief Incremented by every immediate wakeup. */
+        uint64_t generation = 0;
+        /** @brief Time of the earliest delayed wakeup. */
+        std::chrono::steady_clock::time_point deadline = idleDeadline();
+
+        void notify(std::chrono::milliseconds delay);
+        /**
+         * @brief Waits for an immediate wakeup, the deadline of a delayed one, or a stop.
+         */
+        void wait(const std::stop_token& stop);
+
+        static auto idleDeadline() -> std::chrono::steady_clock::time_point;
+    };
+
+    /**
+     * @brief Delivers the events of the calling thread's consumer whenever the signal is raised,
+     * until a stop is requested.
+     */
+    void serve(const std::stop_token& stop, Signal& signal);
+
+    /**
+     * @brief Starts worker threads that serve a new consumer. Called with m_mutex held.
+     * @param threads The number of threads sharing the consumer.
+     * @return The consumer.
+     */
+    auto startWorkers(std::size_t threads) -> std::shared_ptr<Consumer>;
+
+    /**
+     * @brief Returns the consumer that delivers to an executor, nullptr to deliver inline.
+     * @throws std::logic_error If the GUI executor is requested before attachGuiConsumer().
+     */
+    auto executorConsumer(const Core::Executor& executor) -> std::shared_ptr<Consumer>;
+
+    /**
+     * @brief Registers a subscriber in its channel and returns the connection removing it again.
+     * @details Gives the subscriber a mailbox if it is delivered by a consumer.
+     */
+    auto addSubscriber(Core::EventTypeId type, std::shared_ptr<Subscriber> subscriber,
+                       const Core::SubscriptionOptions& options) -> Core::Connection;
+
+    /**
+     * @brief Puts a delivery into the mailbox of a subscriber and schedules the subscriber on its
+     * consumer.
+     * @details A full mailbox is handled according to its policy: the producer waits, or the
+     * oldest or the new events are dropped and counted. A thread of the consumer itself can not
+     * wait for it, nor can a callback the consumer waits for in a release, so a full Block mailbox
+     * spills their deliveries instead, see spill().
+     */
+    static void post(const std::shared_ptr<Subscriber>& subscriber, Delivery delivery,
+                     Core::EventPriority lane);
+
+    /**
+     * @brief Appends a delivery to the unbounded overflow of a Block mailbox.
+     * @details Used when a thread of the consumer, e.g. the GUI thread publishing to its own
+     * deferred lossless subscription, finds the mailbox full. Until the overflow is delivered,
+     * every producer keeps appending to it, so the events stay in order.
+     */
+    static void spill(Mailbox& mailbox, Delivery delivery);
+
+    /**
+     * @brief Takes the oldest delivery from the overflow of a mailbox.
+     * @return False if the overflow is empty.
+     */
+    static auto takeSpilled(Mailbox& mailbox, Delivery& delivery) -> bool;
+
+    /**
+     * @brief Puts a subscriber into a run queue of its consumer and wakes the consumer up.
+     */
+    static void schedule(std::shared_ptr<Subscriber> subscriber, Core::EventPriority lane);
+
+    /**
+     * @brief Calls the callback of a subscriber on the publishing thread, measuring a sample.
+     */
+    static void invoke(Subscriber& subscriber, const void* events, std::size_t count);
+
+    /**
+     * @brief Counts a callback of a subscriber as in flight for the lifetime of the guard.
+     * @details The count is raised before active() is checked, and disconnect clears active
+     * before it reads the count, so a disconnect that sees no callback in flight also knows that
+     * none starts anymore. A guard that ends after active was cleared wakes the disconnect. Guards
+     * of one thread form a stack, so a disconnect from within a callback does not wait for the
+     * callbacks it is called from.
+     */
+    class CallbackGuard
+    {
+       public:
+        explicit CallbackGuard(Subscriber& subscriber);
+        ~CallbackGuard();
+
+        CallbackGuard(const CallbackGuard&) = delete;
+        auto operator=(const CallbackGuard&) -> CallbackGuard& = delete;
+
+        /** @brief Checks if the callback may still be called. */
+        [[nodiscard]] auto active() const -> bool;
+
+        /** @brief Returns the callbacks of the subscriber the calling thread is running. */
+        static auto ownCallbacks(const Subscriber& subscriber) -> uint32_t;
+
+       private:
+        Subscriber& m_subscriber;
+        const CallbackGuard* m_outer;
+
+        /** @brief The innermost guard of the calling thread. */
+        static thread_local const CallbackGuard* innermost;
+    };
+
+    /**
+     * @brief Waits until no callback of a subscriber runs on another thread, after disconnect.
+     * @details While it waits, the consumer of the calling thread counts as releasing: a callback
+     * blocked on a full mailbox of that consumer would otherwise wait for this thread forever.
+     */
+    void waitForCallbacks(const Subscriber& subscriber);
+
+    /**
+     * @brief Delivers the pending events of a subscriber taken from a run queue.
+     * @param subscriber The subscriber.
+     * @param lane The lane of the run queue.
+     * @param budget Upper bound of events to deliver, see drain().
+     * @return The number of delivered events.
+     */
+    auto deliverMailbox(std::shared_ptr<Subscriber> subscriber, Core::EventPriority lane,
+                        std::size_t budget) -> std::size_t;
+
+    /**
+     * @brief Discards the pending deliveries of a consumer that is going away.
+     */
+    static void discard(Consumer& consumer);
+
+    /**
+     * @brief Requests a flush of a conflating subscription after it collected events.
+     */
+    static void scheduleFlush(Consumer& consumer, Conflation& conflation);
+
+    /**
+     * @brief Flushes the conflating subscriptions of a consumer that are due.
+     */
+    static void flushConflated(Consumer& consumer);
+
+    /**
+     * @brief Delivers the events [begin, end) of a publication to a snapshot of subscribers.
+     */
+    static void dispatch(const Channel::Subscribers& subscribers, Publication& publication,
+                         std::size_t begin, std::size_t end);
+
+    /**
+     * @brief Checks if the calling thread delivers the events of a consumer, so it must never wait
+     * for the consumer to make progress.
+     */
+    static auto isConsumerThread(const Consumer& consumer) -> bool;
+
+    /**
+     * @brief Returns the consumer registered for the calling thread, if any.
+     */
+    auto currentConsumer() -> std::shared_ptr<Consumer>;
+
+    /**
+     * @brief Gets the channel for a specific event type
+     * @param type The ID of the event type
+     * @return The associated channel
+     * @throws std::length_error If more than maxEventTypes event types are used.
+     */
+    auto getChannel(Core::EventTypeId type) -> Channel&;
+
+    /**
+     * @brief Guards the consumers. Only held for lookups, never while dispatching.
+     */
+    std::mutex m_mutex;
+
+    /**
+     * @brief The channels, indexed by event type ID. A channel without subscribers is just an
+     * empty snapshot, so unused entries cost no allocation beyond the table itself.
+     */
+    std::array<Channel, maxEventTypes> channels;
+
+    /**
+     * @brief The registered consumer threads.
+     */
+    std::unordered_map<std::thread::id, std::shared_ptr<Consumer>> m_consumers;
+
+    /** @brief The target of Core::Executor::gui(). */
+    std::shared_ptr<Consumer> m_gui;
+    /** @brief The named workers, started on first use. */
+    std::unordered_map<std::string, std::shared_ptr<Consumer>> m_workers;
+    /** @brief The shared pool, started on first use. */
+    std::shared_ptr<Consumer> m_pool;
+    /** @brief The threads of the workers, the pool and the diagnostics. */
+    std::vector<std::jthread> m_threads;
+    /** @brief Set once startDiagnostics() started its thread. */
+    bool m_diagnosticsStarted = false;
+    /** @brief Time of the previous channelDiagnostics(), guarded by m_mutex. */
+    std::chrono::steady_clock::time_point m_sampledAt = std::chrono::steady_clock::now();
+
+#if BROKER_METRICS
+    /**
+     * @brief Queueing latency of the deliveries to consumer threads, per Core::EventPriority.
      */
-    std::unordered_map<std::type_index, std::unique_ptr<Channel>> channels;
+    std::array<Core::LatencyHistogram, Core::eventPriorityCount> m_laneLatency;
+#endif
 };
 }  // namespace EventBroker
 
-#endif  // CANBUSSIMULATOR_EVENTBROKER_HPP
\ No newline at end of file
+#endif  // CANBUSSIMULATOR_EVENTBROKER_HPP
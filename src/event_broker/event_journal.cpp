@@ -0,0 +1,276 @@
+#include "event_journal.hpp"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+#include "core/macro/console_logging.hpp"
+
+namespace EventBroker {
+
+namespace {
+
+constexpr std::array<char, 4> journalMagic{'C', 'B', 'M', 'J'};
+constexpr uint32_t journalVersion = 2;
+constexpr std::size_t headerSize = journalMagic.size() + sizeof(journalVersion);
+
+/** @brief Tag, payload size and timestamp of a record. */
+constexpr std::size_t recordHeaderSize = sizeof(uint16_t) + sizeof(uint32_t) + sizeof(int64_t);
+
+/**
+ * @brief Collects consecutive records of the same type into a batch of events.
+ * @tparam Events The event types a replay can publish.
+ */
+template <JournaledEvent... Events>
+class ReplayBatch
+{
+   public:
+    /**
+     * @brief Reads a record into the batch, publishing the batch first if it holds another type.
+     * @return False if the tag belongs to none of the types, the record is skipped then.
+     */
+    auto add(const uint16_t tag, JournalReader& in, Core::IEventBroker& broker) -> bool
+    {
+        if (tag != m_tag)
+        {
+            publish(broker);
+            m_tag = tag;
+        }
+        return (read<Events>(tag, in) || ...);
+    }
+
+    void publish(Core::IEventBroker& broker)
+    {
+        (publish<Events>(broker), ...);
+        m_published += m_size;
+        m_size = 0;
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+        return m_size;
+    }
+
+    /** @brief Returns the number of events published so far. */
+    [[nodiscard]] auto published() const -> uint64_t
+    {
+        return m_published;
+    }
+
+   private:
+    template <typename Event>
+    auto read(const uint16_t tag, JournalReader& in) -> bool
+    {
+        if (tag != JournalCodec<Event>::tag)
+        {
+            return false;
+        }
+        std::get<std::vector<Event>>(m_pending).push_back(JournalCodec<Event>::read(in));
+        ++m_size;
+        return true;
+    }
+
+    template <typename Event>
+    void publish(Core::IEventBroker& broker)
+    {
+        auto& events = std::get<std::vector<Event>>(m_pending);
+        if (!events.empty())
+        {
+            broker.publishBatch(std::span<const Event>(events));
+            events.clear();
+        }
+    }
+
+    std::tuple<std::vector<Events>...> m_pending;
+    uint16_t m_tag = 0;
+    std::size_t m_size = 0;
+    uint64_t m_published = 0;
+};
+
+using JournalBatch = ReplayBatch<Core::ReceivedCanRawEvent, Core::ReceivedCanDbcEvent,
+                                 Core::SendCanMessageRawEvent, Core::SendCanMessageDbcEvent,
+                                 Core::ParseDBCRequestEvent>;
+
+template <typename Value>
+auto load(const std::byte* data) -> Value
+{
+    Value value;
+    std::memcpy(&value, data, sizeof(Value));
+    return value;
+}
+
+}  // namespace
+
+EventJournal::EventJournal(Core::IEventBroker& broker, const std::filesystem::path& path)
+    : m_broker(broker),
+      m_start(std::chrono::steady_clock::now()),
+      m_file(path, std::ios::binary | std::ios::trunc)
+{
+    if (!m_file)
+    {
+        throw std::runtime_error("Can not create event journal " + path.string());
+    }
+    m_buffer.reserve(flushThreshold + flushThreshold / 4);
+    const auto* magic = reinterpret_cast<const std::byte*>(journalMagic.data());
+    m_buffer.insert(m_buffer.end(), magic, magic + journalMagic.size());
+    JournalWriter(m_buffer).value(journalVersion);
+}
+
+EventJournal::~EventJournal()
+{
+    m_connections.clear();
+    std::lock_guard lock(m_mutex);
+    writeBuffer();
+}
+
+void EventJournal::flush()
+{
+    std::lock_guard lock(m_mutex);
+    writeBuffer();
+    m_file.flush();
+    if (!m_file)
+    {
+        throw std::runtime_error("Writing the event journal failed");
+    }
+}
+
+auto EventJournal::recordedEvents() const -> uint64_t
+{
+    std::lock_guard lock(m_mutex);
+    return m_recorded;
+}
+
+auto EventJournal::beginRecord(const uint16_t tag, const std::chrono::nanoseconds timestamp)
+    -> std::size_t
+{
+    const auto offset = m_buffer.size();
+    JournalWriter writer(m_buffer);
+    writer.value(tag);
+    writer.value(uint32_t{0});
+    writer.value<int64_t>(timestamp.count());
+    return offset;
+}
+
+void EventJournal::endRecord(const std::size_t offset)
+{
+    const auto size = static_cast<uint32_t>(m_buffer.size() - offset - recordHeaderSize);
+    std::memcpy(m_buffer.data() + offset + sizeof(uint16_t), &size, sizeof(size));
+}
+
+void EventJournal::writeBuffer()
+{
+    if (m_buffer.empty())
+    {
+        return;
+    }
+    const bool failed = !m_file;
+    m_file.write(reinterpret_cast<const char*>(m_buffer.data()),
+                 static_cast<std::streamsize>(m_buffer.size()));
+    if (!m_file && !failed)
+    {
+        LOG_ERR("EventJournal", "Writing the event journal failed, records are lost.");
+    }
+    m_buffer.clear();
+}
+
+JournalReplayer::JournalReplayer(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        throw std::runtime_error("Can not open event journal " + path.string());
+    }
+    const auto size = static_cast<std::size_t>(file.tellg());
+    file.seekg(0);
+
+    std::array<char, headerSize> header{};
+    if (size < headerSize || !file.read(header.data(), header.size()) ||
+        !std::equal(journalMagic.begin(), journalMagic.end(), header.begin()))
+    {
+        throw std::runtime_error(path.string() + " is not an event journal");
+    }
+    if (load<uint32_t>(reinterpret_cast<const std::byte*>(header.data()) + journalMagic.size()) !=
+        journalVersion)
+    {
+        throw std::runtime_error("Unsupported event journal version in " + path.string());
+    }
+    m_records.resize(size - headerSize);
+    if (!file.read(reinterpret_cast<char*>(m_records.data()),
+                   static_cast<std::streamsize>(m_records.size())))
+    {
+        throw std::runtime_error("Can not read event journal " + path.string());
+    }
+}
+
+auto JournalReplayer::replay(Core::IEventBroker& broker, const double speed,
+                             const std::stop_token stop) -> ReplayStats
+{
+    if (!(speed > 0))
+    {
+        throw std::invalid_argument("The replay speed must be positive");
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    auto now = start;
+    std::mutex mutex;
+    std::condition_variable_any sleeper;
+
+    ReplayStats stats;
+    JournalBatch batch;
+    JournalReader reader(m_messages);
+    std::size_t offset = 0;
+    while (offset < m_records.size() && !stop.stop_requested())
+    {
+        const auto* header = m_records.data() + offset;
+        if (m_records.size() - offset < recordHeaderSize)
+        {
+            throw std::runtime_error("Event journal record is truncated");
+        }
+        const auto tag = load<uint16_t>(header);
+        const auto size = load<uint32_t>(header + sizeof(uint16_t));
+        const auto timestamp =
+            std::chrono::nanoseconds(load<int64_t>(header + sizeof(uint16_t) + sizeof(uint32_t)));
+        if (m_records.size() - offset - recordHeaderSize < size)
+        {
+            throw std::runtime_error("Event journal record is truncated");
+        }
+
+        const auto due = start + std::chrono::duration_cast<Clock::duration>(
+                                     std::chrono::duration<double, std::nano>(
+                                         static_cast<double>(timestamp.count()) / speed));
+        if (due > now && (now = Clock::now()) < due)
+        {
+            // Everything collected so far is due, publish it before waiting.
+            batch.publish(broker);
+            std::unique_lock lock(mutex);
+            sleeper.wait_until(lock, stop, due, []() -> bool { return false; });
+            if (stop.stop_requested())
+            {
+                break;
+            }
+            now = Clock::now();
+        }
+
+        reader.reset(std::span(header + recordHeaderSize, size));
+        if (batch.add(tag, reader, broker))
+        {
+            stats.recorded = timestamp;
+        }
+        if (batch.size() >= maxBatchSize)
+        {
+            batch.publish(broker);
+        }
+        offset += recordHeaderSize + size;
+    }
+    batch.publish(broker);
+    stats.events = batch.published();
+    stats.elapsed = Clock::now() - start;
+    return stats;
+}
+
+}  // namespace EventBroker
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <vector>
+
+#include "core/interface/i_event_broker.hpp"
+#include "core/util/payload_pool.hpp"
+#include "journal_codec.hpp"
+
+namespace EventBroker {
+
+/**
+ * @brief Records events of selected types from a broker into an append-only binary journal.
+ *
+ * @details
+ * A journal starts with a header, followed by one record per event: the JournalCodec tag of its
+ * type, the size of the payload, the time since the journal was opened in nanoseconds and the
+ * payload written by the codec. Records are appended in publish order and buffered in memory, the
+ * buffer is written to the file when it exceeds flushThreshold, on flush() and on destruction.
+ *
+ * Recording subscribes on the publishing thread (Core::Executor::publisher()), so events are
+ * timestamped when they are published and never queued or dropped on the way to the journal.
+ * Every event is timestamped when its record is appended, so timestamps never decrease along the
+ * journal, also with several publishing threads. Publishing must have stopped before the journal
+ * is destroyed.
+ *
+ * Interface IDs are stored as they were assigned by the recording application. A replay maps them
+ * to the same interfaces if the DBCs are loaded in the same order.
+ */
+class EventJournal
+{
+   public:
+    static constexpr std::size_t flushThreshold = 64 * 1024;
+
+    /**
+     * @brief Creates the journal file, replacing an existing one.
+     * @throws std::runtime_error If the file can not be opened.
+     */
+    EventJournal(Core::IEventBroker& broker, const std::filesystem::path& path);
+
+    /** @brief Stops recording and writes the buffered records. */
+    ~EventJournal();
+
+    EventJournal(const EventJournal&) = delete;
+    auto operator=(const EventJournal&) -> EventJournal& = delete;
+
+    /**
+     * @brief Starts recording all events of a type published from now on.
+     * @tparam Event An event type with a JournalCodec.
+     */
+    template <JournaledEvent Event>
+    void record()
+    {
+        m_connections.push_back(m_broker.subscribeBatch<Event>(
+            [this](std::span<const Event> events) -> void { append(events); },
+            Core::SubscriptionOptions{.label = "event-journal",
+                                      .executor = Core::Executor::publisher()}));
+    }
+
+    /**
+     * @brief Writes the buffered records to the file.
+     * @throws std::runtime_error If writing to the file failed, now or in an earlier write.
+     */
+    void flush();
+
+    /** @brief Returns the number of events recorded so far. */
+    [[nodiscard]] auto recordedEvents() const -> uint64_t;
+
+   private:
+    template <JournaledEvent Event>
+    void append(std::span<const Event> events)
+    {
+        std::lock_guard lock(m_mutex);
+        JournalWriter writer(m_buffer);
+        for (const auto& event : events)
+        {
+            // Taken under the lock, so the records of concurrent publishers stay in time order.
+            const auto offset = beginRecord(JournalCodec<Event>::tag,
+                                            std::chrono::steady_clock::now() - m_start);
+            JournalCodec<Event>::write(writer, event);
+            endRecord(offset);
+        }
+        m_recorded += events.size();
+        if (m_buffer.size() >= flushThreshold)
+        {
+            writeBuffer();
+        }
+    }
+
+    /** @brief Appends a record header, returns its offset. Requires m_mutex. */
+    auto beginRecord(uint16_t tag, std::chrono::nanoseconds timestamp) -> std::size_t;
+    /** @brief Fills in the payload size of the record at @p offset. Requires m_mutex. */
+    void endRecord(std::size_t offset);
+    /** @brief Requires m_mutex. */
+    void writeBuffer();
+
+    Core::IEventBroker& m_broker;
+    const std::chrono::steady_clock::time_point m_start;
+    mutable std::mutex m_mutex;
+    std::ofstream m_file;
+    std::vector<std::byte> m_buffer;
+    uint64_t m_recorded = 0;
+    std::vector<Core::Connection> m_connections;
+};
+
+/**
+ * @brief Result of a JournalReplayer::replay().
+ */
+struct ReplayStats {
+    /** @brief The number of published events. */
+    uint64_t events = 0;
+    /** @brief The time span of the replayed records, as recorded. */
+    std::chrono::nanoseconds recorded{0};
+    /** @brief The time the replay took. */
+    std::chrono::nanoseconds elapsed{0};
+};
+
+/**
+ * @brief Publishes the events of a journal written by EventJournal.
+ *
+ * @details
+ * Events are published in recorded order and keep the recorded time between them, divided by the
+ * replay speed, so a replay is reproducible apart from the timing of the host. Consecutive events
+ * of the same type that are due are published as one batch, like the bursts they were recorded
+ * from. Records of unknown types are skipped.
+ */
+class JournalReplayer
+{
+   public:
+    /** @brief Replays as fast as the subscribers take the events, ignoring the recorded timing. */
+    static constexpr double maxSpeed = std::numeric_limits<double>::infinity();
+    static constexpr std::size_t maxBatchSize = 256;
+
+    /**
+     * @brief Loads a journal into memory, reading its records directly into m_records.
+     * @throws std::runtime_error If the file can not be read or is not a journal.
+     */
+    explicit JournalReplayer(const std::filesystem::path& path);
+
+    /**
+     * @brief Publishes the journal on the calling thread, blocking until it is done or stopped.
+     * @param broker The broker to publish on.
+     * @param speed The factor the recorded timing is accelerated by, e.g. 1 for real time or
+     * maxSpeed.
+     * @param stop Ends the replay early, also while waiting for the next event.
+     * @throws std::invalid_argument If @p speed is not positive.
+     * @throws std::runtime_error If a record is corrupt, events before it may have been published.
+     */
+    auto replay(Core::IEventBroker& broker, double speed = 1.0, std::stop_token stop = {})
+        -> ReplayStats;
+
+   private:
+    /** @brief The records, without the journal header. */
+    std::vector<std::byte> m_records;
+    /** @brief Payloads of replayed Core::ReceivedCanDbcEvent. */
+    Core::PayloadPool<Core::DbcCanMessage> m_messages;
+};
+
+}  // namespace EventBroker
@@ -0,0 +1,308 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "core/event/can_event.hpp"
+#include "core/event/dbc_event.hpp"
+#include "core/util/payload_pool.hpp"
+
+namespace EventBroker {
+
+static_assert(std::endian::native == std::endian::little,
+              "The journal stores integers in native byte order, which must be little endian.");
+
+/**
+ * @brief Appends the fields of journaled events to a byte buffer.
+ */
+class JournalWriter
+{
+   public:
+    explicit JournalWriter(std::vector<std::byte>& out) : m_out(out) {}
+
+    template <typename Value>
+        requires std::is_arithmetic_v<Value>
+    void value(const Value value)
+    {
+        const auto* bytes = reinterpret_cast<const std::byte*>(&value);
+        m_out.insert(m_out.end(), bytes, bytes + sizeof(Value));
+    }
+
+    /** @brief Writes a string with a 16 bit length, longer strings are truncated. */
+    void string(const std::string_view text)
+    {
+        const auto length = static_cast<uint16_t>(std::min<std::size_t>(text.size(), UINT16_MAX));
+        value(length);
+        const auto* bytes = reinterpret_cast<const std::byte*>(text.data());
+        m_out.insert(m_out.end(), bytes, bytes + length);
+    }
+
+    void bytes(std::span<const char> data)
+    {
+        const auto* bytes = reinterpret_cast<const std::byte*>(data.data());
+        m_out.insert(m_out.end(), bytes, bytes + data.size());
+    }
+
+    /**
+     * @brief Writes a container with a 16 bit element count, like string() longer containers are
+     * truncated, so the count always matches the elements that follow.
+     * @param elements The container.
+     * @param write Writes one element.
+     */
+    template <typename Container, typename Write>
+    void sequence(const Container& elements, Write&& write)
+    {
+        const auto count =
+            static_cast<uint16_t>(std::min<std::size_t>(std::size(elements), UINT16_MAX));
+        value(count);
+        auto element = std::begin(elements);
+        for (uint16_t i = 0; i < count; ++i, ++element)
+        {
+            write(*element);
+        }
+    }
+
+   private:
+    std::vector<std::byte>& m_out;
+};
+
+/**
+ * @brief Reads the fields of journaled events from one record.
+ * @details Reading past the end of the record throws std::runtime_error, so a corrupt journal
+ * never produces events with garbage fields. Decoded CAN messages are taken from the pool of the
+ * reader, so replayed events share their payload like live ones.
+ */
+class JournalReader
+{
+   public:
+    explicit JournalReader(Core::PayloadPool<Core::DbcCanMessage>& messages) : m_messages(messages)
+    {
+    }
+
+    /** @brief Starts reading the next record. */
+    void reset(std::span<const std::byte> record)
+    {
+        m_data = record;
+    }
+
+    template <typename Value>
+        requires std::is_arithmetic_v<Value>
+    auto value() -> Value
+    {
+        Value value;
+        std::memcpy(&value, take(sizeof(Value)).data(), sizeof(Value));
+        return value;
+    }
+
+    auto string() -> std::string
+    {
+        std::string text;
+        string(text);
+        return text;
+    }
+
+    /** @brief Reads a string into @p text, reusing its capacity. */
+    void string(std::string& text)
+    {
+        const auto data = take(value<uint16_t>());
+        text.assign(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+
+    void bytes(std::span<char> out)
+    {
+        std::memcpy(out.data(), take(out.size()).data(), out.size());
+    }
+
+    auto messages() -> Core::PayloadPool<Core::DbcCanMessage>&
+    {
+        return m_messages;
+    }
+
+   private:
+    auto take(const std::size_t size) -> std::span<const std::byte>
+    {
+        if (size > m_data.size())
+        {
+            throw std::runtime_error("Event journal record is truncated");
+        }
+        const auto data = m_data.first(size);
+        m_data = m_data.subspan(size);
+        return data;
+    }
+
+    Core::PayloadPool<Core::DbcCanMessage>& m_messages;
+    std::span<const std::byte> m_data;
+};
+
+/**
+ * @brief Serializer of an event type for the event journal.
+ * @details A specialization provides a `tag` that identifies the type in the journal and must
+ * never change once journals were written, a `write(JournalWriter&, const Event&)` and a
+ * `read(JournalReader&) -> Event`. Only specialized types can be recorded.
+ * @tparam Event The event structure type.
+ */
+template <typename Event>
+struct JournalCodec;
+
+/** @brief An event type with a JournalCodec. */
+template <typename Event>
+concept JournaledEvent = requires(JournalWriter& writer, JournalReader& reader, const Event& e) {
+    { JournalCodec<Event>::tag } -> std::convertible_to<uint16_t>;
+    JournalCodec<Event>::write(writer, e);
+    { JournalCodec<Event>::read(reader) } -> std::same_as<Event>;
+};
+
+namespace Journal {
+
+inline void writeMessage(JournalWriter& out, const Core::RawCanMessage& message)
+{
+    out.value<int64_t>(message.receiveTime);
+    out.value(message.messageId);
+    out.value(message.interfaceId);
+    out.value(message.dlc);
+    out.bytes(message.data);
+}
+
+inline auto readMessage(JournalReader& in) -> Core::RawCanMessage
+{
+    Core::RawCanMessage message{};
+    message.receiveTime = static_cast<std::time_t>(in.value<int64_t>());
+    message.messageId = in.value<uint32_t>();
+    message.interfaceId = in.value<Core::InterfaceId>();
+    message.dlc = in.value<uint8_t>();
+    in.bytes(message.data);
+    return message;
+}
+
+inline void writeMessage(JournalWriter& out, const Core::DbcCanMessage& message)
+{
+    out.value<int64_t>(message.receiveTime);
+    out.value(message.messageId);
+    out.value(message.interfaceId);
+    out.sequence(message.signalValues, [&out](const Core::DbcCanSignal& signal) -> void {
+        out.string(signal.name);
+        out.value(signal.value);
+    });
+}
+
+/** @brief Reads into @p message, reusing the capacity of its signal vector. */
+inline void readMessage(JournalReader& in, Core::DbcCanMessage& message)
+{
+    message.receiveTime = static_cast<std::time_t>(in.value<int64_t>());
+    message.messageId = in.value<uint32_t>();
+    message.interfaceId = in.value<Core::InterfaceId>();
+    message.signalValues.resize(in.value<uint16_t>());
+    for (auto& signal : message.signalValues)
+    {
+        in.string(signal.name);
+        signal.value = in.value<double>();
+    }
+}
+
+}  // namespace Journal
+
+template <>
+struct JournalCodec<Core::ReceivedCanRawEvent> {
+    static constexpr uint16_t tag = 1;
+
+    static void write(JournalWriter& out, const Core::ReceivedCanRawEvent& event)
+    {
+        Journal::writeMessage(out, event.canMessage);
+    }
+
+    static auto read(JournalReader& in) -> Core::ReceivedCanRawEvent
+    {
+        Core::ReceivedCanRawEvent event;
+        event.canMessage = Journal::readMessage(in);
+        return event;
+    }
+};
+
+template <>
+struct JournalCodec<Core::ReceivedCanDbcEvent> {
+    static constexpr uint16_t tag = 2;
+
+    static void write(JournalWriter& out, const Core::ReceivedCanDbcEvent& event)
+    {
+        Journal::writeMessage(out, *event.canMessage);
+    }
+
+    static auto read(JournalReader& in) -> Core::ReceivedCanDbcEvent
+    {
+        Core::ReceivedCanDbcEvent event;
+        event.canMessage = in.messages().acquire();
+        Journal::readMessage(in, event.canMessage.edit());
+        return event;
+    }
+};
+
+template <>
+struct JournalCodec<Core::SendCanMessageRawEvent> {
+    static constexpr uint16_t tag = 3;
+
+    static void write(JournalWriter& out, const Core::SendCanMessageRawEvent& event)
+    {
+        Journal::writeMessage(out, event.canMessage);
+    }
+
+    static auto read(JournalReader& in) -> Core::SendCanMessageRawEvent
+    {
+        Core::SendCanMessageRawEvent event;
+        event.canMessage = Journal::readMessage(in);
+        return event;
+    }
+};
+
+template <>
+struct JournalCodec<Core::SendCanMessageDbcEvent> {
+    static constexpr uint16_t tag = 4;
+
+    static void write(JournalWriter& out, const Core::SendCanMessageDbcEvent& event)
+    {
+        Journal::writeMessage(out, event.canMessage);
+    }
+
+    static auto read(JournalReader& in) -> Core::SendCanMessageDbcEvent
+    {
+        Core::SendCanMessageDbcEvent event;
+        Journal::readMessage(in, event.canMessage);
+        return event;
+    }
+};
+
+template <>
+struct JournalCodec<Core::ParseDBCRequestEvent> {
+    static constexpr uint16_t tag = 5;
+
+    static void write(JournalWriter& out, const Core::ParseDBCRequestEvent& event)
+    {
+        out.string(event.filePath);
+        out.sequence(event.interfaces,
+                     [&out](const std::string& interface) -> void { out.string(interface); });
+    }
+
+    static auto read(JournalReader& in) -> Core::ParseDBCRequestEvent
+    {
+        Core::ParseDBCRequestEvent event;
+        event.filePath = in.string();
+        for (auto count = in.value<uint16_t>(); count > 0; --count)
+        {
+            event.interfaces.push_back(in.string());
+        }
+        return event;
+    }
+};
+
+}  // namespace EventBroker
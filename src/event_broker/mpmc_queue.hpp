@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace EventBroker {
+
+/**
+ * @brief Bounded lock-free multi-producer multi-consumer queue (D. Vyukov's array based
+ * algorithm).
+ *
+ * @details
+ * Every cell carries a sequence number that tells producers and consumers whether the cell is
+ * free for the current round, so neither side ever takes a lock. Producers only contend on one
+ * atomic counter and consumers on another, placed on separate cache lines.
+ *
+ * Pushing fails instead of blocking when the queue is full; what happens then is up to the caller.
+ * Any number of threads may pop at once: the pool threads share one run queue, and producers pop
+ * to evict old entries of a full mailbox.
+ *
+ * @tparam T The element type, must be default constructible and move assignable.
+ */
+template <typename T>
+class BoundedMpmcQueue
+{
+   public:
+    /**
+     * @brief Creates the queue.
+     * @param capacity Number of elements, rounded up to the next power of two (at least 2).
+     */
+    explicit BoundedMpmcQueue(const std::size_t capacity)
+        : m_capacity(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity)),
+          m_mask(m_capacity - 1),
+          m_cells(std::make_unique<Cell[]>(m_capacity))
+    {
+        for (std::size_t i = 0; i < m_capacity; ++i)
+        {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedMpmcQueue(const BoundedMpmcQueue&) = delete;
+    auto operator=(const BoundedMpmcQueue&) -> BoundedMpmcQueue& = delete;
+
+    /**
+     * @brief Appends an element.
+     * @param value The element, only moved from if the push succeeds.
+     * @return False if the queue is full.
+     */
+    auto tryPush(T&& value) -> bool
+    {
+        auto position = m_enqueuePosition.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            auto& cell = m_cells[position & m_mask];
+            const auto sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto difference =
+                static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (difference == 0)
+            {
+                if (m_enqueuePosition.compare_exchange_weak(position, position + 1,
+                                                            std::memory_order_relaxed))
+                {
+                    cell.value = std::move(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = m_enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Removes the oldest element.
+     * @param out Receives the element.
+     * @return False if the queue is empty.
+     */
+    auto tryPop(T& out) -> bool
+    {
+        auto position = m_dequeuePosition.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            auto& cell = m_cells[position & m_mask];
+            const auto sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto difference =
+                static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+            if (difference == 0)
+            {
+                if (m_dequeuePosition.compare_exchange_weak(position, position + 1,
+                                                            std::memory_order_relaxed))
+                {
+                    out = std::move(cell.value);
+                    cell.value = T();
+                    cell.sequence.store(position + m_capacity, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = m_dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the number of queued elements.
+     * @details Only a snapshot while producers or consumers are active.
+     */
+    [[nodiscard]] auto sizeApprox() const -> std::size_t
+    {
+        const auto enqueued = m_enqueuePosition.load(std::memory_order_relaxed);
+        const auto dequeued = m_dequeuePosition.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    [[nodiscard]] auto capacity() const -> std::size_t
+    {
+        return m_capacity;
+    }
+
+   private:
+    static constexpr std::size_t cacheLineSize = 64;
+
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    const std::size_t m_capacity;
+    const std::size_t m_mask;
+    const std::unique_ptr<Cell[]> m_cells;
+
+    alignas(cacheLineSize) std::atomic<std::size_t> m_enqueuePosition{0};
+    alignas(cacheLineSize) std::atomic<std::size_t> m_dequeuePosition{0};
+};
+
+}  // namespace EventBroker
@@ -1,6 +1,7 @@
 //
 #pragma once
 
+#include <QTimer>
 #include <memory>
 
 // Core Interfaces
@@ -9,8 +10,9 @@
 
 // MVD Classes
 #include "core/dto/can_dto.hpp"
-#include "core/dto/dbc_dto.hpp"
+#include "core/util/flat_dbc_config.hpp"
 #include "logging/delegate/logging_delegate.hpp"
+#include "logging/model/csv_exporter.hpp"
 #include "logging/model/logging_model.hpp"
 #include "logging/view/logging_view.hpp"
 
@@ -73,11 +75,16 @@ class LoggingComponent final : public Core::ITabComponent
     /**
      * @brief Signal emitted when a new DBC configuration is available.
      * The Delegate will connect to this.
+     * @param config The shared configuration, receivers keep the pointer instead of a copy.
      */
-    void dbcConfigurationChanged(const Core::DbcConfig& config);
+    void dbcConfigurationChanged(const Core::DbcConfigPtr& config);
 
-    /** @brief Signal to model to record a raw hexadecimal frame */
-    void receiveRawFrame(const Core::RawCanMessage& message);
+    /**
+     * @brief Signal to model to record a burst of raw hexadecimal frames.
+     * @details The raw subscription is a batch subscription, so a receive burst crosses into the
+     * model with one signal.
+     */
+    void receiveRawFrames(const std::vector<Core::RawCanMessage>& messages);
 
     /** @brief Signal to delegate to record decoded DBC signal values */
     void receiveDbcSignals(const Core::DbcCanMessage& message);
@@ -93,7 +100,9 @@ class LoggingComponent final : public Core::ITabComponent
 
     /**
      * @brief Activates Broker subscriptions.
-     * Depending on user selection, it connects to Raw, DBC, or both.
+     * Depending on user selection, it connects to Raw, DBC, or both. The subscriptions are made
+     * with Core::SubscriptionOptions::lossless(), so a log never misses a frame even though the
+     * GUI thread drops old frames for views that fall behind.
      */
     void startLogging();
 
@@ -104,12 +113,24 @@ class LoggingComponent final : public Core::ITabComponent
     void stopLogging();
 
     /**
-     * @brief Performs the actual file writing.
+     * @brief Starts exporting a session to CSV in the background.
+     * @details A CsvExporter streams the session file to the CSV file on its own threads, so the
+     * GUI stays responsive however long the session is. Its progress is polled by m_exportTimer
+     * and shown in the view, which can cancel it. Only one export runs at a time.
      * @param sessionId Unique ID of the log to export.
      * @param filePath Destination on the disk (from Delegate's file dialog).
      */
     void exportLogSession(const QString& sessionId, const QString& filePath);
 
+    /** @brief Cancels the running export, triggered by the view. */
+    void cancelExport();
+
+    /**
+     * @brief Polls the running export and shows its progress.
+     * @details Once it ended, reports a failure and releases the exporter.
+     */
+    void onExportTimer();
+
     /**
      * @brief Triggered by the Delegate -> View when "Details" is clicked.
      * Fetches data from Model, builds the detail widget, and tells View to swap stack.
@@ -117,14 +138,10 @@ class LoggingComponent final : public Core::ITabComponent
     void onDetailRequested(const QModelIndex& index);
 
    private:
-    /**
-     * @brief The actual CSV "Instance" logic.
-     * Logic for iterating through the Model's data and writing to the stream.
-     */
-    bool writeToCsv(const QString& sessionId, const QString& filePath);
-
     /**
      * @brief Helper to generate the detail widget for a specific session.
+     * @details The frames are read from the session file with SessionReader::readAll() into
+     * LogEntry records and a SignalStore, and only formatted as text for the visible rows.
      */
     QWidget* createDetailWidget(const LogSession* session);
 
@@ -134,6 +151,19 @@ class LoggingComponent final : public Core::ITabComponent
     /** @brief Ownership of the Composite View. */
     std::unique_ptr<LoggingView> m_view;
 
+    /**
+     * @brief The current DBC, passed to exports.
+     * @details Signals with value descriptions (VAL_) are exported as their enum text, if the
+     * session was decoded with this DBC.
+     */
+    Core::DbcConfigPtr m_dbc;
+
+    /** @brief The running CSV export, null if none. */
+    std::unique_ptr<CsvExporter> m_export;
+
+    /** @brief Polls m_export while it runs. */
+    QTimer* m_exportTimer = nullptr;
+
     /** @brief RAII Handle for raw message reveived event subscription. */
     Core::Connection m_rawMsgConn;
 
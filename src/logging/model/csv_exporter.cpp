@@ -0,0 +1,417 @@
+#include "csv_exporter.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace Logging {
+
+namespace {
+
+constexpr std::string_view csvHeader = "Timestamp,Interface,ID,DLC,Data,Signal,Value\n";
+/** @brief Timestamp, interface and ID with their separators. */
+constexpr std::size_t maxPrefixSize = 64;
+/** @brief DLC, data and the separators up to the end of a raw row. */
+constexpr std::size_t maxRawFieldsSize = 32;
+/** @brief Longest shortest representation of a double is 24 characters. */
+constexpr std::size_t maxNumberSize = 32;
+constexpr std::size_t initialTextSize = 1024 * 1024;
+constexpr int64_t nanosecondsPerSecond = 1'000'000'000;
+constexpr std::string_view hexDigits = "0123456789ABCDEF";
+
+auto writeTimestamp(char* out, const int64_t timestamp) -> char*
+{
+    auto seconds = timestamp / nanosecondsPerSecond;
+    auto fraction = timestamp % nanosecondsPerSecond;
+    if (fraction < 0)
+    {
+        fraction += nanosecondsPerSecond;
+        --seconds;
+    }
+    out = std::to_chars(out, out + 24, seconds).ptr;
+    *out++ = '.';
+    for (int digit = 8; digit >= 0; --digit)
+    {
+        out[digit] = static_cast<char>('0' + fraction % 10);
+        fraction /= 10;
+    }
+    return out + 9;
+}
+
+auto writeId(char* out, const uint32_t id) -> char*
+{
+    *out++ = '0';
+    *out++ = 'x';
+    const auto* end = std::to_chars(out, out + 8, id, 16).ptr;
+    for (; out != end; ++out)
+    {
+        if (*out >= 'a')
+        {
+            *out = static_cast<char>(*out - 'a' + 'A');
+        }
+    }
+    return out;
+}
+
+/** @brief Upper bound of the size of a field written by writeField(). */
+auto escapedSize(const std::string_view text) -> std::size_t
+{
+    return 2 * text.size() + 2;
+}
+
+/** @brief Writes a text field, quoted if it contains a separator, quote or line break. */
+auto writeField(char* out, const std::string_view text) -> char*
+{
+    if (text.find_first_of(",\"\r\n") == std::string_view::npos)
+    {
+        return std::copy(text.begin(), text.end(), out);
+    }
+    *out++ = '"';
+    for (const auto c : text)
+    {
+        if (c == '"')
+        {
+            *out++ = '"';
+        }
+        *out++ = c;
+    }
+    *out++ = '"';
+    return out;
+}
+
+/**
+ * @brief Formats the frames of session file chunks as CSV rows, one instance per worker thread.
+ */
+class ChunkFormatter
+{
+   public:
+    ChunkFormatter(const SessionReader& reader, const Core::FlatDbcConfig* dbc)
+        : m_reader(reader), m_dbc(dbc)
+    {
+        if (m_dbc)
+        {
+            m_signals.resize(reader.signalNames().size());
+        }
+    }
+
+    /**
+     * @brief Formats the frames of a chunk into the start of @p text, growing it if needed.
+     * @param size Receives the length of the text.
+     * @return The number of rows.
+     */
+    auto format(const std::size_t chunk, std::vector<char>& text, std::size_t& size) -> uint64_t
+    {
+        m_text = &text;
+        m_size = 0;
+        m_rows = 0;
+        m_reader.scan(chunk, FrameQuery{}, m_values,
+                      [this](const LogEntry& entry, const std::span<const SignalValue> values)
+                          -> void { append(entry, values); });
+        size = m_size;
+        return m_rows;
+    }
+
+   private:
+    /** @brief The DBC signal a signal name of the session was last resolved to. */
+    struct ResolvedSignal {
+        bool resolved = false;
+        uint32_t messageId = 0;
+        const Core::FlatDbcSignal* signal = nullptr;
+    };
+
+    void append(const LogEntry& entry, const std::span<const SignalValue> values)
+    {
+        if ((entry.flags & LogEntry::Decoded) == 0)
+        {
+            auto* out = writePrefix(reserve(maxPrefixSize + maxRawFieldsSize), entry);
+            out = std::to_chars(out, out + 3, entry.dlc).ptr;
+            *out++ = ',';
+            const auto dlc = std::min<std::size_t>(entry.dlc, entry.data.size());
+            for (std::size_t i = 0; i < dlc; ++i)
+            {
+                if (i > 0)
+                {
+                    *out++ = ' ';
+                }
+                *out++ = hexDigits[entry.data[i] >> 4];
+                *out++ = hexDigits[entry.data[i] & 0x0F];
+            }
+            commit(out, ",,\n");
+            return;
+        }
+        if (values.empty())
+        {
+            commit(writePrefix(reserve(maxPrefixSize + 4), entry), ",,,\n");
+            return;
+        }
+        for (const auto& value : values)
+        {
+            const auto name = m_reader.signalNames().name(value.signal);
+            const auto description = describe(entry.messageId, value);
+            auto* out = reserve(maxPrefixSize + escapedSize(name) +
+                                std::max(escapedSize(description), maxNumberSize) + 4);
+            out = writePrefix(out, entry);
+            *out++ = ',';
+            *out++ = ',';
+            out = writeField(out, name);
+            *out++ = ',';
+            out = description.empty() ? std::to_chars(out, out + maxNumberSize, value.value).ptr
+                                      : writeField(out, description);
+            commit(out, "\n");
+        }
+    }
+
+    /** @brief Writes timestamp, interface and ID, each followed by a separator. */
+    static auto writePrefix(char* out, const LogEntry& entry) -> char*
+    {
+        out = writeTimestamp(out, entry.timestamp);
+        *out++ = ',';
+        out = std::to_chars(out, out + 3, entry.interfaceId).ptr;
+        *out++ = ',';
+        out = writeId(out, entry.messageId);
+        *out++ = ',';
+        return out;
+    }
+
+    /** @brief Returns the value description of a value, empty without DBC or description. */
+    auto describe(const uint32_t messageId, const SignalValue& value) -> std::string_view
+    {
+        if (!m_dbc)
+        {
+            return {};
+        }
+        // A signal name nearly always belongs to one message, so the lookup is done once.
+        auto& cached = m_signals[value.signal];
+        if (!cached.resolved || cached.messageId != messageId)
+        {
+            cached = {true, messageId,
+                      m_dbc->findSignal(messageId, m_reader.signalNames().name(value.signal))};
+        }
+        return cached.signal ? m_dbc->describeValue(*cached.signal, value.value)
+                             : std::string_view();
+    }
+
+    /** @brief Makes room for a row of at most @p size characters and returns where it starts. */
+    auto reserve(const std::size_t size) -> char*
+    {
+        auto& text = *m_text;
+        if (text.size() - m_size < size)
+        {
+            text.resize(std::max({initialTextSize, 2 * text.size(), m_size + size}));
+        }
+        return text.data() + m_size;
+    }
+
+    /** @brief Ends the row at @p out with @p end. */
+    void commit(char* out, const std::string_view end)
+    {
+        out = std::copy(end.begin(), end.end(), out);
+        m_size = static_cast<std::size_t>(out - m_text->data());
+        ++m_rows;
+    }
+
+    const SessionReader& m_reader;
+    const Core::FlatDbcConfig* m_dbc;
+    std::vector<SignalValue> m_values;
+    /** @brief Signal handle of the session -> its DBC signal, only with a DBC. */
+    std::vector<ResolvedSignal> m_signals;
+    std::vector<char>* m_text = nullptr;
+    std::size_t m_size = 0;
+    uint64_t m_rows = 0;
+};
+
+}  // namespace
+
+auto CsvExporter::defaultThreads() -> std::size_t
+{
+    const auto cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 1;
+}
+
+CsvExporter::CsvExporter(const std::filesystem::path& sessionFile, std::filesystem::path csvFile,
+                         Core::DbcConfigPtr dbc, const std::size_t threads)
+    : m_reader(sessionFile),
+      m_csvFile(std::move(csvFile)),
+      m_dbc(dbc && dbc->contentHash() == m_reader.metadata().dbcHash ? std::move(dbc) : nullptr),
+      m_threads(std::max<std::size_t>(threads, 1)),
+      m_file(m_csvFile, std::ios::binary | std::ios::trunc),
+      m_slots(2 * m_threads)
+{
+    if (!m_file)
+    {
+        throw std::runtime_error("Can not create CSV file " + m_csvFile.string());
+    }
+    m_thread = std::jthread([this](const std::stop_token& stop) -> void { run(stop); });
+}
+
+CsvExporter::~CsvExporter()
+{
+    cancel();
+}
+
+auto CsvExporter::progress() const -> CsvExportProgress
+{
+    return {m_state, m_frames, m_reader.summary().frames, m_rows, m_bytes};
+}
+
+void CsvExporter::cancel()
+{
+    m_thread.request_stop();
+}
+
+auto CsvExporter::wait() -> CsvExportProgress
+{
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+    if (m_state == CsvExportState::Failed)
+    {
+        std::rethrow_exception(m_error);
+    }
+    return progress();
+}
+
+void CsvExporter::run(const std::stop_token& stop)
+{
+    auto state = CsvExportState::Failed;
+    try
+    {
+        m_file.write(csvHeader.data(), static_cast<std::streamsize>(csvHeader.size()));
+        m_bytes = csvHeader.size();
+        bool completed = false;
+        {
+            std::vector<std::jthread> workers;
+            try
+            {
+                for (std::size_t i = 0; i < m_threads; ++i)
+                {
+                    workers.emplace_back([this]() -> void { formatChunks(); });
+                }
+                completed = writeChunks(stop);
+            }
+            catch (...)
+            {
+                stopWorkers();
+                throw;
+            }
+            stopWorkers();
+        }
+        m_file.close();
+        if (!m_file)
+        {
+            throw std::runtime_error("Writing the CSV file " + m_csvFile.string() + " failed");
+        }
+        state = completed ? CsvExportState::Finished : CsvExportState::Cancelled;
+    }
+    catch (...)
+    {
+        std::lock_guard lock(m_mutex);
+        if (!m_error)
+        {
+            m_error = std::current_exception();
+        }
+    }
+
+    if (state != CsvExportState::Finished)
+    {
+        m_file.close();
+        std::error_code error;
+        std::filesystem::remove(m_csvFile, error);
+    }
+    m_state = state;
+}
+
+auto CsvExporter::writeChunks(const std::stop_token& stop) -> bool
+{
+    const auto chunks = m_reader.chunks();
+    for (std::size_t chunk = 0; chunk < chunks.size(); ++chunk)
+    {
+        auto& slot = m_slots[chunk % m_slots.size()];
+        {
+            std::unique_lock lock(m_mutex);
+            if (!m_wakeup.wait(lock, stop,
+                               [this, &slot]() -> bool { return slot.ready || m_stopping; }))
+            {
+                return false;
+            }
+            if (!slot.ready)
+            {
+                std::rethrow_exception(m_error);
+            }
+        }
+
+        m_file.write(slot.text.data(), static_cast<std::streamsize>(slot.size));
+        if (!m_file)
+        {
+            throw std::runtime_error("Writing the CSV file " + m_csvFile.string() + " failed");
+        }
+        m_frames += chunks[chunk].frames;
+        m_rows += slot.rows;
+        m_bytes += slot.size;
+
+        {
+            std::lock_guard lock(m_mutex);
+            slot.ready = false;
+            ++m_writtenChunks;
+        }
+        m_wakeup.notify_all();
+    }
+    return true;
+}
+
+void CsvExporter::formatChunks()
+{
+    ChunkFormatter formatter(m_reader, m_dbc.get());
+    const auto chunks = m_reader.chunks().size();
+    std::unique_lock lock(m_mutex);
+    while (true)
+    {
+        // A chunk is only claimed once the chunk that used its slot before was written.
+        m_wakeup.wait(lock, [this, chunks]() -> bool {
+            return m_stopping ||
+                   (m_nextChunk < chunks && m_nextChunk < m_writtenChunks + m_slots.size());
+        });
+        if (m_stopping)
+        {
+            return;
+        }
+        const auto chunk = m_nextChunk++;
+        auto& slot = m_slots[chunk % m_slots.size()];
+        lock.unlock();
+
+        try
+        {
+            slot.rows = formatter.format(chunk, slot.text, slot.size);
+        }
+        catch (...)
+        {
+            lock.lock();
+            if (!m_error)
+            {
+                m_error = std::current_exception();
+            }
+            m_stopping = true;
+            m_wakeup.notify_all();
+            return;
+        }
+
+        lock.lock();
+        slot.ready = true;
+        m_wakeup.notify_all();
+    }
+}
+
+void CsvExporter::stopWorkers()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeup.notify_all();
+}
+
+}  // namespace Logging
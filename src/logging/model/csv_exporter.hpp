@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include "core/util/flat_dbc_config.hpp"
+#include "logging/model/session_file.hpp"
+
+namespace Logging {
+
+enum class CsvExportState : uint8_t { Running, Finished, Cancelled, Failed };
+
+/**
+ * @brief Progress of a CsvExporter, counted per written chunk of the session file.
+ */
+struct CsvExportProgress {
+    CsvExportState state = CsvExportState::Running;
+    uint64_t frames = 0;
+    uint64_t totalFrames = 0;
+    uint64_t rows = 0;
+    uint64_t bytes = 0;
+};
+
+/**
+ * @brief Exports a session file as CSV on background threads.
+ *
+ * @details
+ * The chunks of the session file are formatted in parallel by a pool of worker threads, each into
+ * a text buffer of its own, and written to the CSV file in order by the export thread with one
+ * large write per chunk. Numbers are formatted with std::to_chars. The buffers of at most
+ * twice as many chunks as there are workers are kept and reused, so memory stays bounded and no
+ * allocations happen once they have grown to the largest chunk.
+ *
+ * A raw frame is one row, a decoded frame one row per signal value:
+ * @code
+ * Timestamp,Interface,ID,DLC,Data,Signal,Value
+ * 1700000000.000000000,0,0x123,8,01 02 03 04 05 06 07 08,,
+ * 1700000000.000000000,1,0x100,,,EngineSpeed,2100.5
+ * @endcode
+ * Values with a value description (VAL_) are written as their text, if the session was decoded
+ * with the given DBC, see SessionMetadata::dbcHash.
+ *
+ * A cancelled or failed export removes the incomplete CSV file.
+ */
+class CsvExporter
+{
+   public:
+    /** @brief The number of worker threads that leaves one core to the export thread. */
+    static auto defaultThreads() -> std::size_t;
+
+    /**
+     * @brief Opens the session, creates the CSV file and starts exporting.
+     * @param dbc Resolves value descriptions, may be null.
+     * @param threads The number of worker threads, at least one.
+     * @throws std::runtime_error If the session can not be read or the CSV file not created.
+     */
+    CsvExporter(const std::filesystem::path& sessionFile, std::filesystem::path csvFile,
+                Core::DbcConfigPtr dbc, std::size_t threads = defaultThreads());
+
+    /** @brief Cancels the export if it is still running and waits for its threads. */
+    ~CsvExporter();
+
+    CsvExporter(const CsvExporter&) = delete;
+    auto operator=(const CsvExporter&) -> CsvExporter& = delete;
+
+    /** @brief Returns the progress, can be polled from any thread, e.g. by a GUI timer. */
+    [[nodiscard]] auto progress() const -> CsvExportProgress;
+
+    /** @brief Requests the export to stop, it ends in CsvExportState::Cancelled. */
+    void cancel();
+
+    /**
+     * @brief Waits until the export has ended.
+     * @return The final progress.
+     * @throws std::exception The error the export failed with.
+     */
+    auto wait() -> CsvExportProgress;
+
+   private:
+    /** @brief Formatted text of a chunk. */
+    struct Slot {
+        /** @brief Grows to the largest chunk, only the first size bytes are valid. */
+        std::vector<char> text;
+        std::size_t size = 0;
+        uint64_t rows = 0;
+        bool ready = false;
+    };
+
+    /** @brief The export thread. */
+    void run(const std::stop_token& stop);
+    /** @brief Writes the formatted chunks in order, returns false if cancelled. */
+    auto writeChunks(const std::stop_token& stop) -> bool;
+    /** @brief A worker thread, formats chunks until all are claimed or the export stops. */
+    void formatChunks();
+    /** @brief Makes the worker threads return. */
+    void stopWorkers();
+
+    const SessionReader m_reader;
+    const std::filesystem::path m_csvFile;
+    /** @brief Null unless the session was decoded with it. */
+    const Core::DbcConfigPtr m_dbc;
+    const std::size_t m_threads;
+    std::ofstream m_file;
+
+    // Shared between the export thread and the workers.
+    std::mutex m_mutex;
+    std::condition_variable_any m_wakeup;
+    /** @brief Chunk i is formatted into m_slots[i % m_slots.size()]. */
+    std::vector<Slot> m_slots;
+    std::size_t m_nextChunk = 0;
+    std::size_t m_writtenChunks = 0;
+    bool m_stopping = false;
+    std::exception_ptr m_error;
+
+    std::atomic<CsvExportState> m_state = CsvExportState::Running;
+    std::atomic<uint64_t> m_frames = 0;
+    std::atomic<uint64_t> m_rows = 0;
+    std::atomic<uint64_t> m_bytes = 0;
+
+    std::jthread m_thread;
+};
+
+}  // namespace Logging
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include "core/dto/can_dto.hpp"
+
+namespace Logging {
+
+/**
+ * @struct LogEntry
+ * @brief A captured CAN frame as read back from a session file for the detail view and export.
+ *
+ * @details
+ * A fixed size record without heap allocations, so millions of them fit into one vector. The
+ * decoded signal values of a frame are not part of the entry, they are kept by signal in a
+ * SignalStore. Timestamps and payloads are only formatted to text when they are displayed or
+ * exported.
+ */
+struct LogEntry {
+    enum Flags : uint8_t {
+        /** @brief The frame was decoded with a DBC, its signal values are in a SignalStore. */
+        Decoded = 1 << 0
+    };
+
+    /** @brief Receive time in nanoseconds since the epoch. */
+    int64_t timestamp = 0;
+    uint32_t messageId = 0;
+    Core::InterfaceId interfaceId = 0;
+    /** @brief Combination of Flags. */
+    uint8_t flags = 0;
+    /** @brief Number of valid bytes in data, zero for decoded frames. */
+    uint8_t dlc = 0;
+    std::array<uint8_t, 8> data{};
+};
+
+static_assert(sizeof(LogEntry) == 24, "LogEntry is meant to stay a compact fixed size record.");
+static_assert(std::is_trivially_copyable_v<LogEntry>);
+
+}  // namespace Logging
@@ -3,28 +3,21 @@
 #include <QAbstractTableModel>
 #include <QDateTime>
 #include <QString>
-#include <map>
+#include <filesystem>
+#include <memory>
 #include <vector>
 
 #include "core/dto/can_dto.hpp"
+#include "core/util/flat_dbc_config.hpp"
+#include "logging/model/log_entry.hpp"
+#include "logging/model/session_file.hpp"
 
 namespace Logging {
 
-/** * @struct LogEntry
- * @brief Represents a single captured CAN frame or decoded message.
- */
-struct LogEntry {
-    uint32_t messageId;
-    QString timestamp;
-
-    /** @brief Decoded signal values (DBC mode). Example: {"EngineTemp": 90.5} */
-    std::map<std::string, double> signalValues;
-    /** @brief Raw hex bytes (Raw mode). */
-    std::vector<uint8_t> rawData;
-};
-
 /** * @struct LogSession
- * @brief Represents a complete recording period with metadata and captured data.
+ * @brief Represents a complete recording period with metadata and the location of its data.
+ * @details The frames themselves are only in the session file, so a session takes the same memory
+ * however long it is recorded.
  */
 struct LogSession {
     QString id;
@@ -32,7 +25,18 @@ struct LogSession {
     QString duration;
     bool isRecording = false;
     QString deviceName;
-    std::vector<LogEntry> entries;
+    /** @brief The session file the frames are streamed to, see SessionWriter. */
+    std::filesystem::path file;
+    /** @brief Core::FlatDbcConfig::contentHash() of the DBC the session was decoded with. */
+    uint64_t dbcHash = 0;
+    /** @brief Totals for the history table, refreshed while recording. */
+    SessionSummary summary;
+    /**
+     * @brief Index of the chunks of the file, complete once the session is stopped.
+     * @details Empty for sessions loaded by LoggingModel::loadHistory(), a SessionReader reads it
+     * from the file when the session is opened.
+     */
+    std::vector<SessionChunk> chunks;
 };
 
 /**
@@ -40,6 +44,8 @@ struct LogSession {
  * @brief The central data authority for the Logging module.
  * * @details
  * This model manages the lifecycle of logging sessions. It acts as a, list and data provider.
+ * Frames of the active session are streamed to its session file by a SessionWriter, which
+ * encodes them on the GUI thread and writes full chunks on its own thread.
  */
 class LoggingModel final : public QAbstractTableModel
 {
@@ -62,7 +68,12 @@ class LoggingModel final : public QAbstractTableModel
         Col_MAX
     };
 
-    explicit LoggingModel(QObject* parent = nullptr);
+    /**
+     * @param sessionDirectory The directory session files are created in, created if missing.
+     * The sessions already in it are listed, see loadHistory().
+     */
+    explicit LoggingModel(std::filesystem::path sessionDirectory, QObject* parent = nullptr);
+    ~LoggingModel() override;
 
     int rowCount(const QModelIndex& parent = QModelIndex()) const override;
     int columnCount(const QModelIndex& parent = QModelIndex()) const override;
@@ -70,12 +81,6 @@ class LoggingModel final : public QAbstractTableModel
     QVariant headerData(int section, Qt::Orientation orientation,
                         int role = Qt::DisplayRole) const override;
 
-    /**
-     * @brief Appends data to the current recording.
-     * @param entry The captured CAN data or decoded signals.
-     */
-    void appendEntry(const LogEntry& entry);
-
     /**
      * @brief Fetches a session by its unique ID.
      */
@@ -91,21 +96,47 @@ class LoggingModel final : public QAbstractTableModel
      */
     [[nodiscard]] bool isRecording() const;
 
+    /**
+     * @brief Lists the session files of the session directory in the history table.
+     * @details Uses listSessionFiles(), which reads only header and footer of each file. Replaces
+     * all sessions but the active one, which stays the last row.
+     */
+    void loadHistory();
+
    public slots:
     /** @brief Triggered by Component's bridge signal */
     void onRawFrameReceived(const Core::RawCanMessage& msg);
 
+    /**
+     * @brief Triggered by Component's bridge signal with a burst of frames
+     * @details The burst is handed to the SessionWriter and the entry count of the active session
+     * is updated with a single dataChanged() for the whole burst.
+     */
+    void onRawFramesReceived(const std::vector<Core::RawCanMessage>& messages);
+
     /** @brief Triggered by Component's bridge signal */
     void onDbcSignalsReceived(const Core::DbcCanMessage& msg);
 
+    /**
+     * @brief Triggered by Component's dbcConfigurationChanged signal.
+     * @details Keeps only the content hash, it is stored in the metadata of new sessions.
+     */
+    void onDbcConfigurationChanged(const Core::DbcConfigPtr& config);
+
     /**
      * @brief Creates a new session and sets it as the active target for data.
+     * @details Opens the session file, named after the session ID with
+     * SessionFormat::extension, and starts its writer thread. The SessionMetadata of the file
+     * holds the ID, the device, the start time and the hash of the current DBC. If the file can
+     * not be created, no session is started.
      * @param deviceName The hardware interface used for this session.
      */
     void startNewSession(const QString& deviceName);
 
     /**
      * @brief Finalizes the active session, locking it for export.
+     * @details Closes the SessionWriter, which writes the pending chunks and the footer index, and
+     * keeps its summary and chunk index in the session.
      */
     void stopActiveSession();
 
@@ -113,8 +144,16 @@ class LoggingModel final : public QAbstractTableModel
     /** @brief Updates the duration string of the active session based on current time. */
     void updateActiveDuration();
 
+    /** @brief Copies the writer's summary into the active session and emits dataChanged(). */
+    void updateActiveSummary();
+
+    std::filesystem::path m_sessionDirectory;
+    /** @brief Content hash of the current DBC, zero without one. */
+    uint64_t m_dbcHash = 0;
     std::vector<LogSession> m_sessions;
     int m_activeSessionIndex = -1;
+    /** @brief Writes the frames of the active session, null while not recording. */
+    std::unique_ptr<SessionWriter> m_writer;
 };
 
 }  // namespace Logging
\ No newline at end of file
@@ -0,0 +1,830 @@
+#include "session_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "core/macro/console_logging.hpp"
+
+namespace Logging {
+
+static_assert(std::endian::native == std::endian::little,
+              "Session files store integers in native byte order, which must be little endian.");
+
+namespace {
+
+/** @brief Kind, interface, CAN ID and timestamp. */
+constexpr std::size_t recordHeaderSize =
+    sizeof(uint8_t) + sizeof(Core::InterfaceId) + sizeof(uint32_t) + sizeof(int64_t);
+/** @brief The header, the DLC and the data bytes. */
+constexpr std::size_t rawRecordSize = recordHeaderSize + sizeof(uint8_t) + 8;
+constexpr std::size_t signalValueSize = sizeof(SignalHandle) + sizeof(double);
+/** @brief Kind, handle and name length, without the name. */
+constexpr std::size_t signalNameSize = sizeof(uint8_t) + sizeof(SignalHandle) + sizeof(uint8_t);
+constexpr std::size_t maxNameLength = UINT8_MAX;
+/** @brief Footer entry of a chunk without its CAN IDs: offset, size, frames, timestamps, count. */
+constexpr std::size_t chunkIndexEntrySize =
+    sizeof(uint64_t) + 2 * sizeof(uint32_t) + 2 * sizeof(int64_t) + sizeof(uint32_t);
+
+template <typename Value>
+void store(std::byte*& out, const Value value)
+{
+    std::memcpy(out, &value, sizeof(Value));
+    out += sizeof(Value);
+}
+
+template <typename Value>
+auto load(const std::byte* data) -> Value
+{
+    Value value;
+    std::memcpy(&value, data, sizeof(Value));
+    return value;
+}
+
+/** @brief Appends @p size bytes to a chunk and returns where to write them. */
+auto extend(std::vector<std::byte>& data, const std::size_t size) -> std::byte*
+{
+    const auto offset = data.size();
+    data.resize(offset + size);
+    return data.data() + offset;
+}
+
+template <typename Value>
+void put(std::vector<std::byte>& data, const Value value)
+{
+    auto* out = extend(data, sizeof(Value));
+    store(out, value);
+}
+
+/** @brief Appends a string with a length of type @p Length, truncating it to fit. */
+template <typename Length>
+void putString(std::vector<std::byte>& data, const std::string_view text)
+{
+    const auto length = std::min<std::size_t>(text.size(), std::numeric_limits<Length>::max());
+    put(data, static_cast<Length>(length));
+    std::memcpy(extend(data, length), text.data(), length);
+}
+
+void storeRecordHeader(std::byte*& out, const SessionFormat::RecordKind kind,
+                       const Core::InterfaceId interfaceId, const uint32_t messageId,
+                       const int64_t timestamp)
+{
+    store(out, static_cast<uint8_t>(kind));
+    store(out, interfaceId);
+    store(out, messageId);
+    store(out, timestamp);
+}
+
+/**
+ * @brief Reads consecutive values from a part of a session file.
+ */
+class ByteReader
+{
+   public:
+    /** @param error Message of the exception thrown when reading past the end. */
+    ByteReader(const std::span<const std::byte> data, const char* error)
+        : m_data(data), m_error(error)
+    {
+    }
+
+    [[nodiscard]] auto atEnd() const -> bool
+    {
+        return m_position == m_data.size();
+    }
+
+    /** @brief The number of bytes read so far. */
+    [[nodiscard]] auto position() const -> std::size_t
+    {
+        return m_position;
+    }
+
+    /** @brief The number of bytes left. */
+    [[nodiscard]] auto remaining() const -> std::size_t
+    {
+        return m_data.size() - m_position;
+    }
+
+    auto take(const std::size_t size) -> const std::byte*
+    {
+        if (size > m_data.size() - m_position)
+        {
+            throw std::runtime_error(m_error);
+        }
+        const auto* data = m_data.data() + m_position;
+        m_position += size;
+        return data;
+    }
+
+    template <typename Value>
+    auto read() -> Value
+    {
+        return load<Value>(take(sizeof(Value)));
+    }
+
+    /** @brief Reads a string with a length of type @p Length. */
+    template <typename Length>
+    auto readString() -> std::string_view
+    {
+        const auto length = read<Length>();
+        return {reinterpret_cast<const char*>(take(length)), length};
+    }
+
+   private:
+    std::span<const std::byte> m_data;
+    std::size_t m_position = 0;
+    const char* m_error;
+};
+
+/**
+ * @brief A signal name assigned by a SignalName record.
+ */
+struct SignalDefinition {
+    SignalHandle signal = 0;
+    std::string_view name;
+};
+
+/**
+ * @brief Reads the next record of a chunk.
+ * @param entry Receives the frame.
+ * @param values Receives the decoded values of a Dbc record, cleared for raw frames.
+ * @param signalCount The number of defined signals, values of other handles are rejected.
+ * @param definition Receives the name assigned by a SignalName record.
+ * @return False for a SignalName record, which is not a frame.
+ * @throws std::runtime_error If the record is corrupt.
+ */
+auto readRecord(ByteReader& in, LogEntry& entry, std::vector<SignalValue>& values,
+                const std::size_t signalCount, SignalDefinition& definition) -> bool
+{
+    const auto kind = static_cast<SessionFormat::RecordKind>(in.read<uint8_t>());
+    if (kind == SessionFormat::RecordKind::SignalName)
+    {
+        definition.signal = in.read<SignalHandle>();
+        definition.name = in.readString<uint8_t>();
+        return false;
+    }
+
+    const auto* header = in.take(recordHeaderSize - 1);
+    entry.interfaceId = load<Core::InterfaceId>(header);
+    entry.messageId = load<uint32_t>(header + 1);
+    entry.timestamp = load<int64_t>(header + 5);
+    values.clear();
+    switch (kind)
+    {
+        case SessionFormat::RecordKind::Raw:
+            entry.flags = 0;
+            entry.dlc = in.read<uint8_t>();
+            if (entry.dlc > entry.data.size())
+            {
+                throw std::runtime_error("Session file frame has an invalid DLC");
+            }
+            std::memcpy(entry.data.data(), in.take(entry.data.size()), entry.data.size());
+            break;
+        case SessionFormat::RecordKind::Dbc:
+            entry.flags = LogEntry::Decoded;
+            entry.dlc = 0;
+            entry.data = {};
+            values.resize(in.read<uint16_t>());
+            for (auto& value : values)
+            {
+                const auto* data = in.take(signalValueSize);
+                value.signal = load<SignalHandle>(data);
+                value.value = load<double>(data + sizeof(SignalHandle));
+                if (value.signal >= signalCount)
+                {
+                    throw std::runtime_error("Session file uses an undefined signal");
+                }
+            }
+            break;
+        default:
+            throw std::runtime_error("Unknown record kind in session file");
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the sorted distinct CAN IDs of the records of a chunk.
+ * @param frames The number of frames the chunk header claims.
+ * @param signals Receives the names the chunk defines and checks the values, if not null.
+ * @throws std::runtime_error If a record is corrupt or the frame count differs.
+ */
+auto indexRecords(const std::span<const std::byte> records, const uint32_t frames,
+                  SignalDictionary* signals) -> std::vector<uint32_t>
+{
+    ByteReader in(records, "Session file record is truncated");
+    LogEntry entry;
+    std::vector<SignalValue> values;
+    SignalDefinition definition;
+    std::vector<uint32_t> ids;
+    uint32_t count = 0;
+    while (!in.atEnd())
+    {
+        const auto signalCount = signals ? signals->size() : SignalDictionary::maxSignals;
+        if (readRecord(in, entry, values, signalCount, definition))
+        {
+            ++count;
+            ids.push_back(entry.messageId);
+        }
+        else if (signals && (definition.signal != signals->size() ||
+                             signals->intern(definition.name) != definition.signal))
+        {
+            throw std::runtime_error("Session file defines a signal out of order");
+        }
+    }
+    if (count != frames)
+    {
+        throw std::runtime_error("Session file chunk has a wrong frame count");
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+}  // namespace
+
+SessionWriter::SessionWriter(const std::filesystem::path& path, const SessionMetadata& metadata)
+    : m_file(path, std::ios::binary | std::ios::trunc)
+{
+    if (!m_file)
+    {
+        throw std::runtime_error("Can not create session file " + path.string());
+    }
+    std::vector<std::byte> header(SessionFormat::magic.size());
+    std::memcpy(header.data(), SessionFormat::magic.data(), SessionFormat::magic.size());
+    put(header, SessionFormat::version);
+    putString<uint16_t>(header, metadata.id);
+    putString<uint16_t>(header, metadata.deviceName);
+    put(header, metadata.startTime);
+    put(header, metadata.dbcHash);
+    m_file.write(reinterpret_cast<const char*>(header.data()),
+                 static_cast<std::streamsize>(header.size()));
+    m_fileSize = header.size();
+    m_bytesWritten = header.size();
+    m_thread = std::jthread([this]() -> void { run(); });
+}
+
+SessionWriter::~SessionWriter()
+{
+    close();
+}
+
+void SessionWriter::append(const std::span<const Core::RawCanMessage> messages)
+{
+    for (const auto& message : messages)
+    {
+        const auto timestamp = SessionFormat::toTimestamp(message.receiveTime);
+        if (!beginRecord(rawRecordSize, timestamp))
+        {
+            continue;
+        }
+        auto* out = extend(m_current->data, rawRecordSize);
+        storeRecordHeader(out, SessionFormat::RecordKind::Raw, message.interfaceId,
+                          message.messageId, timestamp);
+        *out++ = static_cast<std::byte>(std::min<std::size_t>(message.dlc, message.data.size()));
+        std::memcpy(out, message.data.data(), message.data.size());
+    }
+}
+
+void SessionWriter::append(const Core::DbcCanMessage& message)
+{
+    const auto count = std::min<std::size_t>(message.signalValues.size(), UINT16_MAX);
+    std::size_t size = recordHeaderSize + sizeof(uint16_t) + count * signalValueSize;
+    m_newSignals.clear();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto name = std::string_view(message.signalValues[i].name).substr(0, maxNameLength);
+        if (!m_signals.find(name) &&
+            std::find(m_newSignals.begin(), m_newSignals.end(), name) == m_newSignals.end())
+        {
+            m_newSignals.push_back(name);
+            size += signalNameSize + name.size();
+        }
+    }
+
+    if (m_signals.size() + m_newSignals.size() > SignalDictionary::maxSignals)
+    {
+        ++m_dropped;
+        return;
+    }
+    const auto timestamp = SessionFormat::toTimestamp(message.receiveTime);
+    if (!beginRecord(size, timestamp))
+    {
+        return;
+    }
+    auto* out = extend(m_current->data, size);
+    for (const auto name : m_newSignals)
+    {
+        store(out, static_cast<uint8_t>(SessionFormat::RecordKind::SignalName));
+        store(out, m_signals.intern(name));
+        store(out, static_cast<uint8_t>(name.size()));
+        std::memcpy(out, name.data(), name.size());
+        out += name.size();
+    }
+    storeRecordHeader(out, SessionFormat::RecordKind::Dbc, message.interfaceId, message.messageId,
+                      timestamp);
+    store(out, static_cast<uint16_t>(count));
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto& signal = message.signalValues[i];
+        store(out, *m_signals.find(std::string_view(signal.name).substr(0, maxNameLength)));
+        store(out, signal.value);
+    }
+}
+
+void SessionWriter::close()
+{
+    if (std::exchange(m_closed, true))
+    {
+        return;
+    }
+    submit();
+    {
+        std::lock_guard lock(m_mutex);
+        m_closing = true;
+    }
+    m_wakeup.notify_one();
+    m_thread.join();
+    writeFooter();
+    m_file.close();
+    if (!m_file)
+    {
+        std::lock_guard lock(m_mutex);
+        m_failed = true;
+    }
+}
+
+auto SessionWriter::summary() const -> SessionSummary
+{
+    SessionSummary summary{m_frames, m_dropped, 0, m_firstTimestamp, m_lastTimestamp, false};
+    std::lock_guard lock(m_mutex);
+    summary.bytesWritten = m_bytesWritten;
+    summary.failed = m_failed;
+    return summary;
+}
+
+auto SessionWriter::chunks() const -> std::vector<SessionChunk>
+{
+    std::lock_guard lock(m_mutex);
+    return m_chunks;
+}
+
+auto SessionWriter::beginRecord(const std::size_t size, const int64_t timestamp) -> bool
+{
+    if (m_closed)
+    {
+        ++m_dropped;
+        return false;
+    }
+    // An oversized record gets a chunk of its own.
+    if (m_current && m_current->data.size() > SessionFormat::chunkHeaderSize &&
+        m_current->data.size() + size > chunkSize)
+    {
+        submit();
+    }
+    if (!m_current)
+    {
+        std::lock_guard lock(m_mutex);
+        if (!m_free.empty())
+        {
+            m_current = std::move(m_free.back());
+            m_free.pop_back();
+        }
+        else if (m_allocated < maxChunks)
+        {
+            m_current = std::make_unique<Chunk>();
+            m_current->data.reserve(chunkSize);
+            ++m_allocated;
+        }
+        else
+        {
+            ++m_dropped;
+            return false;
+        }
+        m_current->data.resize(SessionFormat::chunkHeaderSize);
+        m_current->frames = 0;
+        m_current->firstTimestamp = timestamp;
+        m_current->lastTimestamp = timestamp;
+    }
+
+    auto& chunk = *m_current;
+    ++chunk.frames;
+    chunk.firstTimestamp = std::min(chunk.firstTimestamp, timestamp);
+    chunk.lastTimestamp = std::max(chunk.lastTimestamp, timestamp);
+    if (m_frames++ == 0)
+    {
+        m_firstTimestamp = timestamp;
+        m_lastTimestamp = timestamp;
+    }
+    m_firstTimestamp = std::min(m_firstTimestamp, timestamp);
+    m_lastTimestamp = std::max(m_lastTimestamp, timestamp);
+    return true;
+}
+
+void SessionWriter::submit()
+{
+    if (!m_current)
+    {
+        return;
+    }
+    auto& chunk = *m_current;
+    auto* out = chunk.data.data();
+    store(out, static_cast<uint32_t>(chunk.data.size() - SessionFormat::chunkHeaderSize));
+    store(out, chunk.frames);
+    store(out, chunk.firstTimestamp);
+    store(out, chunk.lastTimestamp);
+    {
+        std::lock_guard lock(m_mutex);
+        m_pending.push_back(std::move(m_current));
+    }
+    m_wakeup.notify_one();
+}
+
+void SessionWriter::run()
+{
+    std::unique_lock lock(m_mutex);
+    while (true)
+    {
+        m_wakeup.wait(lock, [this]() -> bool { return !m_pending.empty() || m_closing; });
+        if (m_pending.empty())
+        {
+            break;
+        }
+        auto chunk = std::move(m_pending.front());
+        m_pending.pop_front();
+        const bool failed = m_failed;
+
+        lock.unlock();
+        SessionChunk written{m_fileSize,
+                             static_cast<uint32_t>(chunk->data.size() -
+                                                   SessionFormat::chunkHeaderSize),
+                             chunk->frames, chunk->firstTimestamp, chunk->lastTimestamp, {}};
+        if (!failed)
+        {
+            write(*chunk);
+            written.messageIds = indexRecords(
+                std::span(chunk->data).subspan(SessionFormat::chunkHeaderSize), chunk->frames,
+                nullptr);
+        }
+        const bool ok = !failed && m_file;
+        lock.lock();
+
+        if (ok)
+        {
+            m_chunks.push_back(std::move(written));
+            m_bytesWritten = m_fileSize;
+        }
+        else if (!failed)
+        {
+            m_failed = true;
+            LOG_ERR("SessionWriter", "Writing the session file failed, frames are lost.");
+        }
+        m_free.push_back(std::move(chunk));
+    }
+    lock.unlock();
+    m_file.flush();
+}
+
+void SessionWriter::write(Chunk& chunk)
+{
+    m_file.write(reinterpret_cast<const char*>(chunk.data.data()),
+                 static_cast<std::streamsize>(chunk.data.size()));
+    m_fileSize += chunk.data.size();
+}
+
+void SessionWriter::writeFooter()
+{
+    std::lock_guard lock(m_mutex);
+    if (m_failed || !m_file)
+    {
+        return;
+    }
+    std::vector<std::byte> footer;
+    put(footer, m_dropped);
+    put(footer, static_cast<uint32_t>(m_signals.size()));
+    for (std::size_t i = 0; i < m_signals.size(); ++i)
+    {
+        putString<uint8_t>(footer, m_signals.name(static_cast<SignalHandle>(i)));
+    }
+    put(footer, static_cast<uint32_t>(m_chunks.size()));
+    for (const auto& chunk : m_chunks)
+    {
+        put(footer, chunk.offset);
+        put(footer, chunk.size);
+        put(footer, chunk.frames);
+        put(footer, chunk.firstTimestamp);
+        put(footer, chunk.lastTimestamp);
+        put(footer, static_cast<uint32_t>(chunk.messageIds.size()));
+        const auto bytes = chunk.messageIds.size() * sizeof(uint32_t);
+        std::memcpy(extend(footer, bytes), chunk.messageIds.data(), bytes);
+    }
+    put(footer, m_fileSize);
+    std::memcpy(extend(footer, SessionFormat::footerMagic.size()),
+                SessionFormat::footerMagic.data(), SessionFormat::footerMagic.size());
+    m_file.write(reinterpret_cast<const char*>(footer.data()),
+                 static_cast<std::streamsize>(footer.size()));
+    m_file.flush();
+    if (!m_file)
+    {
+        m_failed = true;
+        LOG_ERR("SessionWriter", "Writing the session footer failed.");
+        return;
+    }
+    m_fileSize += footer.size();
+    m_bytesWritten = m_fileSize;
+}
+
+SessionReader::SessionReader(const std::filesystem::path& path)
+{
+    const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "Can not open session file " + path.string());
+    }
+    struct stat status{};
+    const bool statted = ::fstat(file, &status) == 0;
+    m_size = statted ? static_cast<std::size_t>(status.st_size) : 0;
+    if (statted && m_size >= SessionFormat::fixedHeaderSize)
+    {
+        void* mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+        m_data = mapping == MAP_FAILED ? nullptr : static_cast<const std::byte*>(mapping);
+    }
+    ::close(file);
+    if (statted && m_size < SessionFormat::fixedHeaderSize)
+    {
+        throw std::runtime_error(path.string() + " is not a session file");
+    }
+    if (!m_data)
+    {
+        throw std::runtime_error("Can not map session file " + path.string());
+    }
+
+    try
+    {
+        const auto headerSize = readHeader(path);
+        m_complete = readFooter(headerSize);
+        if (!m_complete)
+        {
+            indexChunks(headerSize);
+        }
+    }
+    catch (...)
+    {
+        ::munmap(const_cast<std::byte*>(m_data), m_size);
+        throw;
+    }
+
+    m_summary.bytesWritten = m_size;
+    for (const auto& chunk : m_chunks)
+    {
+        if (chunk.frames == 0)
+        {
+            continue;
+        }
+        if (m_summary.frames == 0)
+        {
+            m_summary.firstTimestamp = chunk.firstTimestamp;
+            m_summary.lastTimestamp = chunk.lastTimestamp;
+        }
+        m_summary.frames += chunk.frames;
+        m_summary.firstTimestamp = std::min(m_summary.firstTimestamp, chunk.firstTimestamp);
+        m_summary.lastTimestamp = std::max(m_summary.lastTimestamp, chunk.lastTimestamp);
+    }
+}
+
+SessionReader::~SessionReader()
+{
+    ::munmap(const_cast<std::byte*>(m_data), m_size);
+}
+
+auto SessionReader::next(LogEntry& entry, std::vector<SignalValue>& values) -> bool
+{
+    while (true)
+    {
+        if (m_records.empty())
+        {
+            if (m_nextChunk == m_chunks.size())
+            {
+                return false;
+            }
+            m_records = payload(m_chunks[m_nextChunk++]);
+            continue;
+        }
+        ByteReader in(m_records, "Session file record is truncated");
+        SignalDefinition definition;
+        const bool frame = readRecord(in, entry, values, m_signals.size(), definition);
+        m_records = m_records.subspan(in.position());
+        if (frame)
+        {
+            return true;
+        }
+    }
+}
+
+void SessionReader::read(const FrameQuery& query, std::vector<LogEntry>& entries,
+                         SignalStore& store) const
+{
+    constexpr auto unmapped = std::numeric_limits<uint32_t>::max();
+    // Handle in the file -> handle in the store, mapped on first use.
+    std::vector<uint32_t> handles(m_signals.size(), unmapped);
+    std::vector<SignalValue> values;
+    std::vector<SignalValue> mapped;
+    for (std::size_t chunk = 0; chunk < m_chunks.size(); ++chunk)
+    {
+        if (!m_chunks[chunk].mayMatch(query))
+        {
+            continue;
+        }
+        scan(chunk, query, values,
+             [&](const LogEntry& entry, const std::span<const SignalValue> frameValues) -> void {
+                 entries.push_back(entry);
+                 if (frameValues.empty())
+                 {
+                     return;
+                 }
+                 mapped.assign(frameValues.begin(), frameValues.end());
+                 for (auto& value : mapped)
+                 {
+                     auto& handle = handles[value.signal];
+                     if (handle == unmapped)
+                     {
+                         handle = store.signal(m_signals.name(value.signal));
+                     }
+                     value.signal = static_cast<SignalHandle>(handle);
+                 }
+                 store.append(entry.timestamp, mapped);
+             });
+    }
+}
+
+void SessionReader::scan(const std::size_t chunk, const FrameQuery& query,
+                         std::vector<SignalValue>& values, const FrameVisitor& visitor) const
+{
+    ByteReader in(payload(m_chunks.at(chunk)), "Session file record is truncated");
+    LogEntry entry;
+    SignalDefinition definition;
+    while (!in.atEnd())
+    {
+        // All names are known after opening, the definitions in the chunks are skipped.
+        if (readRecord(in, entry, values, m_signals.size(), definition) && query.matches(entry))
+        {
+            visitor(entry, values);
+        }
+    }
+}
+
+auto SessionReader::readHeader(const std::filesystem::path& path) -> std::size_t
+{
+    if (std::memcmp(m_data, SessionFormat::magic.data(), SessionFormat::magic.size()) != 0)
+    {
+        throw std::runtime_error(path.string() + " is not a session file");
+    }
+    ByteReader in({m_data, m_size}, "Session file header is truncated");
+    in.take(SessionFormat::magic.size());
+    if (in.read<uint32_t>() != SessionFormat::version)
+    {
+        throw std::runtime_error("Unsupported session file version in " + path.string());
+    }
+    m_metadata.id = in.readString<uint16_t>();
+    m_metadata.deviceName = in.readString<uint16_t>();
+    m_metadata.startTime = in.read<int64_t>();
+    m_metadata.dbcHash = in.read<uint64_t>();
+    return in.position();
+}
+
+auto SessionReader::readFooter(const std::size_t headerSize) -> bool
+{
+    if (m_size - headerSize < SessionFormat::trailerSize)
+    {
+        return false;
+    }
+    const auto* trailer = m_data + m_size - SessionFormat::trailerSize;
+    const auto footerOffset = load<uint64_t>(trailer);
+    if (std::memcmp(trailer + sizeof(uint64_t), SessionFormat::footerMagic.data(),
+                    SessionFormat::footerMagic.size()) != 0 ||
+        footerOffset < headerSize || footerOffset > m_size - SessionFormat::trailerSize)
+    {
+        return false;
+    }
+
+    ByteReader in({m_data + footerOffset, trailer}, "Session file footer is truncated");
+    m_summary.droppedFrames = in.read<uint64_t>();
+    const auto signalCount = in.read<uint32_t>();
+    if (signalCount > SignalDictionary::maxSignals)
+    {
+        throw std::runtime_error("Session file footer is corrupt");
+    }
+    for (uint32_t i = 0; i < signalCount; ++i)
+    {
+        if (m_signals.intern(in.readString<uint8_t>()) != i)
+        {
+            throw std::runtime_error("Session file footer defines a signal twice");
+        }
+    }
+    // Counts are checked against the bytes left before anything is allocated for them.
+    const auto chunkCount = in.read<uint32_t>();
+    if (chunkCount > in.remaining() / chunkIndexEntrySize)
+    {
+        throw std::runtime_error("Session file footer is corrupt");
+    }
+    m_chunks.resize(chunkCount);
+    for (auto& chunk : m_chunks)
+    {
+        chunk.offset = in.read<uint64_t>();
+        chunk.size = in.read<uint32_t>();
+        chunk.frames = in.read<uint32_t>();
+        chunk.firstTimestamp = in.read<int64_t>();
+        chunk.lastTimestamp = in.read<int64_t>();
+        const auto idCount = in.read<uint32_t>();
+        if (idCount > in.remaining() / sizeof(uint32_t))
+        {
+            throw std::runtime_error("Session file footer is corrupt");
+        }
+        const auto* ids = in.take(static_cast<std::size_t>(idCount) * sizeof(uint32_t));
+        chunk.messageIds.resize(idCount);
+        std::memcpy(chunk.messageIds.data(), ids, chunk.messageIds.size() * sizeof(uint32_t));
+        if (chunk.offset < headerSize || chunk.offset > footerOffset ||
+            footerOffset - chunk.offset < SessionFormat::chunkHeaderSize + chunk.size)
+        {
+            throw std::runtime_error("Session file index points outside of the chunks");
+        }
+    }
+    return true;
+}
+
+void SessionReader::indexChunks(const std::size_t headerSize)
+{
+    auto offset = headerSize;
+    while (m_size - offset >= SessionFormat::chunkHeaderSize)
+    {
+        ByteReader header({m_data + offset, SessionFormat::chunkHeaderSize},
+                          "Session file chunk header is truncated");
+        SessionChunk chunk;
+        chunk.offset = offset;
+        chunk.size = header.read<uint32_t>();
+        chunk.frames = header.read<uint32_t>();
+        chunk.firstTimestamp = header.read<int64_t>();
+        chunk.lastTimestamp = header.read<int64_t>();
+        // The writer never writes empty chunks, this is the start of a cut off footer.
+        if (chunk.frames == 0 || chunk.size > m_size - offset - SessionFormat::chunkHeaderSize)
+        {
+            break;
+        }
+        try
+        {
+            chunk.messageIds = indexRecords(payload(chunk), chunk.frames, &m_signals);
+        }
+        catch (const std::runtime_error& error)
+        {
+            LOG_WRN("SessionReader", "Session file ends with a corrupt chunk: {}", error.what());
+            break;
+        }
+        offset += SessionFormat::chunkHeaderSize + chunk.size;
+        m_chunks.push_back(std::move(chunk));
+    }
+}
+
+auto SessionReader::payload(const SessionChunk& chunk) const -> std::span<const std::byte>
+{
+    return {m_data + chunk.offset + SessionFormat::chunkHeaderSize, chunk.size};
+}
+
+auto listSessionFiles(const std::filesystem::path& directory) -> std::vector<SessionListing>
+{
+    std::vector<SessionListing> sessions;
+    std::error_code error;
+    for (const auto& file : std::filesystem::directory_iterator(directory, error))
+    {
+        if (!file.is_regular_file(error) || file.path().extension() != SessionFormat::extension)
+        {
+            continue;
+        }
+        try
+        {
+            const SessionReader reader(file.path());
+            sessions.push_back(
+                {file.path(), reader.metadata(), reader.summary(), reader.complete()});
+        }
+        catch (const std::exception& exception)
+        {
+            LOG_WRN("SessionReader", "Skipping {}: {}", file.path().string(), exception.what());
+        }
+    }
+    std::sort(sessions.begin(), sessions.end(),
+              [](const SessionListing& a, const SessionListing& b) -> bool {
+                  return a.metadata.startTime < b.metadata.startTime;
+              });
+    return sessions;
+}
+
+}  // namespace Logging
@@ -0,0 +1,386 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "core/dto/can_dto.hpp"
+#include "core/util/inplace_delegate.hpp"
+#include "logging/model/log_entry.hpp"
+#include "logging/model/signal_store.hpp"
+
+namespace Logging {
+
+/**
+ * @brief Layout of a session file.
+ *
+ * @details
+ * A session file starts with a header: the magic, the version and the SessionMetadata, strings
+ * with a 16 bit length. It is followed by chunks of at most SessionWriter::chunkSize bytes. A
+ * chunk has a header with the size of its payload, the number of frames in it and the earliest
+ * and latest timestamp of its frames, followed by the records. A record starts with its
+ * RecordKind. Frame records continue with the interface, the CAN ID and the timestamp in
+ * nanoseconds since the epoch:
+ * - Raw: the DLC and the 8 data bytes, of which the first DLC are valid.
+ * - Dbc: a 16 bit value count, then per value the SignalHandle and the value.
+ * - SignalName: not a frame, assigns the next SignalHandle to a name. Written right before the
+ *   first Dbc record that uses it: a 16 bit handle, an 8 bit name length and the name.
+ *
+ * When the session is closed a footer is appended, followed by the trailer with the offset of the
+ * footer and footerMagic. The footer holds the number of dropped frames, the signal names with an
+ * 8 bit length, and the chunk index: per chunk the SessionChunk fields and its sorted CAN IDs.
+ * A file without trailer, e.g. after a crash while recording, is still readable up to its last
+ * complete chunk, the reader then rebuilds the index from the chunks.
+ *
+ * Integers are stored in native byte order, which must be little endian.
+ */
+namespace SessionFormat {
+
+constexpr std::array<char, 4> magic{'C', 'B', 'M', 'L'};
+constexpr std::array<char, 4> footerMagic{'C', 'B', 'M', 'X'};
+constexpr uint32_t version = 4;
+constexpr std::string_view extension = ".cbml";
+/** @brief Magic and version, the metadata follows. */
+constexpr std::size_t fixedHeaderSize = magic.size() + sizeof(version);
+/** @brief Payload size, frame count, earliest and latest timestamp. */
+constexpr std::size_t chunkHeaderSize = 2 * sizeof(uint32_t) + 2 * sizeof(int64_t);
+/** @brief Footer offset and footerMagic. */
+constexpr std::size_t trailerSize = sizeof(uint64_t) + footerMagic.size();
+
+enum class RecordKind : uint8_t { Raw = 1, Dbc = 2, SignalName = 3 };
+
+/** @brief Converts a receive time of the CAN DTOs to a session timestamp. */
+constexpr auto toTimestamp(const std::time_t receiveTime) -> int64_t
+{
+    return static_cast<int64_t>(receiveTime) * 1'000'000'000;
+}
+
+}  // namespace SessionFormat
+
+/**
+ * @brief Describes a session, stored in the header of its file.
+ */
+struct SessionMetadata {
+    std::string id;
+    std::string deviceName;
+    /** @brief Start of the recording in nanoseconds since the epoch. */
+    int64_t startTime = 0;
+    /** @brief Core::FlatDbcConfig::contentHash() of the DBC frames were decoded with, or zero. */
+    uint64_t dbcHash = 0;
+};
+
+/**
+ * @brief Selects frames by receive time and CAN ID, both ranges inclusive.
+ */
+struct FrameQuery {
+    int64_t from = std::numeric_limits<int64_t>::min();
+    int64_t to = std::numeric_limits<int64_t>::max();
+    uint32_t firstId = 0;
+    uint32_t lastId = std::numeric_limits<uint32_t>::max();
+
+    [[nodiscard]] auto matches(const LogEntry& entry) const -> bool
+    {
+        return entry.timestamp >= from && entry.timestamp <= to && entry.messageId >= firstId &&
+               entry.messageId <= lastId;
+    }
+};
+
+/**
+ * @brief Position, time span and CAN IDs of one chunk of a session file.
+ */
+struct SessionChunk {
+    /** @brief File offset of the chunk header. */
+    uint64_t offset = 0;
+    /** @brief Size of the payload, without the chunk header. */
+    uint32_t size = 0;
+    uint32_t frames = 0;
+    /** @brief Earliest and latest timestamp in nanoseconds since the epoch. */
+    int64_t firstTimestamp = 0;
+    int64_t lastTimestamp = 0;
+    /** @brief The distinct CAN IDs of the frames, sorted. */
+    std::vector<uint32_t> messageIds;
+
+    /** @brief Checks if some frames of the chunk may match a query, without reading them. */
+    [[nodiscard]] auto mayMatch(const FrameQuery& query) const -> bool
+    {
+        if (frames == 0 || firstTimestamp > query.to || lastTimestamp < query.from)
+        {
+            return false;
+        }
+        const auto it = std::lower_bound(messageIds.begin(), messageIds.end(), query.firstId);
+        return it != messageIds.end() && *it <= query.lastId;
+    }
+};
+
+/**
+ * @brief Totals of a recorded session, all the model keeps in memory about its frames.
+ */
+struct SessionSummary {
+    uint64_t frames = 0;
+    /** @brief Frames that did not fit into the buffered chunks while the disk fell behind. */
+    uint64_t droppedFrames = 0;
+    /** @brief Size of the file written so far. */
+    uint64_t bytesWritten = 0;
+    /** @brief Earliest and latest timestamp, zero without frames. */
+    int64_t firstTimestamp = 0;
+    int64_t lastTimestamp = 0;
+    /** @brief Set once writing to the file failed, later frames are counted but lost. */
+    bool failed = false;
+};
+
+/**
+ * @brief Streams the frames of a recording into a session file on a writer thread.
+ *
+ * @details
+ * Frames are encoded into the current chunk on the appending thread, which only takes a lock to
+ * hand a full chunk to the writer thread. At most maxChunks chunks are held in memory. When all of
+ * them are queued because the disk fell behind, new frames are dropped and counted instead of
+ * blocking the appending thread, which is the GUI thread of the logging model. The writer thread
+ * also collects the CAN IDs of each chunk for the index written by close().
+ *
+ * append(), close() and summary() must be called from one thread.
+ */
+class SessionWriter
+{
+   public:
+    static constexpr std::size_t chunkSize = 256 * 1024;
+    /** @brief 2 MiB, a few seconds of four fully loaded buses. */
+    static constexpr std::size_t maxChunks = 8;
+
+    /**
+     * @brief Creates the session file, replacing an existing one, and starts the writer thread.
+     * @param metadata Written to the header, strings are truncated to 65535 characters.
+     * @throws std::runtime_error If the file can not be created.
+     */
+    SessionWriter(const std::filesystem::path& path, const SessionMetadata& metadata);
+
+    /** @brief Closes the session, see close(). */
+    ~SessionWriter();
+
+    SessionWriter(const SessionWriter&) = delete;
+    auto operator=(const SessionWriter&) -> SessionWriter& = delete;
+
+    /** @brief Appends a burst of raw frames. */
+    void append(std::span<const Core::RawCanMessage> messages);
+
+    /**
+     * @brief Appends a decoded frame.
+     * @details Signal names are written once per session and truncated to 255 characters.
+     */
+    void append(const Core::DbcCanMessage& message);
+
+    /**
+     * @brief Writes the pending chunks and the footer, stops the writer thread and closes the
+     * file.
+     * @details Frames appended afterwards are dropped. Calling it again does nothing.
+     */
+    void close();
+
+    /** @brief Returns the totals of the session so far. */
+    [[nodiscard]] auto summary() const -> SessionSummary;
+
+    /** @brief Returns the chunks written to the file so far. */
+    [[nodiscard]] auto chunks() const -> std::vector<SessionChunk>;
+
+   private:
+    struct Chunk {
+        /** @brief The chunk header, filled in when the chunk is submitted, and the records. */
+        std::vector<std::byte> data;
+        uint32_t frames = 0;
+        int64_t firstTimestamp = 0;
+        int64_t lastTimestamp = 0;
+    };
+
+    /**
+     * @brief Makes room for a record in the current chunk, submitting it if it is full.
+     * @return False if no chunk is available, the frame is dropped then.
+     */
+    auto beginRecord(std::size_t size, int64_t timestamp) -> bool;
+    /** @brief Hands the current chunk to the writer thread. */
+    void submit();
+    /** @brief The writer thread. */
+    void run();
+    /** @brief Writes a chunk at the end of the file. Writer thread only. */
+    void write(Chunk& chunk);
+    /** @brief Appends footer and trailer, after the writer thread stopped. */
+    void writeFooter();
+
+    std::ofstream m_file;
+    /** @brief Size of the file, only used by the writer thread until it stopped. */
+    uint64_t m_fileSize = 0;
+
+    // Owned by the appending thread.
+    std::unique_ptr<Chunk> m_current;
+    /** @brief The signal names written so far. */
+    SignalDictionary m_signals;
+    /** @brief Names of the appended frame that are not in m_signals yet, reused per frame. */
+    std::vector<std::string_view> m_newSignals;
+    uint64_t m_frames = 0;
+    uint64_t m_dropped = 0;
+    int64_t m_firstTimestamp = 0;
+    int64_t m_lastTimestamp = 0;
+    bool m_closed = false;
+
+    // Shared with the writer thread.
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    std::deque<std::unique_ptr<Chunk>> m_pending;
+    std::vector<std::unique_ptr<Chunk>> m_free;
+    std::size_t m_allocated = 0;
+    std::vector<SessionChunk> m_chunks;
+    uint64_t m_bytesWritten = 0;
+    bool m_failed = false;
+    bool m_closing = false;
+
+    std::jthread m_thread;
+};
+
+/**
+ * @brief Serves the frames of a session file from a read-only memory mapping.
+ *
+ * @details
+ * Opening reads only the header and the footer, the frames are decoded from the mapping when they
+ * are requested, so a long session is never loaded as a whole. Queries skip the chunks whose time
+ * span or CAN IDs can not match by the chunk index. A file without footer is indexed by walking
+ * its chunks once while opening, a chunk that was cut off or is corrupt ends the session.
+ *
+ * The const members can be called from several threads at once.
+ */
+class SessionReader
+{
+   public:
+    /** @brief Receives a frame and its decoded values, with handles of signalNames(). */
+    using FrameVisitor =
+        Core::InplaceDelegate<void(const LogEntry&, std::span<const SignalValue>)>;
+
+    /**
+     * @brief Maps a session file and reads its index.
+     * @throws std::runtime_error If the file can not be mapped or is not a session file.
+     */
+    explicit SessionReader(const std::filesystem::path& path);
+
+    /** @brief Unmaps the file. */
+    ~SessionReader();
+
+    SessionReader(const SessionReader&) = delete;
+    auto operator=(const SessionReader&) -> SessionReader& = delete;
+
+    [[nodiscard]] auto metadata() const -> const SessionMetadata&
+    {
+        return m_metadata;
+    }
+
+    /** @brief Totals of the session, bytesWritten is the size of the file. */
+    [[nodiscard]] auto summary() const -> const SessionSummary&
+    {
+        return m_summary;
+    }
+
+    /** @brief Checks if the session was closed, false if the index was rebuilt from the chunks. */
+    [[nodiscard]] auto complete() const -> bool
+    {
+        return m_complete;
+    }
+
+    [[nodiscard]] auto chunks() const -> std::span<const SessionChunk>
+    {
+        return m_chunks;
+    }
+
+    /** @brief The names of all signals of the session. */
+    [[nodiscard]] auto signalNames() const -> const SignalDictionary&
+    {
+        return m_signals;
+    }
+
+    /**
+     * @brief Reads the next frame in recorded order.
+     * @param entry Receives the frame.
+     * @param values Receives the decoded values of a LogEntry::Decoded frame, with handles of
+     * signalNames(), and is cleared for raw frames.
+     * @return False after the last frame.
+     * @throws std::runtime_error If a record is corrupt.
+     */
+    auto next(LogEntry& entry, std::vector<SignalValue>& values) -> bool;
+
+    /**
+     * @brief Reads the frames matching a query, in recorded order.
+     * @param entries Receives the frames, appended.
+     * @param store Receives the decoded values of the frames.
+     * @throws std::runtime_error If a record is corrupt.
+     */
+    void read(const FrameQuery& query, std::vector<LogEntry>& entries, SignalStore& store) const;
+
+    /**
+     * @brief Decodes the frames of one chunk that match a query, in recorded order.
+     * @details Does not allocate once @p values has grown to the largest frame.
+     * @param chunk Index into chunks().
+     * @param values Holds the decoded values of a frame, reused between frames and calls.
+     * @param visitor Called per matching frame.
+     * @throws std::runtime_error If a record is corrupt.
+     */
+    void scan(std::size_t chunk, const FrameQuery& query, std::vector<SignalValue>& values,
+              const FrameVisitor& visitor) const;
+
+    /** @brief Reads all frames, see read(). */
+    void readAll(std::vector<LogEntry>& entries, SignalStore& store) const
+    {
+        read(FrameQuery{}, entries, store);
+    }
+
+   private:
+    /** @brief Reads the header, returns its size. */
+    auto readHeader(const std::filesystem::path& path) -> std::size_t;
+    /** @brief Reads footer and trailer, returns false if the file has none. */
+    auto readFooter(std::size_t headerSize) -> bool;
+    /** @brief Rebuilds the chunk index and the signal names from the chunks. */
+    void indexChunks(std::size_t headerSize);
+    /** @brief Returns the records of a chunk. */
+    [[nodiscard]] auto payload(const SessionChunk& chunk) const -> std::span<const std::byte>;
+
+    const std::byte* m_data = nullptr;
+    std::size_t m_size = 0;
+    SessionMetadata m_metadata;
+    SessionSummary m_summary;
+    bool m_complete = false;
+    std::vector<SessionChunk> m_chunks;
+    SignalDictionary m_signals;
+
+    // Position of next().
+    std::size_t m_nextChunk = 0;
+    std::span<const std::byte> m_records;
+};
+
+/**
+ * @brief A session file found by listSessionFiles().
+ */
+struct SessionListing {
+    std::filesystem::path path;
+    SessionMetadata metadata;
+    SessionSummary summary;
+    /** @brief False if the session was not closed, see SessionReader::complete(). */
+    bool complete = false;
+};
+
+/**
+ * @brief Lists the session files of a directory, oldest first.
+ * @details Reads only header and footer of each file. Files that can not be read are skipped
+ * with a warning.
+ */
+auto listSessionFiles(const std::filesystem::path& directory) -> std::vector<SessionListing>;
+
+}  // namespace Logging
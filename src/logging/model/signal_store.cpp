@@ -0,0 +1,247 @@
+#include "signal_store.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Logging {
+
+auto SignalDictionary::intern(const std::string_view name) -> SignalHandle
+{
+    if (const auto it = m_handles.find(name); it != m_handles.end())
+    {
+        return it->second;
+    }
+    if (m_names.size() >= maxSignals)
+    {
+        throw std::length_error("Too many signal names in one session");
+    }
+    const auto handle = static_cast<SignalHandle>(m_names.size());
+    m_handles.emplace(m_names.emplace_back(name), handle);
+    return handle;
+}
+
+auto SignalDictionary::find(const std::string_view name) const -> std::optional<SignalHandle>
+{
+    const auto it = m_handles.find(name);
+    if (it == m_handles.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+SignalStore::SignalStore(const std::chrono::nanoseconds chunkDuration)
+    : m_chunkDuration(chunkDuration.count())
+{
+    if (chunkDuration.count() <= 0)
+    {
+        throw std::invalid_argument("The chunk duration of a signal store must be positive");
+    }
+}
+
+auto SignalStore::signal(const std::string_view name) -> SignalHandle
+{
+    const auto handle = m_dictionary.intern(name);
+    if (handle >= m_slots.size())
+    {
+        m_slots.resize(handle + 1, 0);
+    }
+    return handle;
+}
+
+void SignalStore::append(const int64_t timestamp, const std::span<const SignalValue> values)
+{
+    if (values.empty())
+    {
+        return;
+    }
+    // Checked before anything is stored, so a bad frame leaves the store unchanged.
+    for (const auto& value : values)
+    {
+        if (value.signal >= m_slots.size())
+        {
+            throw std::out_of_range("Signal handle is not part of the signal store");
+        }
+    }
+    if (m_chunks.empty() || timestamp - m_chunks.back().begin >= m_chunkDuration)
+    {
+        seal();
+        m_chunks.push_back({timestamp, {}});
+    }
+    auto& chunk = m_chunks.back();
+    m_lateness = std::max(m_lateness, chunk.begin - timestamp);
+    for (const auto& value : values)
+    {
+        auto& slot = m_slots[value.signal];
+        if (slot == 0)
+        {
+            chunk.columns.push_back({value.signal, {}, {}, {}});
+            slot = static_cast<uint32_t>(chunk.columns.size());
+        }
+        auto& column = chunk.columns[slot - 1];
+        column.zone.add(timestamp, value.value);
+        column.timestamps.push_back(timestamp);
+        column.values.push_back(value.value);
+    }
+    m_valueCount += values.size();
+}
+
+void SignalStore::range(const SignalHandle signal, const int64_t from, const int64_t to,
+                        std::vector<int64_t>& timestamps, std::vector<double>& values) const
+{
+    for (const auto& chunk : chunksIn(from, to))
+    {
+        const auto* column = find(chunk, signal);
+        if (!column || !column->zone.overlaps(from, to))
+        {
+            continue;
+        }
+        if (column->zone.within(from, to))
+        {
+            timestamps.insert(timestamps.end(), column->timestamps.begin(),
+                              column->timestamps.end());
+            values.insert(values.end(), column->values.begin(), column->values.end());
+            continue;
+        }
+
+        // Writes every value and only advances past the matching ones.
+        const auto size = column->timestamps.size();
+        const auto base = timestamps.size();
+        timestamps.resize(base + size);
+        values.resize(base + size);
+        const auto* inTimestamps = column->timestamps.data();
+        const auto* inValues = column->values.data();
+        auto* outTimestamps = timestamps.data() + base;
+        auto* outValues = values.data() + base;
+        std::size_t matches = 0;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            outTimestamps[matches] = inTimestamps[i];
+            outValues[matches] = inValues[i];
+            const auto timestamp = inTimestamps[i];
+            matches += static_cast<std::size_t>((timestamp >= from) & (timestamp <= to));
+        }
+        timestamps.resize(base + matches);
+        values.resize(base + matches);
+    }
+}
+
+void SignalStore::above(const SignalHandle signal, const double threshold, const int64_t from,
+                        const int64_t to, std::vector<int64_t>& timestamps) const
+{
+    for (const auto& chunk : chunksIn(from, to))
+    {
+        const auto* column = find(chunk, signal);
+        if (!column || !column->zone.overlaps(from, to) || !(column->zone.max > threshold))
+        {
+            continue;
+        }
+        if (column->zone.min > threshold && column->zone.within(from, to))
+        {
+            timestamps.insert(timestamps.end(), column->timestamps.begin(),
+                              column->timestamps.end());
+            continue;
+        }
+
+        const auto size = column->timestamps.size();
+        const auto base = timestamps.size();
+        timestamps.resize(base + size);
+        const auto* inTimestamps = column->timestamps.data();
+        const auto* inValues = column->values.data();
+        auto* out = timestamps.data() + base;
+        std::size_t matches = 0;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            const auto timestamp = inTimestamps[i];
+            out[matches] = timestamp;
+            matches += static_cast<std::size_t>((inValues[i] > threshold) & (timestamp >= from) &
+                                                (timestamp <= to));
+        }
+        timestamps.resize(base + matches);
+    }
+}
+
+auto SignalStore::zone(const SignalHandle signal, const int64_t from, const int64_t to) const
+    -> SignalZone
+{
+    SignalZone result;
+    for (const auto& chunk : chunksIn(from, to))
+    {
+        const auto* column = find(chunk, signal);
+        if (!column || !column->zone.overlaps(from, to))
+        {
+            continue;
+        }
+        if (column->zone.within(from, to))
+        {
+            result.merge(column->zone);
+            continue;
+        }
+        SignalZone part;
+        const auto size = column->timestamps.size();
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            const auto timestamp = column->timestamps[i];
+            const auto value = column->values[i];
+            const bool inRange = (timestamp >= from) & (timestamp <= to);
+            part.count += static_cast<std::size_t>(inRange);
+            part.min = inRange ? std::min(part.min, value) : part.min;
+            part.max = inRange ? std::max(part.max, value) : part.max;
+            part.firstTimestamp = inRange ? std::min(part.firstTimestamp, timestamp)
+                                          : part.firstTimestamp;
+            part.lastTimestamp = inRange ? std::max(part.lastTimestamp, timestamp)
+                                         : part.lastTimestamp;
+        }
+        result.merge(part);
+    }
+    return result;
+}
+
+void SignalStore::seal()
+{
+    if (m_chunks.empty())
+    {
+        return;
+    }
+    auto& columns = m_chunks.back().columns;
+    for (auto& column : columns)
+    {
+        m_slots[column.signal] = 0;
+        column.timestamps.shrink_to_fit();
+        column.values.shrink_to_fit();
+    }
+    std::sort(columns.begin(), columns.end(), [](const Column& a, const Column& b) -> bool {
+        return a.signal < b.signal;
+    });
+}
+
+auto SignalStore::chunksIn(const int64_t from, const int64_t to) const -> std::span<const Chunk>
+{
+    // Values of a chunk are older than the start of the next one, and at most m_lateness older
+    // than the start of their own.
+    const auto first = std::partition_point(
+        m_chunks.begin(), m_chunks.end(), [this, from](const Chunk& chunk) -> bool {
+            return chunk.begin + m_chunkDuration <= from;
+        });
+    const auto last =
+        std::partition_point(first, m_chunks.end(), [this, to](const Chunk& chunk) -> bool {
+            return chunk.begin - m_lateness <= to;
+        });
+    return {first, last};
+}
+
+auto SignalStore::find(const Chunk& chunk, const SignalHandle signal) const -> const Column*
+{
+    if (&chunk == &m_chunks.back())
+    {
+        const auto slot = signal < m_slots.size() ? m_slots[signal] : 0;
+        return slot == 0 ? nullptr : &chunk.columns[slot - 1];
+    }
+    const auto it = std::lower_bound(chunk.columns.begin(), chunk.columns.end(), signal,
+                                     [](const Column& column, const SignalHandle handle) -> bool {
+                                         return column.signal < handle;
+                                     });
+    return it != chunk.columns.end() && it->signal == signal ? &*it : nullptr;
+}
+
+}  // namespace Logging
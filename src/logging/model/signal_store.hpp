@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Logging {
+
+/**
+ * @brief Index of a signal name in a SignalDictionary.
+ */
+using SignalHandle = uint16_t;
+
+/**
+ * @brief A decoded signal value of a frame.
+ */
+struct SignalValue {
+    SignalHandle signal = 0;
+    double value = 0.0;
+};
+
+/**
+ * @brief Assigns handles to signal names in order of first appearance.
+ * @details Handles are stable for the lifetime of the dictionary. Names are stored once, lookups
+ * by name do not allocate.
+ */
+class SignalDictionary
+{
+   public:
+    static constexpr std::size_t maxSignals = UINT16_MAX + 1;
+
+    /**
+     * @brief Returns the handle of a name, assigning the next one if the name is new.
+     * @throws std::length_error If the dictionary already holds maxSignals names.
+     */
+    auto intern(std::string_view name) -> SignalHandle;
+
+    /** @brief Returns the handle of a name, if it was interned. */
+    [[nodiscard]] auto find(std::string_view name) const -> std::optional<SignalHandle>;
+
+    [[nodiscard]] auto name(SignalHandle signal) const -> std::string_view
+    {
+        return m_names[signal];
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+        return m_names.size();
+    }
+
+   private:
+    /** @brief A deque, so the views in m_handles stay valid while names are added. */
+    std::deque<std::string> m_names;
+    /** @brief Name -> handle. Views into m_names. */
+    std::unordered_map<std::string_view, SignalHandle> m_handles;
+};
+
+/**
+ * @brief Zone map of the values of a signal in one chunk: their count, value range and time span.
+ * @details Queries compare it with their time range and predicate first and skip the chunk, or
+ * take it whole, without looking at the values.
+ */
+struct SignalZone {
+    std::size_t count = 0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    /** @brief Earliest and latest timestamp in nanoseconds since the epoch. */
+    int64_t firstTimestamp = std::numeric_limits<int64_t>::max();
+    int64_t lastTimestamp = std::numeric_limits<int64_t>::min();
+
+    void add(const int64_t timestamp, const double value)
+    {
+        ++count;
+        min = std::min(min, value);
+        max = std::max(max, value);
+        firstTimestamp = std::min(firstTimestamp, timestamp);
+        lastTimestamp = std::max(lastTimestamp, timestamp);
+    }
+
+    void merge(const SignalZone& other)
+    {
+        count += other.count;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        firstTimestamp = std::min(firstTimestamp, other.firstTimestamp);
+        lastTimestamp = std::max(lastTimestamp, other.lastTimestamp);
+    }
+
+    /** @brief Checks if some values may lie in [from, to]. */
+    [[nodiscard]] auto overlaps(const int64_t from, const int64_t to) const -> bool
+    {
+        return count > 0 && firstTimestamp <= to && lastTimestamp >= from;
+    }
+
+    /** @brief Checks if all values lie in [from, to]. */
+    [[nodiscard]] auto within(const int64_t from, const int64_t to) const -> bool
+    {
+        return firstTimestamp >= from && lastTimestamp <= to;
+    }
+};
+
+/**
+ * @brief Chunked columnar store of the decoded signal values of a session.
+ *
+ * @details
+ * Values are partitioned by time into chunks of chunkDuration. Within a chunk every signal has its
+ * own contiguous columns of timestamps and values and a SignalZone. Range and threshold queries
+ * skip chunks by their zone maps, take chunks that match entirely as a whole, and scan only the
+ * remaining columns with branch free loops.
+ *
+ * Chunks are kept in time order, so a query only visits the chunks that can hold its time range.
+ * Values are expected in roughly ascending time, as they are received. A value older than the
+ * current chunk is still stored there and widens the chunks every query visits by its lateness,
+ * so queries stay exact.
+ */
+class SignalStore
+{
+   public:
+    static constexpr std::chrono::nanoseconds defaultChunkDuration = std::chrono::seconds(1);
+
+    /**
+     * @param chunkDuration The time span of a chunk.
+     * @throws std::invalid_argument If @p chunkDuration is not positive.
+     */
+    explicit SignalStore(std::chrono::nanoseconds chunkDuration = defaultChunkDuration);
+
+    /** @brief The names of the signals, whose handles key the columns. */
+    [[nodiscard]] auto dictionary() const -> const SignalDictionary&
+    {
+        return m_dictionary;
+    }
+
+    /** @brief Returns the handle of a signal name, adding it if the name is new. */
+    auto signal(std::string_view name) -> SignalHandle;
+
+    /**
+     * @brief Appends the decoded values of a frame.
+     * @param timestamp The receive time of the frame in nanoseconds since the epoch.
+     * @param values The values, with handles of this store's dictionary.
+     * @throws std::out_of_range If a handle is not part of the dictionary, nothing is stored then.
+     */
+    void append(int64_t timestamp, std::span<const SignalValue> values);
+
+    /**
+     * @brief Collects the values of a signal received in [from, to], in chunk order.
+     * @param timestamps Receives the timestamps, appended.
+     * @param values Receives the values, appended parallel to @p timestamps.
+     */
+    void range(SignalHandle signal, int64_t from, int64_t to, std::vector<int64_t>& timestamps,
+               std::vector<double>& values) const;
+
+    /**
+     * @brief Collects the timestamps in [from, to] at which a signal was above a threshold.
+     * @param timestamps Receives the timestamps, appended.
+     */
+    void above(SignalHandle signal, double threshold, int64_t from, int64_t to,
+               std::vector<int64_t>& timestamps) const;
+
+    /** @brief Returns count, range and time span of the values of a signal in [from, to]. */
+    [[nodiscard]] auto zone(SignalHandle signal, int64_t from, int64_t to) const -> SignalZone;
+
+    /** @brief Returns the number of stored values over all signals. */
+    [[nodiscard]] auto valueCount() const -> std::size_t
+    {
+        return m_valueCount;
+    }
+
+    [[nodiscard]] auto chunkCount() const -> std::size_t
+    {
+        return m_chunks.size();
+    }
+
+   private:
+    struct Column {
+        SignalHandle signal = 0;
+        SignalZone zone;
+        std::vector<int64_t> timestamps;
+        std::vector<double> values;
+    };
+
+    struct Chunk {
+        /** @brief Start of the time span of the chunk. */
+        int64_t begin = 0;
+        /** @brief The columns of the signals with values in the chunk, by signal once sealed. */
+        std::vector<Column> columns;
+    };
+
+    /** @brief Sorts the columns of the current chunk and releases their spare capacity. */
+    void seal();
+    /** @brief Returns the chunks that may hold values in [from, to]. */
+    [[nodiscard]] auto chunksIn(int64_t from, int64_t to) const -> std::span<const Chunk>;
+    /** @brief Returns the column of a signal in a chunk, nullptr if it has no values there. */
+    [[nodiscard]] auto find(const Chunk& chunk, SignalHandle signal) const -> const Column*;
+
+    const int64_t m_chunkDuration;
+    SignalDictionary m_dictionary;
+    std::vector<Chunk> m_chunks;
+    /** @brief How much older than the start of its chunk a value was at most. */
+    int64_t m_lateness = 0;
+    /** @brief Signal -> index + 1 of its column in the last chunk, zero if it has none. */
+    std::vector<uint32_t> m_slots;
+    std::size_t m_valueCount = 0;
+};
+
+}  // namespace Logging
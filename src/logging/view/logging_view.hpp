@@ -4,6 +4,7 @@
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QModelIndex>
+#include <QProgressBar>
 #include <QPushButton>
 #include <QStackedWidget>
 #include <QTreeView>
@@ -57,6 +58,15 @@ class LoggingView final : public QWidget
      */
     void setRecordingState(bool isRecording);
 
+    /**
+     * @brief Shows the progress of a running CSV export next to a Cancel button.
+     * @param percent Exported share of the frames, 0 to 100.
+     */
+    void showExportProgress(int percent);
+
+    /** @brief Hides the export progress once the export ended. */
+    void hideExportProgress();
+
    signals:
     /** @brief Emitted when user wants to start; triggers the Modal Selection Dialog. */
     void startRequested();
@@ -67,6 +77,8 @@ class LoggingView final : public QWidget
     void exportRequested(const QModelIndex& index);
     /** @brief Triggered by a 'Details' button within a specific table row. */
     void detailRequested(const QModelIndex& index);
+    /** @brief Emitted by the Cancel button of the export progress. */
+    void exportCancelRequested();
 
    private:
     /** @brief Initializes the persistent header and the swappable content frame. */
@@ -76,6 +88,9 @@ class LoggingView final : public QWidget
     QLabel* m_statusLabel;    /**< Displays status (e.g., "Idle", "Recording..."). */
     QPushButton* m_btnAction; /**< The Start/Stop toggle button. */
 
+    QProgressBar* m_exportProgress;  /**< Progress of the running CSV export. */
+    QPushButton* m_btnCancelExport;  /**< Cancels the running CSV export. */
+
     QFrame* m_mainFrame;            /**< The bordered container for consistent UI. */
     QStackedWidget* m_contentStack; /**< Handles swapping between Table and Details. */
 
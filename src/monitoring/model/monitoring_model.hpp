@@ -1,8 +1,12 @@
 #ifndef CANBUSMANAGER_MONITORING_MODEL_HPP
 #define CANBUSMANAGER_MONITORING_MODEL_HPP
 #include <QAbstractItemModel>
+#include <chrono>
+#include <span>
 
 #include "core/dto/can_dto.hpp"
+#include "core/event/can_event.hpp"
+#include "core/util/flat_dbc_config.hpp"
 
 #endif  // CANBUSMANAGER_MONITORING_MODEL_HPP
 
@@ -36,6 +40,20 @@ class MonitoringModel final : public QAbstractItemModel
      */
     explicit MonitoringModel(QObject* parent = nullptr);
 
+    /**
+     * @enum Roles
+     * @brief Custom roles for accessing monitoring state.
+     */
+    enum Roles {
+        /** @brief True if a cyclic frame has not been received in time. @return bool */
+        Role_IsTimedOut = Qt::UserRole + 1
+    };
+
+    /**
+     * @brief A cyclic frame counts as missing after this many cycle times without reception.
+     */
+    static constexpr int timeoutCycles = 3;
+
     /**
      * @name QAbstractItemModel interface implementation
      * @{
@@ -81,6 +99,37 @@ class MonitoringModel final : public QAbstractItemModel
      */
     auto setData(const QModelIndex& index, const QVariant& value, int role) -> bool override;
 
+    /** @} */
+
+    /**
+     * @brief Sets the DBC snapshot used to resolve the value descriptions (enum text) of signals.
+     *
+     * @param config The active snapshot, nullptr if no DBC is loaded.
+     */
+    void setDbcConfig(Core::DbcConfigPtr config);
+
+    /**
+     * @brief Flags frames whose cycle time (GenMsgCycleTime) elapsed timeoutCycles times
+     * without a reception, and clears the flag of frames that are received again.
+     *
+     * Called periodically by the component. Frames without a cycle time in the DBC are never
+     * flagged, so no manual timeout setup is needed.
+     *
+     * @param now The current time.
+     */
+    void checkTimeouts(std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Applies the newest frame of every changed CAN ID.
+     *
+     * Called by the conflating subscription of the component, so each frame is updated at most
+     * once per refresh with a single dataChanged() for its row and signals, however often it was
+     * received in between.
+     *
+     * @param events The latest decoded frame per changed CAN ID.
+     */
+    void updateFrames(std::span<const Core::ReceivedCanDbcEvent> events);
+
    private:
     /**
      * @struct SignalNode
@@ -96,9 +145,14 @@ class MonitoringModel final : public QAbstractItemModel
      * @brief Internal representation of a CAN frame and its contained signals.
      */
     struct FrameNode {
-        Core::DbcCanMessage message;
+        /** @brief The latest frame, retained by reference instead of copied. */
+        Core::PayloadRef<Core::DbcCanMessage> message;
         QVector<SignalNode> allSignals;
         Qt::CheckState checked;
+        /** @brief Cycle time from the DBC, zero if the frame is not cyclic. */
+        std::chrono::milliseconds cycleTime{0};
+        std::chrono::steady_clock::time_point lastReceived;
+        bool timedOut = false;
     };
 
     /**
@@ -109,5 +163,11 @@ class MonitoringModel final : public QAbstractItemModel
      * tree view.
      */
     QVector<FrameNode> m_frames;  // contains last 1min/whatever of signal data
+
+    /**
+     * @brief Snapshot used by data() to display the value description of a signal
+     * instead of its number, via Core::FlatDbcConfig::describeValue().
+     */
+    Core::DbcConfigPtr m_dbc;
 };
 }  // namespace Monitoring
\ No newline at end of file
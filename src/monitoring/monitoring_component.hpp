@@ -1,6 +1,9 @@
 #ifndef CANBUSMANAGER_MONITORING_COMPONENT_HPP
 #define CANBUSMANAGER_MONITORING_COMPONENT_HPP
 
+#include <chrono>
+
+#include "core/event/can_event.hpp"
 #include "core/interface/i_event_broker.hpp"
 #include "core/interface/i_tab_component.hpp"
 #include "monitoring/delegate/monitoring_delegate.hpp"
@@ -44,6 +47,13 @@ class MonitoringComponent final : public Core::ITabComponent
      */
     explicit MonitoringComponent(Core::IEventBroker& broker);
 
+    /**
+     * @brief Minimum time between two updates of the frame tree (30 Hz).
+     * @details Received frames are conflated to the latest one per CAN ID in between, so the tree
+     * keeps up with a fully loaded bus.
+     */
+    static constexpr std::chrono::milliseconds frameRefreshInterval{33};
+
     /**
      * @brief Destructor.
      *
@@ -71,6 +81,7 @@ class MonitoringComponent final : public Core::ITabComponent
     /**
      * @brief Signal emitted when a new dbcConfiguration is available.
      * The available ECUs and signals refresh, no signal is selected for plotting.
+     * The new configuration is read from the @ref Core::DbcSnapshotRegistry.
      */
     void dbcConfigurationChanged();
 
@@ -98,7 +109,7 @@ class MonitoringComponent final : public Core::ITabComponent
      * @param messageId the id of the message the checked signal belongs to
      * @param signalName the name of the checked signal
      */
-    void onSignalChecked(char messageId, const std::string& signalName);
+    void onSignalChecked(uint32_t messageId, const std::string& signalName);
 
     /**
      * @brief Triggered when the user unchecks a signal currently checked (therefor plotted in a
@@ -107,9 +118,16 @@ class MonitoringComponent final : public Core::ITabComponent
      * @param messageId the id of the message the unchecked signal belongs to
      * @param signalName the name of the unchecked signal
      */
-    void onSignalUnchecked(char messageId, const std::string& signalName);
+    void onSignalUnchecked(uint32_t messageId, const std::string& signalName);
 
    private:
+    /**
+     * @brief RAII Handle for the conflating subscription to decoded frames.
+     * Hands the newest frame of every changed CAN ID to MonitoringModel::updateFrames() at most
+     * once per frameRefreshInterval.
+     */
+    Core::Connection m_frameConn;
+
     /** @brief Model holding CAN sending configuration and data */
     std::unique_ptr<MonitoringModel> m_model;
 
@@ -1,11 +1,12 @@
 #pragma once
 
 #include <QAbstractItemModel>
+#include <chrono>
 #include <string>
 #include <vector>
 
 #include "core/dto/can_dto.hpp"
-#include "core/dto/dbc_dto.hpp"
+#include "core/util/flat_dbc_config.hpp"
 
 namespace Sending {
 
@@ -62,7 +63,12 @@ class SendingModel final : public QAbstractItemModel
         return m_cyclicState.isSending;
     }
 
-    void updateDbcConfig(const Core::DbcConfig& config);
+    /**
+     * @brief Replaces the DBC configuration used for composing DBC based messages.
+     * Signal values are initialized with their start values (GenSigStartValue).
+     * @param config The shared configuration, the model only keeps the pointer.
+     */
+    void updateDbcConfig(const Core::DbcConfigPtr& config);
     void setTransmissionStatus(bool isActive);
    signals:
     /** * @brief Emitted when the Model determines a Raw message should be sent.
@@ -94,6 +100,19 @@ class SendingModel final : public QAbstractItemModel
      */
     void updateTimerState();
 
+    /**
+     * @brief Rebuilds m_schedule from the selected messages.
+     * Every message is scheduled at its native cycle time (GenMsgCycleTime); messages without a
+     * cycle time fall back to m_cyclicState.intervalMs.
+     */
+    void scheduleDbcMessages();
+
+    /**
+     * @brief Sends all scheduled messages that are due and re-arms m_cyclicTimer for the next
+     * due message. Used instead of transmitCurrent() for cyclic sending in DBC mode.
+     */
+    void transmitDueMessages();
+
     // Navigation & Mode
     Mode m_currentMode = Mode::Raw;
     // Cyclic Transmission State
@@ -118,7 +137,17 @@ class SendingModel final : public QAbstractItemModel
     /** @brief Stores which messages are selected for transmission (checkbox state) */
     std::vector<uint32_t> m_selectedMessageIds;
 
-    Core::DbcConfig m_currentDbc;
+    /** @brief A selected DBC message scheduled for cyclic transmission. */
+    struct ScheduledMessage {
+        uint32_t messageId;
+        std::chrono::milliseconds interval;
+        std::chrono::steady_clock::time_point due;
+    };
+
+    /** @brief Cyclic schedule of the selected DBC messages, each at its own rate */
+    std::vector<ScheduledMessage> m_schedule;
+
+    Core::DbcConfigPtr m_currentDbc;
 
     // Moved from SendingDelegate: The Model now owns the timing source of truth
     QTimer* m_cyclicTimer;
@@ -4,7 +4,7 @@
 #include <memory>
 
 #include "core/dto/can_dto.hpp"
-#include "core/dto/dbc_dto.hpp"
+#include "core/util/flat_dbc_config.hpp"
 #include "core/interface/i_event_broker.hpp"
 #include "core/interface/i_tab_component.hpp"
 #include "delegate/sending_delegate.hpp"
@@ -65,8 +65,9 @@ class SendingComponent final : public Core::ITabComponent
     /**
      * @brief Signal emitted when a new DBC configuration is available.
      * The Delegate will connect to this.
+     * @param config The shared configuration, receivers keep the pointer instead of a copy.
      */
-    void dbcConfigurationChanged(const Core::DbcConfig& config);
+    void dbcConfigurationChanged(const Core::DbcConfigPtr& config);
 
    private slots:
 
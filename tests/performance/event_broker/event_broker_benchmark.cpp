@@ -0,0 +1,471 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "core/dto/can_dto.hpp"
+#include "core/event/can_event.hpp"
+#include "core/util/payload_pool.hpp"
+#include "event_broker/event_broker.hpp"
+#include "event_broker/event_journal.hpp"
+
+namespace {
+
+struct BenchmarkEvent {
+    std::chrono::steady_clock::time_point published;
+    uint64_t sequence;
+};
+
+/**
+ * @brief Publishes events on the benchmark thread and delivers them on a consumer thread.
+ * @details Reports the delivered events per second and the 99th percentile of the time between
+ * publish and delivery.
+ */
+void BM_CrossThreadPublish(benchmark::State& state)
+{
+    const auto eventsPerIteration = static_cast<uint64_t>(state.range(0));
+
+    EventBroker::EventBroker broker;
+    std::atomic<uint64_t> delivered{0};
+    std::vector<int64_t> latencies;
+    latencies.reserve(eventsPerIteration);
+    std::atomic<bool> subscribed{false};
+    Core::Connection connection;
+
+    std::jthread consumer([&](const std::stop_token& stop) -> void {
+        broker.attachConsumer([](std::chrono::milliseconds /*delay*/) -> void {});
+        connection = broker.subscribe<BenchmarkEvent>([&](const BenchmarkEvent& event) -> void {
+            if (latencies.size() < latencies.capacity())
+            {
+                latencies.push_back((std::chrono::steady_clock::now() - event.published).count());
+            }
+            delivered.fetch_add(1, std::memory_order_release);
+        });
+        subscribed.store(true, std::memory_order_release);
+        while (!stop.stop_requested())
+        {
+            if (broker.drain() == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+        connection.release();
+        broker.detachConsumer();
+    });
+    while (!subscribed.load(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+
+    uint64_t published = 0;
+    for (auto _ : state)
+    {
+        for (uint64_t i = 0; i < eventsPerIteration; ++i)
+        {
+            broker.publish(BenchmarkEvent{std::chrono::steady_clock::now(), published++});
+        }
+        while (delivered.load(std::memory_order_acquire) < published)
+        {
+            std::this_thread::yield();
+        }
+    }
+    consumer.request_stop();
+    consumer.join();
+
+    state.counters["events/s"] =
+        benchmark::Counter(static_cast<double>(published), benchmark::Counter::kIsRate);
+    if (!latencies.empty())
+    {
+        const auto p99 =
+            latencies.begin() + static_cast<std::ptrdiff_t>(latencies.size() * 99 / 100);
+        std::nth_element(latencies.begin(), p99, latencies.end());
+        state.counters["p99_ns"] = static_cast<double>(*p99);
+    }
+}
+
+/**
+ * @brief Baseline: publisher and subscriber on the same thread, delivered inline.
+ */
+void BM_SameThreadPublish(benchmark::State& state)
+{
+    EventBroker::EventBroker broker;
+    uint64_t delivered = 0;
+    const auto connection = broker.subscribe<BenchmarkEvent>(
+        [&](const BenchmarkEvent& /*event*/) -> void { ++delivered; });
+
+    uint64_t published = 0;
+    for (auto _ : state)
+    {
+        broker.publish(BenchmarkEvent{{}, published++});
+    }
+    benchmark::DoNotOptimize(delivered);
+    state.counters["events/s"] =
+        benchmark::Counter(static_cast<double>(published), benchmark::Counter::kIsRate);
+}
+
+/**
+ * @brief Publishes bursts of events to a batch subscriber on the same thread.
+ */
+void BM_SameThreadPublishBatch(benchmark::State& state)
+{
+    EventBroker::EventBroker broker;
+    uint64_t delivered = 0;
+    const auto connection = broker.subscribeBatch<BenchmarkEvent>(
+        [&](std::span<const BenchmarkEvent> events) -> void { delivered += events.size(); });
+
+    const std::vector<BenchmarkEvent> burst(static_cast<std::size_t>(state.range(0)));
+    uint64_t published = 0;
+    for (auto _ : state)
+    {
+        broker.publishBatch(std::span<const BenchmarkEvent>(burst));
+        published += burst.size();
+    }
+    benchmark::DoNotOptimize(delivered);
+    state.counters["events/s"] =
+        benchmark::Counter(static_cast<double>(published), benchmark::Counter::kIsRate);
+}
+
+struct ControlEvent {
+    static constexpr Core::EventPriority priority = Core::EventPriority::Control;
+};
+
+/**
+ * @brief Publishes a control event behind a backlog of data events for a consumer thread.
+ * @details Reports the 99th percentile of the queueing time per lane; the control lane should
+ * stay far below the time it takes to deliver the backlog.
+ */
+void BM_ControlLatencyUnderLoad(benchmark::State& state)
+{
+    const auto backlog = static_cast<uint64_t>(state.range(0));
+
+    EventBroker::EventBroker broker;
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<bool> subscribed{false};
+    Core::Connection data;
+    Core::Connection control;
+
+    std::jthread consumer([&](const std::stop_token& stop) -> void {
+        broker.attachConsumer([](std::chrono::milliseconds /*delay*/) -> void {});
+        data = broker.subscribe<BenchmarkEvent>(
+            [&](const BenchmarkEvent& /*event*/) -> void {
+                delivered.fetch_add(1, std::memory_order_release);
+            },
+            Core::SubscriptionOptions::lossless("data"));
+        control = broker.subscribe<ControlEvent>([&](const ControlEvent& /*event*/) -> void {
+            delivered.fetch_add(1, std::memory_order_release);
+        });
+        subscribed.store(true, std::memory_order_release);
+        while (!stop.stop_requested())
+        {
+            if (broker.drain() == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+        data.release();
+        control.release();
+        broker.detachConsumer();
+    });
+    while (!subscribed.load(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+
+    uint64_t published = 0;
+    for (auto _ : state)
+    {
+        for (uint64_t i = 0; i < backlog; ++i)
+        {
+            broker.publish(BenchmarkEvent{{}, published++});
+        }
+        broker.publish(ControlEvent{});
+        ++published;
+        while (delivered.load(std::memory_order_acquire) < published)
+        {
+            std::this_thread::yield();
+        }
+    }
+    consumer.request_stop();
+    consumer.join();
+
+    for (const auto& lane : broker.laneDiagnostics())
+    {
+        const auto* name = lane.lane == Core::EventPriority::Control ? "control" : "data";
+        state.counters[std::string(name) + "_p99_ns"] = static_cast<double>(lane.p99.count());
+    }
+}
+
+struct CopiedFrameEvent {
+    Core::DbcCanMessage message;
+};
+
+struct PooledFrameEvent {
+    Core::PayloadRef<Core::DbcCanMessage> message;
+};
+
+/**
+ * @brief Decoded frames with eight signals, fanned out to four subscribers on a consumer thread.
+ * @details Compares copying the message for the consumer with sharing a pooled message.
+ */
+template <bool Pooled>
+void BM_DecodedFrameFanOut(benchmark::State& state)
+{
+    using Frame = std::conditional_t<Pooled, PooledFrameEvent, CopiedFrameEvent>;
+    constexpr int subscribers = 4;
+    constexpr uint64_t framesPerIteration = 1024;
+
+    EventBroker::EventBroker broker;
+    Core::PayloadPool<Core::DbcCanMessage> pool;
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<bool> subscribed{false};
+    std::vector<Core::Connection> connections;
+
+    std::jthread consumer([&](const std::stop_token& stop) -> void {
+        broker.attachConsumer([](std::chrono::milliseconds /*delay*/) -> void {});
+        for (int i = 0; i < subscribers; ++i)
+        {
+            connections.push_back(broker.subscribe<Frame>(
+                [&](const Frame& /*frame*/) -> void {
+                    delivered.fetch_add(1, std::memory_order_release);
+                },
+                Core::SubscriptionOptions::lossless("frames")));
+        }
+        subscribed.store(true, std::memory_order_release);
+        while (!stop.stop_requested())
+        {
+            if (broker.drain() == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+        connections.clear();
+        broker.detachConsumer();
+    });
+    while (!subscribed.load(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+
+    const std::vector<Core::DbcCanSignal> signalValues(8, {"VehicleSpeedSignal", 42.0});
+    uint64_t published = 0;
+    for (auto _ : state)
+    {
+        for (uint64_t i = 0; i < framesPerIteration; ++i)
+        {
+            Frame frame;
+            if constexpr (Pooled)
+            {
+                frame.message = pool.acquire();
+                frame.message.edit().signalValues = signalValues;
+            }
+            else
+            {
+                frame.message.signalValues = signalValues;
+            }
+            broker.publish(frame);
+        }
+        published += framesPerIteration;
+        while (delivered.load(std::memory_order_acquire) < published * subscribers)
+        {
+            std::this_thread::yield();
+        }
+    }
+    consumer.request_stop();
+    consumer.join();
+
+    state.counters["frames/s"] =
+        benchmark::Counter(static_cast<double>(published), benchmark::Counter::kIsRate);
+}
+
+template <int Index>
+struct TypedEvent {
+    uint64_t value;
+};
+
+template <int... Indices>
+void subscribeAll(EventBroker::EventBroker& broker, std::vector<Core::Connection>& connections,
+                  uint64_t& delivered, std::integer_sequence<int, Indices...> /*indices*/)
+{
+    (connections.push_back(broker.subscribe<TypedEvent<Indices>>(
+         [&delivered](const TypedEvent<Indices>& event) -> void { delivered += event.value; })),
+     ...);
+}
+
+/**
+ * @brief Publish cost with many registered event types, dominated by the channel lookup.
+ * @details Inline delivery to a single subscriber; 40 types roughly match the application.
+ */
+void BM_PublishWithManyEventTypes(benchmark::State& state)
+{
+    EventBroker::EventBroker broker;
+    std::vector<Core::Connection> connections;
+    uint64_t delivered = 0;
+    subscribeAll(broker, connections, delivered, std::make_integer_sequence<int, 40>{});
+
+    uint64_t published = 0;
+    for (auto _ : state)
+    {
+        broker.publish(TypedEvent<17>{published++});
+    }
+    benchmark::DoNotOptimize(delivered);
+    state.counters["events/s"] =
+        benchmark::Counter(static_cast<double>(published), benchmark::Counter::kIsRate);
+}
+
+/**
+ * @brief Replays a journal of decoded frames at maximum speed into an inline subscriber.
+ * @details Measures the replay side of a reproducible run: reading, decoding and publishing.
+ */
+void BM_JournalReplay(benchmark::State& state)
+{
+    const auto frames = static_cast<uint64_t>(state.range(0));
+    const auto path = std::filesystem::temp_directory_path() / "event_broker_benchmark.journal";
+    {
+        EventBroker::EventBroker broker;
+        EventBroker::EventJournal journal(broker, path);
+        journal.record<Core::ReceivedCanDbcEvent>();
+        Core::PayloadPool<Core::DbcCanMessage> pool;
+        const std::vector<Core::DbcCanSignal> signalValues(8, {"VehicleSpeedSignal", 42.0});
+        for (uint64_t i = 0; i < frames; ++i)
+        {
+            Core::ReceivedCanDbcEvent frame;
+            frame.canMessage = pool.acquire();
+            auto& message = frame.canMessage.edit();
+            message.messageId = static_cast<uint32_t>(i % 64);
+            message.interfaceId = 0;
+            message.signalValues = signalValues;
+            broker.publish(frame);
+        }
+    }
+
+    EventBroker::JournalReplayer replayer(path);
+    EventBroker::EventBroker broker;
+    uint64_t delivered = 0;
+    const auto connection = broker.subscribe<Core::ReceivedCanDbcEvent>(
+        [&delivered](const Core::ReceivedCanDbcEvent& frame) -> void {
+            delivered += frame.canMessage->signalValues.size();
+        });
+    uint64_t replayed = 0;
+    for (auto _ : state)
+    {
+        replayed += replayer.replay(broker, EventBroker::JournalReplayer::maxSpeed).events;
+    }
+    benchmark::DoNotOptimize(delivered);
+    std::filesystem::remove(path);
+
+    state.counters["frames/s"] =
+        benchmark::Counter(static_cast<double>(replayed), benchmark::Counter::kIsRate);
+}
+
+/**
+ * @brief Receive threads of several buses publishing raw frames at the same time.
+ * @details Every bus has a subscriber filtering on its interface, and one unfiltered subscriber
+ * sees the merged view of all buses, all delivered inline on the publishing threads.
+ */
+void BM_MultiBusPublish(benchmark::State& state)
+{
+    constexpr uint64_t framesPerBus = 16384;
+    const auto buses = static_cast<uint8_t>(state.range(0));
+
+    EventBroker::EventBroker broker;
+    std::vector<Core::Connection> connections;
+    std::vector<std::atomic<uint64_t>> perBus(buses);
+    std::atomic<uint64_t> merged{0};
+    const auto options = Core::SubscriptionOptions{.executor = Core::Executor::publisher()};
+    for (uint8_t bus = 0; bus < buses; ++bus)
+    {
+        connections.push_back(broker.subscribe<Core::ReceivedCanRawEvent>(
+            Core::EventFilter::forIds({}, uint32_t{1} << bus),
+            [&counter = perBus[bus]](const Core::ReceivedCanRawEvent& /*frame*/) -> void {
+                counter.store(counter.load(std::memory_order_relaxed) + 1,
+                              std::memory_order_relaxed);
+            },
+            options));
+    }
+    connections.push_back(broker.subscribe<Core::ReceivedCanRawEvent>(
+        [&merged](const Core::ReceivedCanRawEvent& /*frame*/) -> void {
+            merged.fetch_add(1, std::memory_order_relaxed);
+        },
+        options));
+
+    uint64_t published = 0;
+    for (auto _ : state)
+    {
+        std::vector<std::jthread> receivers;
+        for (uint8_t bus = 0; bus < buses; ++bus)
+        {
+            receivers.emplace_back([&broker, bus]() -> void {
+                Core::ReceivedCanRawEvent frame;
+                frame.canMessage.interfaceId = bus;
+                for (uint64_t i = 0; i < framesPerBus; ++i)
+                {
+                    frame.canMessage.messageId = static_cast<uint32_t>(i % 64);
+                    broker.publish(frame);
+                }
+            });
+        }
+        receivers.clear();
+        published += framesPerBus * buses;
+    }
+    benchmark::DoNotOptimize(merged.load());
+
+    state.counters["frames/s"] =
+        benchmark::Counter(static_cast<double>(published), benchmark::Counter::kIsRate);
+}
+
+struct PongReply : Core::Event {
+    Core::RequestId requestId = 0;
+};
+
+struct PingRequest : Core::Event {
+    using Response = PongReply;
+    Core::RequestId requestId = 0;
+};
+
+/**
+ * @brief Round trip of a request answered on a worker thread, waited for like a future.
+ * @details Includes the two reply subscriptions every request makes and removes again.
+ */
+void BM_RequestReply(benchmark::State& state)
+{
+    EventBroker::EventBroker broker;
+    const auto responder = broker.subscribe<PingRequest>(
+        [&broker](const PingRequest& request) -> void {
+            PongReply reply;
+            reply.requestId = request.requestId;
+            broker.publish(reply);
+        },
+        Core::SubscriptionOptions{}.on(Core::Executor::worker("responder")));
+
+    uint64_t replies = 0;
+    for (auto _ : state)
+    {
+        auto reply = broker.request(PingRequest{});
+        benchmark::DoNotOptimize(reply.get());
+        ++replies;
+    }
+    state.counters["requests/s"] =
+        benchmark::Counter(static_cast<double>(replies), benchmark::Counter::kIsRate);
+}
+
+}  // namespace
+
+BENCHMARK(BM_CrossThreadPublish)->Arg(1024)->Arg(16384)->UseRealTime();
+BENCHMARK(BM_ControlLatencyUnderLoad)->Arg(4096)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_DecodedFrameFanOut, false)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_DecodedFrameFanOut, true)->UseRealTime();
+BENCHMARK(BM_SameThreadPublish);
+BENCHMARK(BM_SameThreadPublishBatch)->Arg(64);
+BENCHMARK(BM_PublishWithManyEventTypes);
+BENCHMARK(BM_JournalReplay)->Arg(16384);
+BENCHMARK(BM_MultiBusPublish)->Arg(1)->Arg(4)->UseRealTime();
+BENCHMARK(BM_RequestReply)->UseRealTime();
@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+#include "core/dto/can_dto.hpp"
+#include "logging/model/csv_exporter.hpp"
+#include "logging/model/session_file.hpp"
+
+namespace {
+
+constexpr std::size_t sessionFrames = 2'000'000;
+
+/**
+ * @brief Writes a session of raw frames of 64 CAN IDs on four interfaces, with a decoded frame of
+ * four signals after every 16 raw frames, once per run.
+ */
+auto exportSession() -> const std::filesystem::path&
+{
+    static const auto path = []() -> std::filesystem::path {
+        auto file = std::filesystem::temp_directory_path() / "csv_export_benchmark.cbml";
+        Logging::SessionWriter writer(file, {});
+        std::vector<Core::RawCanMessage> burst(16);
+        Core::DbcCanMessage decoded{
+            0, {{"VehicleSpeed", 0.0}, {"EngineSpeed", 0.0}, {"Gear", 0.0}, {"Fuel", 0.0}}, 0x100,
+            0};
+        for (std::size_t frame = 0; frame < sessionFrames; frame += burst.size() + 1)
+        {
+            const auto receiveTime = static_cast<std::time_t>(1'700'000'000 + frame / 4000);
+            for (std::size_t i = 0; i < burst.size(); ++i)
+            {
+                auto& message = burst[i];
+                message.receiveTime = receiveTime;
+                message.messageId = static_cast<uint32_t>(0x200 + (frame + i) % 64);
+                message.interfaceId = static_cast<Core::InterfaceId>(i % 4);
+                message.data = {static_cast<char>(frame), 0x12, 0x34, 0x56, 0x78, 0x7A, 0, 1};
+            }
+            writer.append(burst);
+            decoded.receiveTime = receiveTime;
+            decoded.signalValues[0].value = static_cast<double>(frame % 250) * 0.1;
+            decoded.signalValues[1].value = 800.0 + static_cast<double>(frame % 5000) * 0.25;
+            decoded.signalValues[2].value = static_cast<double>(frame % 6);
+            decoded.signalValues[3].value = 61.5;
+            writer.append(decoded);
+            // Keeps the writer thread ahead, the file has to hold every frame.
+            if (frame % 4096 < burst.size() + 1)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        return file;
+    }();
+    return path;
+}
+
+/**
+ * @brief Exports the whole session to a CSV file with the given number of formatting threads.
+ * @details The bytes/s rate is the CSV output written per second.
+ */
+void BM_CsvExport(benchmark::State& state)
+{
+    const auto& session = exportSession();
+    const auto csv = std::filesystem::temp_directory_path() / "csv_export_benchmark.csv";
+    const auto threads =
+        state.range(0) > 0 ? static_cast<std::size_t>(state.range(0))
+                           : Logging::CsvExporter::defaultThreads();
+    Logging::CsvExportProgress progress;
+    for (auto _ : state)
+    {
+        Logging::CsvExporter exporter(session, csv, nullptr, threads);
+        progress = exporter.wait();
+    }
+    std::filesystem::remove(csv);
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * progress.bytes));
+    state.counters["rows"] = static_cast<double>(progress.rows);
+    state.counters["threads"] = static_cast<double>(threads);
+}
+
+}  // namespace
+
+// Zero selects CsvExporter::defaultThreads().
+BENCHMARK(BM_CsvExport)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,92 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "logging/model/signal_store.hpp"
+
+namespace {
+
+constexpr int64_t sampleInterval = 10'000'000;  // 100 Hz
+constexpr int64_t sessionLength = 3600LL * 1'000'000'000;  // One hour
+
+/**
+ * @brief One hour of eight signals at 100 Hz, an engine speed between 800 and 3000 rpm with a
+ * short peak above 5000 rpm at half time.
+ */
+auto makeSession() -> const Logging::SignalStore&
+{
+    static const auto store = []() -> Logging::SignalStore {
+        Logging::SignalStore session;
+        std::array<Logging::SignalValue, 8> values{};
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            values[i].signal = session.signal("Signal" + std::to_string(i));
+        }
+        for (int64_t t = 0; t < sessionLength; t += sampleInterval)
+        {
+            const auto seconds = static_cast<double>(t) / 1e9;
+            for (auto& value : values)
+            {
+                value.value = 1900.0 + 1100.0 * std::sin(seconds / 60.0 + value.signal);
+            }
+            if (std::abs(t - sessionLength / 2) < 1'000'000'000)
+            {
+                values[0].value = 5500.0;
+            }
+            session.append(t, values);
+        }
+        return session;
+    }();
+    return store;
+}
+
+/**
+ * @brief Collects the values of one signal in a window of the session.
+ * @details Chunks outside the window are skipped by their zone maps, chunks inside are copied
+ * whole, only the two at the edges are scanned.
+ */
+void BM_SignalStoreRange(benchmark::State& state)
+{
+    const auto& store = makeSession();
+    const auto window = state.range(0) * 1'000'000'000;
+    const int64_t from = sessionLength / 3;
+    std::vector<int64_t> timestamps;
+    std::vector<double> values;
+    for (auto _ : state)
+    {
+        timestamps.clear();
+        values.clear();
+        store.range(1, from, from + window, timestamps, values);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.counters["values"] = static_cast<double>(values.size());
+}
+
+/**
+ * @brief Finds the samples of a rare peak over the whole session.
+ * @details Only the chunks whose maximum exceeds the threshold are scanned.
+ */
+void BM_SignalStoreAbove(benchmark::State& state)
+{
+    const auto& store = makeSession();
+    std::vector<int64_t> timestamps;
+    for (auto _ : state)
+    {
+        timestamps.clear();
+        store.above(0, 5000.0, 0, std::numeric_limits<int64_t>::max(), timestamps);
+        benchmark::DoNotOptimize(timestamps.data());
+    }
+    state.counters["matches"] = static_cast<double>(timestamps.size());
+    state.counters["chunks"] = static_cast<double>(store.chunkCount());
+}
+
+}  // namespace
+
+BENCHMARK(BM_SignalStoreRange)->Arg(10)->Arg(600);
+BENCHMARK(BM_SignalStoreAbove);
@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <string>
+#include <variant>
+
+#include "can_handler/dbc_handler/dbc_handler.hpp"
+#include "event_broker/event_broker.hpp"
+
+namespace {
+
+using ParseResult = std::variant<Core::DBCParsedEvent, Core::DBCParseErrorEvent>;
+
+constexpr auto vehicleDbc = R"(VERSION "1.0"
+
+NS_ :
+    CM_
+    BA_DEF_
+    VAL_TABLE_
+
+BS_:
+
+BU_: ECU Gateway
+
+BO_ 256 Engine: 8 ECU
+ SG_ Mode M : 0|4@1+ (1,0) [0|15] "" Gateway
+ SG_ Speed m1 : 8|16@1+ (0.01,-40) [-40|615.35] "km/h" Gateway,ECU
+ SG_ Torque : 24|12@0- (1E-001,0) [-204.8|204.7] "Nm" Gateway
+
+BO_ 2147484160 Extended: 4 Gateway
+ SG_ Door : 0|1@1+ (1,0) [0|1] "" ECU
+
+VAL_TABLE_ Unused 0 "Zero" ;
+CM_ "Network with a \"quoted\" name; and a semicolon";
+CM_ SG_ 256 Speed "Vehicle speed";
+CM_ BO_ -1 "Malformed comments are skipped; also this one";
+BA_DEF_ BO_ "GenMsgCycleTime" INT 0 10000;
+BA_DEF_ BO_ "GenMsgSendType" ENUM "Cyclic","OnEvent";
+BA_DEF_ SG_ "GenSigStartValue" INT 0 65535;
+BA_DEF_ "BusType" STRING ;
+BA_DEF_DEF_ "GenMsgCycleTime" 0;
+BA_DEF_DEF_ "GenMsgSendType" "OnEvent";
+BA_DEF_DEF_ "BusType" "CAN";
+BA_ "GenMsgCycleTime" BO_ 256 100;
+BA_ "GenMsgSendType" BO_ 256 0;
+BA_ "GenSigStartValue" SG_ 256 Speed 4000;
+VAL_ 256 Mode 0 "Off" 1 "Driving" ;
+VAL_ Environment 0 "Ignored" ;
+)";
+
+/**
+ * @brief Runs a DbcHandler on a broker and sends it parse requests for DBC files written by the
+ * test, the answer is received on the parser's worker thread.
+ */
+class DbcHandlerTest : public ::testing::Test
+{
+   protected:
+    void TearDown() override
+    {
+        Core::DbcSnapshotRegistry::instance().unbind(m_path.string());
+        std::filesystem::remove(m_path);
+    }
+
+    auto parse(const std::string& content) -> ParseResult
+    {
+        std::ofstream(m_path, std::ios::binary) << content;
+
+        std::promise<ParseResult> result;
+        const auto parsed = m_broker.subscribe<Core::DBCParsedEvent>(
+            [&](const Core::DBCParsedEvent& event) -> void { result.set_value(event); },
+            Core::SubscriptionOptions{.executor = Core::Executor::publisher()});
+        const auto failed = m_broker.subscribe<Core::DBCParseErrorEvent>(
+            [&](const Core::DBCParseErrorEvent& event) -> void { result.set_value(event); },
+            Core::SubscriptionOptions{.executor = Core::Executor::publisher()});
+
+        Core::ParseDBCRequestEvent request;
+        request.filePath = m_path.string();
+        request.interfaces = {"dbc-handler-test"};
+        m_broker.publish(request);
+
+        auto answer = result.get_future();
+        if (answer.wait_for(std::chrono::seconds(10)) != std::future_status::ready)
+        {
+            ADD_FAILURE() << "The parser did not answer";
+            return Core::DBCParseErrorEvent{};
+        }
+        return answer.get();
+    }
+
+    auto parseValid(const std::string& content) -> Core::DbcConfigPtr
+    {
+        const auto result = parse(content);
+        const auto* parsed = std::get_if<Core::DBCParsedEvent>(&result);
+        if (parsed == nullptr)
+        {
+            ADD_FAILURE() << std::get<Core::DBCParseErrorEvent>(result).errorMessage;
+            return nullptr;
+        }
+        return parsed->config;
+    }
+
+    auto parseError(const std::string& content) -> std::string
+    {
+        const auto result = parse(content);
+        const auto* failed = std::get_if<Core::DBCParseErrorEvent>(&result);
+        EXPECT_NE(failed, nullptr);
+        return failed ? failed->errorMessage : std::string();
+    }
+
+    const std::filesystem::path m_path = std::filesystem::temp_directory_path() /
+                                         (std::string(::testing::UnitTest::GetInstance()
+                                                          ->current_test_info()
+                                                          ->name()) +
+                                          ".dbc");
+    EventBroker::EventBroker m_broker;
+    CanHandler::DbcHandler m_handler{m_broker};
+};
+
+TEST_F(DbcHandlerTest, ParsesMessagesAndSignals)
+{
+    const auto config = parseValid(vehicleDbc);
+    ASSERT_NE(config, nullptr);
+    ASSERT_EQ(config->messages().size(), 2U);
+    ASSERT_EQ(config->nodeDefinitions().size(), 2U);
+    EXPECT_EQ(config->nodeDefinitions()[1], "Gateway");
+
+    const auto* engine = config->findMessage(256);
+    ASSERT_NE(engine, nullptr);
+    EXPECT_EQ(engine->messageName, "Engine");
+    EXPECT_EQ(engine->messageSize, 8U);
+    EXPECT_EQ(engine->transmitterName, "ECU");
+    ASSERT_EQ(config->signalsOf(*engine).size(), 3U);
+    EXPECT_NE(config->findMessage(2147484160U), nullptr);
+
+    const auto& mode = *config->findSignal(256, "Mode");
+    EXPECT_TRUE(mode.multiplexer);
+    EXPECT_EQ(mode.multiplexedBy, "");
+
+    const auto& speed = *config->findSignal(256, "Speed");
+    EXPECT_FALSE(speed.multiplexer);
+    EXPECT_EQ(speed.multiplexedBy, "1");
+    EXPECT_EQ(speed.startBit, 8U);
+    EXPECT_EQ(speed.signalSize, 16U);
+    EXPECT_TRUE(speed.byteOrder);
+    EXPECT_FALSE(speed.valueType);
+    EXPECT_DOUBLE_EQ(speed.factor, 0.01);
+    EXPECT_DOUBLE_EQ(speed.offset, -40.0);
+    EXPECT_DOUBLE_EQ(speed.minimum, -40.0);
+    EXPECT_DOUBLE_EQ(speed.maximum, 615.35);
+    EXPECT_EQ(speed.unit, "km/h");
+    ASSERT_EQ(config->receiversOf(speed).size(), 2U);
+    EXPECT_EQ(config->receiversOf(speed)[1], "ECU");
+
+    const auto& torque = *config->findSignal(256, "Torque");
+    EXPECT_FALSE(torque.byteOrder);
+    EXPECT_TRUE(torque.valueType);
+    EXPECT_DOUBLE_EQ(torque.factor, 0.1);
+}
+
+TEST_F(DbcHandlerTest, ParsesValueDescriptionsCommentsAndAttributes)
+{
+    const auto config = parseValid(vehicleDbc);
+    ASSERT_NE(config, nullptr);
+
+    const auto& mode = *config->findSignal(256, "Mode");
+    EXPECT_EQ(config->describeValue(mode, 1.0), "Driving");
+
+    ASSERT_EQ(config->comments().size(), 2U);
+    EXPECT_EQ(config->comments()[0], R"(Network with a "quoted" name; and a semicolon)");
+    EXPECT_EQ(config->comments()[1], "Vehicle speed");
+
+    const auto* engine = config->findMessage(256);
+    EXPECT_EQ(engine->cycleTimeMs, 100U);
+    EXPECT_EQ(engine->sendType, "Cyclic");
+    EXPECT_EQ(config->findMessage(2147484160U)->sendType, "OnEvent");
+    EXPECT_EQ(config->networkAttribute("BusType"), "CAN");
+    ASSERT_TRUE(config->findSignal(256, "Speed")->startValue.has_value());
+    EXPECT_DOUBLE_EQ(*config->findSignal(256, "Speed")->startValue, 0.0);
+}
+
+TEST_F(DbcHandlerTest, ReportsTheLineOfAMalformedMessage)
+{
+    const auto error = parseError("VERSION \"\"\n\nBO_ 256 Engine: 8 ECU\n"
+                                  " SG_ Speed : 8|16@1+ (0.01,-40) [-40|615.35\n\nBO_ 257");
+    EXPECT_NE(error.find("Malformed BO_ statement in line 4"), std::string::npos) << error;
+}
+
+TEST_F(DbcHandlerTest, RejectsNegativeIds)
+{
+    const auto error = parseError("BO_ -256 Engine: 8 ECU\n");
+    EXPECT_NE(error.find("Malformed BO_"), std::string::npos) << error;
+}
+
+TEST_F(DbcHandlerTest, ReportsMissingFiles)
+{
+    std::promise<std::string> result;
+    const auto failed = m_broker.subscribe<Core::DBCParseErrorEvent>(
+        [&](const Core::DBCParseErrorEvent& event) -> void { result.set_value(event.filePath); },
+        Core::SubscriptionOptions{.executor = Core::Executor::publisher()});
+    Core::ParseDBCRequestEvent request;
+    request.filePath = (std::filesystem::temp_directory_path() / "missing.dbc").string();
+    m_broker.publish(request);
+
+    auto answer = result.get_future();
+    ASSERT_EQ(answer.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    EXPECT_EQ(answer.get(), request.filePath);
+}
+
+}  // namespace
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string_view>
+
+#include "can_handler/dbc_handler/dbc_tokenizer.hpp"
+
+namespace {
+
+using CanHandler::DbcTokenizer;
+
+TEST(DbcTokenizerTest, SplitsWordsNumbersAndPunctuation)
+{
+    DbcTokenizer tokens(" SG_ Speed : 7|16@0+ (1E-005,-40) [0|1.5e+3] \"km/h\" ECU,Gateway\n");
+    for (const std::string_view expected :
+         {"SG_", "Speed", ":", "7", "|", "16", "@", "0", "+", "(", "1E-005", ",", "-", "40",
+          ")", "[", "0", "|", "1.5e+3", "]", "km/h", "ECU", ",", "Gateway"})
+    {
+        EXPECT_EQ(tokens.next(), expected);
+    }
+    EXPECT_TRUE(tokens.atEnd());
+    EXPECT_EQ(tokens.next(), "");
+}
+
+TEST(DbcTokenizerTest, QuotedStringsKeepEscapedQuotes)
+{
+    DbcTokenizer tokens(R"(CM_ "Say \"hi\"; twice" ; "C:\\" ;)");
+    EXPECT_TRUE(tokens.accept("CM_"));
+    const auto quoted = tokens.next();
+    EXPECT_EQ(quoted, R"(Say \"hi\"; twice)");
+    EXPECT_EQ(DbcTokenizer::unescape(quoted), R"(Say "hi"; twice)");
+    EXPECT_TRUE(tokens.accept(";"));
+
+    // An escaped backslash does not escape the closing quote.
+    const auto path = tokens.next();
+    EXPECT_EQ(DbcTokenizer::unescape(path), R"(C:\)");
+    EXPECT_TRUE(tokens.accept(";"));
+    EXPECT_TRUE(tokens.atEnd());
+}
+
+TEST(DbcTokenizerTest, SkipStatementIgnoresSemicolonsInStrings)
+{
+    DbcTokenizer tokens(R"(CM_ SG_ x "a; \"b;\" c"; BO_)");
+    tokens.skipStatement();
+    EXPECT_EQ(tokens.next(), "BO_");
+
+    // An unterminated string consumes the rest of the content.
+    DbcTokenizer unterminated(R"(CM_ "open; BO_)");
+    unterminated.skipStatement();
+    EXPECT_TRUE(unterminated.atEnd());
+}
+
+TEST(DbcTokenizerTest, ConvertsSignedNumbers)
+{
+    DbcTokenizer tokens("-40 +3 -0.5 12abc");
+    EXPECT_EQ(tokens.nextNumber<int>(), -40);
+    EXPECT_EQ(tokens.nextNumber<int>(), 3);
+    EXPECT_EQ(tokens.nextNumber<double>(), -0.5);
+    EXPECT_FALSE(tokens.nextNumber<int>().has_value());
+}
+
+TEST(DbcTokenizerTest, UnsignedNumbersRejectTheMinusSign)
+{
+    DbcTokenizer tokens("-5 7");
+    EXPECT_FALSE(tokens.nextNumber<uint32_t>().has_value());
+    EXPECT_EQ(tokens.nextNumber<uint32_t>(), 7U);
+}
+
+}  // namespace
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "core/util/dbc_signal_decoder.hpp"
+
+namespace {
+
+auto makeSignal(const uint32_t startBit, const uint32_t size, const bool intel,
+                const bool isSigned = false) -> Core::FlatDbcSignal
+{
+    Core::FlatDbcSignal signal;
+    signal.startBit = startBit;
+    signal.signalSize = size;
+    signal.byteOrder = intel;
+    signal.valueType = isSigned;
+    return signal;
+}
+
+const std::array<uint8_t, 8> frame{0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0};
+
+TEST(DbcSignalDecoderTest, DecodesIntelSignals)
+{
+    EXPECT_EQ(Core::rawSignalValue(makeSignal(0, 8, true), frame), 0x12U);
+    EXPECT_EQ(Core::rawSignalValue(makeSignal(0, 16, true), frame), 0x3412U);
+    // Bits 4 to 11: the upper nibble of the first byte and the lower one of the second.
+    EXPECT_EQ(Core::rawSignalValue(makeSignal(4, 8, true), frame), 0x41U);
+    EXPECT_EQ(Core::rawSignalValue(makeSignal(0, 64, true), frame), 0xF0DEBC9A78563412U);
+}
+
+TEST(DbcSignalDecoderTest, DecodesMotorolaSignals)
+{
+    // Starts at the most significant bit of the first byte.
+    EXPECT_EQ(Core::rawSignalValue(makeSignal(7, 8, false), frame), 0x12U);
+    EXPECT_EQ(Core::rawSignalValue(makeSignal(7, 16, false), frame), 0x1234U);
+    // Starts at bit 3 of the first byte and continues with bit 7 of the second.
+    EXPECT_EQ(Core::rawSignalValue(makeSignal(3, 8, false), frame), 0x23U);
+}
+
+TEST(DbcSignalDecoderTest, SignExtendsSignedSignals)
+{
+    const std::array<uint8_t, 2> data{0xFE, 0x7F};
+    EXPECT_EQ(Core::physicalSignalValue(makeSignal(0, 8, true, true), data), -2.0);
+    EXPECT_EQ(Core::physicalSignalValue(makeSignal(0, 8, true), data), 254.0);
+    EXPECT_EQ(Core::physicalSignalValue(makeSignal(8, 8, true, true), data), 127.0);
+
+    auto scaled = makeSignal(0, 8, true, true);
+    scaled.factor = 0.5;
+    scaled.offset = 10.0;
+    EXPECT_EQ(Core::physicalSignalValue(scaled, data), 9.0);
+}
+
+TEST(DbcSignalDecoderTest, RejectsSignalsBeyondThePayload)
+{
+    const auto shortFrame = std::span(frame).first(2);
+    EXPECT_EQ(Core::rawSignalValue(makeSignal(8, 8, true), shortFrame), 0x34U);
+    EXPECT_FALSE(Core::rawSignalValue(makeSignal(12, 8, true), shortFrame).has_value());
+    EXPECT_FALSE(Core::rawSignalValue(makeSignal(15, 16, false), shortFrame).has_value());
+    EXPECT_FALSE(Core::rawSignalValue(makeSignal(0, 0, true), frame).has_value());
+    EXPECT_FALSE(Core::physicalSignalValue(makeSignal(0, 65, true), frame).has_value());
+}
+
+}  // namespace
@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "core/util/dbc_snapshot_registry.hpp"
+
+namespace {
+
+using Core::DbcSnapshotRegistry;
+
+/** @brief A DBC with one signal-less message per ID, named after @p name and the ID. */
+auto makeConfig(const std::string& name, const std::initializer_list<uint32_t> messageIds)
+    -> Core::DbcConfigPtr
+{
+    Core::DbcConfig config;
+    for (const auto id : messageIds)
+    {
+        config.messageDefinitions.push_back({id, name + std::to_string(id), 8, "ECU", {}});
+    }
+    return Core::FlatDbcConfig::fromConfig(config);
+}
+
+auto interfaces(const std::initializer_list<std::string> names) -> std::vector<std::string>
+{
+    return names;
+}
+
+/** @brief The name of the message routed for an ID on an interface, empty if there is none. */
+auto routedName(DbcSnapshotRegistry& registry, const std::string& interfaceName,
+                const uint32_t messageId) -> std::string
+{
+    const auto routing = registry.routing(registry.resolveInterface(interfaceName));
+    const auto* route = routing ? routing->find(messageId) : nullptr;
+    return route ? route->message->messageName : std::string();
+}
+
+TEST(DbcSnapshotRegistryTest, RoutesEachInterfaceToItsDbc)
+{
+    DbcSnapshotRegistry registry;
+    const auto powertrain = makeConfig("Powertrain", {0x100, 0x101});
+    const auto body = makeConfig("Body", {0x200});
+    EXPECT_TRUE(registry.bind(powertrain, "powertrain.dbc", interfaces({"can0"})).empty());
+    EXPECT_TRUE(registry.bind(body, "body.dbc", interfaces({"can1"})).empty());
+
+    EXPECT_EQ(routedName(registry, "can0", 0x100), "Powertrain256");
+    EXPECT_EQ(routedName(registry, "can0", 0x200), "");
+    EXPECT_EQ(routedName(registry, "can1", 0x200), "Body512");
+    EXPECT_EQ(routedName(registry, "can1", 0x101), "");
+    EXPECT_EQ(registry.current(), body);
+
+    const auto can0 = registry.resolveInterface("can0");
+    const auto route = registry.routing(can0)->find(0x101);
+    ASSERT_NE(route, nullptr);
+    EXPECT_EQ(route->config, powertrain.get());
+    EXPECT_EQ(registry.interfaceName(can0), "can0");
+    EXPECT_EQ(registry.interfaceName(DbcSnapshotRegistry::maxInterfaces - 1), "");
+
+    // Interfaces without a bound DBC have no routing table.
+    EXPECT_EQ(registry.routing(registry.resolveInterface("can2")), nullptr);
+    EXPECT_EQ(registry.routing(DbcSnapshotRegistry::maxInterfaces), nullptr);
+}
+
+TEST(DbcSnapshotRegistryTest, ReportsIdConflictsAndKeepsTheEarlierDbc)
+{
+    DbcSnapshotRegistry registry;
+    registry.bind(makeConfig("First", {0x100, 0x101}), "first.dbc", interfaces({"can0"}));
+    const auto conflicts =
+        registry.bind(makeConfig("Second", {0x101, 0x102}), "second.dbc", interfaces({"can0"}));
+
+    ASSERT_EQ(conflicts.size(), 1U);
+    EXPECT_EQ(conflicts.front().messageId, 0x101U);
+    EXPECT_EQ(conflicts.front().interfaceName, "can0");
+    EXPECT_EQ(conflicts.front().existingFilePath, "first.dbc");
+    EXPECT_EQ(conflicts.front().conflictingFilePath, "second.dbc");
+    EXPECT_EQ(routedName(registry, "can0", 0x101), "First257");
+    EXPECT_EQ(routedName(registry, "can0", 0x102), "Second258");
+
+    // The same IDs on another interface do not collide.
+    EXPECT_TRUE(
+        registry.bind(makeConfig("Third", {0x101}), "third.dbc", interfaces({"can1"})).empty());
+}
+
+TEST(DbcSnapshotRegistryTest, SpecificBindingsWinOverBindingsToAll)
+{
+    DbcSnapshotRegistry registry;
+    registry.resolveInterface("can0");
+    registry.bind(makeConfig("Generic", {0x100, 0x300}), "generic.dbc", {});
+    const auto conflicts =
+        registry.bind(makeConfig("Specific", {0x100}), "specific.dbc", interfaces({"can0"}));
+
+    ASSERT_EQ(conflicts.size(), 1U);
+    EXPECT_EQ(conflicts.front().existingFilePath, "specific.dbc");
+    EXPECT_EQ(conflicts.front().conflictingFilePath, "generic.dbc");
+    EXPECT_EQ(routedName(registry, "can0", 0x100), "Specific256");
+    EXPECT_EQ(routedName(registry, "can0", 0x300), "Generic768");
+
+    // A binding to all interfaces also covers interfaces registered afterwards.
+    EXPECT_EQ(routedName(registry, "can1", 0x100), "Generic256");
+}
+
+TEST(DbcSnapshotRegistryTest, ReportsConflictsOfBindingsToAllBeforeAnyInterfaceExists)
+{
+    DbcSnapshotRegistry registry;
+    registry.bind(makeConfig("First", {0x100, 0x101}), "first.dbc", {});
+    const auto conflicts = registry.bind(makeConfig("Second", {0x101}), "second.dbc", {});
+
+    ASSERT_EQ(conflicts.size(), 1U);
+    EXPECT_EQ(conflicts.front().messageId, 0x101U);
+    EXPECT_EQ(conflicts.front().interfaceName, "");
+    EXPECT_EQ(conflicts.front().existingFilePath, "first.dbc");
+    EXPECT_EQ(conflicts.front().conflictingFilePath, "second.dbc");
+    EXPECT_EQ(routedName(registry, "can0", 0x101), "First257");
+
+    // Once interfaces exist the collision is still reported once, not per interface.
+    registry.resolveInterface("can1");
+    EXPECT_EQ(registry.bind(makeConfig("Second", {0x101}), "second.dbc", {}).size(), 1U);
+}
+
+TEST(DbcSnapshotRegistryTest, BindingToEveryInterfaceByNameIsSpecific)
+{
+    DbcSnapshotRegistry registry;
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < DbcSnapshotRegistry::maxInterfaces; ++i)
+    {
+        names.push_back("can" + std::to_string(i));
+    }
+    registry.bind(makeConfig("Generic", {0x100}), "generic.dbc", {});
+    const auto conflicts = registry.bind(makeConfig("Named", {0x100}), "named.dbc", names);
+
+    EXPECT_EQ(conflicts.size(), DbcSnapshotRegistry::maxInterfaces);
+    EXPECT_EQ(conflicts.front().existingFilePath, "named.dbc");
+    EXPECT_EQ(routedName(registry, "can0", 0x100), "Named256");
+    EXPECT_EQ(routedName(registry, "can31", 0x100), "Named256");
+}
+
+TEST(DbcSnapshotRegistryTest, RebindKeepsTheLoadOrder)
+{
+    DbcSnapshotRegistry registry;
+    registry.bind(makeConfig("First", {0x100}), "first.dbc", interfaces({"can0"}));
+    registry.bind(makeConfig("Second", {0x100}), "second.dbc", interfaces({"can0"}));
+    const auto generation = registry.generation();
+
+    const auto reloaded = makeConfig("Reloaded", {0x100});
+    const auto conflicts = registry.bind(reloaded, "first.dbc", interfaces({"can0"}));
+    EXPECT_GT(registry.generation(), generation);
+    EXPECT_EQ(registry.current(), reloaded);
+
+    ASSERT_EQ(conflicts.size(), 1U);
+    EXPECT_EQ(conflicts.front().existingFilePath, "first.dbc");
+    EXPECT_EQ(routedName(registry, "can0", 0x100), "Reloaded256");
+    EXPECT_EQ(registry.routing(registry.resolveInterface("can0"))->configs.size(), 2U);
+
+    // Moving the binding to another interface frees the ID on the first one.
+    registry.bind(reloaded, "first.dbc", interfaces({"can1"}));
+    EXPECT_EQ(routedName(registry, "can0", 0x100), "Second256");
+    EXPECT_EQ(routedName(registry, "can1", 0x100), "Reloaded256");
+}
+
+TEST(DbcSnapshotRegistryTest, UnbindReleasesTheIds)
+{
+    DbcSnapshotRegistry registry;
+    const auto first = makeConfig("First", {0x100});
+    registry.bind(first, "first.dbc", interfaces({"can0"}));
+    registry.bind(makeConfig("Second", {0x100}), "second.dbc", interfaces({"can0"}));
+
+    // A table handed out before keeps its configurations alive.
+    const auto previous = registry.routing(registry.resolveInterface("can0"));
+
+    registry.unbind("first.dbc");
+    EXPECT_EQ(routedName(registry, "can0", 0x100), "Second256");
+    EXPECT_EQ(previous->find(0x100)->config, first.get());
+
+    registry.unbind("second.dbc");
+    EXPECT_EQ(registry.routing(registry.resolveInterface("can0")), nullptr);
+    EXPECT_EQ(registry.current(), nullptr);
+}
+
+TEST(DbcSnapshotRegistryTest, RejectsTooManyInterfaces)
+{
+    DbcSnapshotRegistry registry;
+    for (std::size_t i = 0; i < DbcSnapshotRegistry::maxInterfaces; ++i)
+    {
+        EXPECT_EQ(registry.resolveInterface("can" + std::to_string(i)), i);
+    }
+    EXPECT_THROW(registry.resolveInterface("overflow"), std::length_error);
+    EXPECT_THROW(
+        registry.bind(makeConfig("Late", {0x100}), "late.dbc", interfaces({"can0", "overflow"})),
+        std::length_error);
+    EXPECT_EQ(registry.routing(0), nullptr);
+}
+
+}  // namespace
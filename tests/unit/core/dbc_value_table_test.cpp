@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "core/util/dbc_value_table.hpp"
+
+namespace {
+
+using Core::DbcValueDescription;
+using Core::DbcValueTable;
+
+TEST(DbcValueTableTest, SmallRangeIsDense)
+{
+    const std::vector<DbcValueDescription> descriptions{
+        {3, "Three"}, {-2, "MinusTwo"}, {0, "Zero"}, {60, "Sixty"}};
+    const DbcValueTable table(descriptions);
+
+    EXPECT_TRUE(table.isDense());
+    EXPECT_EQ(table.lookup(-2), "MinusTwo");
+    EXPECT_EQ(table.lookup(0), "Zero");
+    EXPECT_EQ(table.lookup(3), "Three");
+    EXPECT_EQ(table.lookup(60), "Sixty");
+    EXPECT_EQ(table.lookup(1), "");
+    EXPECT_EQ(table.lookup(-3), "");
+    EXPECT_EQ(table.lookup(61), "");
+    EXPECT_EQ(table.lookup(std::numeric_limits<int64_t>::min()), "");
+    EXPECT_EQ(table.lookup(std::numeric_limits<int64_t>::max()), "");
+}
+
+TEST(DbcValueTableTest, SparseRangeIsSorted)
+{
+    const std::vector<DbcValueDescription> descriptions{
+        {1000, "Thousand"}, {0, "Zero"}, {-500, "MinusFiveHundred"}, {0xFFFF, "Invalid"}};
+    const DbcValueTable table(descriptions);
+
+    EXPECT_FALSE(table.isDense());
+    EXPECT_EQ(table.lookup(-500), "MinusFiveHundred");
+    EXPECT_EQ(table.lookup(0), "Zero");
+    EXPECT_EQ(table.lookup(1000), "Thousand");
+    EXPECT_EQ(table.lookup(0xFFFF), "Invalid");
+    EXPECT_EQ(table.lookup(1), "");
+    EXPECT_EQ(table.lookup(-501), "");
+    EXPECT_EQ(table.lookup(0x10000), "");
+}
+
+TEST(DbcValueTableTest, DenseWhenRangeIsWellOccupied)
+{
+    // 100 values spread over a range of 300: above denseMinimumSpan, within the load factor.
+    std::vector<DbcValueDescription> descriptions;
+    for (int i = 0; i < 100; ++i)
+    {
+        descriptions.push_back({static_cast<double>(i * 3), "Value" + std::to_string(i * 3)});
+    }
+    const DbcValueTable table(descriptions);
+
+    EXPECT_TRUE(table.isDense());
+    EXPECT_EQ(table.lookup(297), "Value297");
+    EXPECT_EQ(table.lookup(298), "");
+}
+
+TEST(DbcValueTableTest, ExtremeRawValuesStaySorted)
+{
+    // The distance between the two values overflows a signed 64 bit integer.
+    const std::vector<DbcValueDescription> descriptions{{-9.0e18, "Lowest"}, {9.0e18, "Highest"}};
+    const DbcValueTable table(descriptions);
+
+    EXPECT_FALSE(table.isDense());
+    EXPECT_EQ(table.lookup(-9'000'000'000'000'000'000), "Lowest");
+    EXPECT_EQ(table.lookup(9'000'000'000'000'000'000), "Highest");
+    EXPECT_EQ(table.lookup(0), "");
+}
+
+TEST(DbcValueTableTest, LaterDescriptionOverridesEarlier)
+{
+    const std::vector<DbcValueDescription> dense{{1, "Old"}, {2, "Two"}, {1, "New"}};
+    EXPECT_EQ(DbcValueTable(dense).lookup(1), "New");
+
+    const std::vector<DbcValueDescription> sparse{{1, "Old"}, {100000, "Far"}, {1, "New"}};
+    const DbcValueTable table(sparse);
+    EXPECT_FALSE(table.isDense());
+    EXPECT_EQ(table.lookup(1), "New");
+    EXPECT_EQ(table.lookup(100000), "Far");
+}
+
+TEST(DbcValueTableTest, LooksUpPhysicalValues)
+{
+    const std::vector<DbcValueDescription> descriptions{{0, "Off"}, {1, "On"}, {3, "Error"}};
+    const DbcValueTable table(descriptions);
+
+    // raw = (physical - offset) / factor, rounded to the nearest raw value.
+    EXPECT_EQ(table.lookupPhysical(-40.0, 0.5, -40.0), "Off");
+    EXPECT_EQ(table.lookupPhysical(-39.5, 0.5, -40.0), "On");
+    EXPECT_EQ(table.lookupPhysical(-38.5, 0.5, -40.0), "Error");
+    EXPECT_EQ(table.lookupPhysical(-39.0, 0.5, -40.0), "");
+    EXPECT_EQ(table.lookupPhysical(0.0, 0.0, 0.0), "");
+}
+
+TEST(DbcValueTableTest, EmptyTableDescribesNothing)
+{
+    const DbcValueTable table({});
+    EXPECT_FALSE(table.isDense());
+    EXPECT_EQ(table.lookup(0), "");
+}
+
+}  // namespace
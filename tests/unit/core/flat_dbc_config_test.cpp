@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+
+#include "core/util/flat_dbc_config.hpp"
+
+namespace {
+
+using Core::DbcAttributeObjectType;
+using Core::DbcAttributeValueType;
+
+auto makeSignal(std::string name, const double factor = 1.0, const double offset = 0.0)
+    -> Core::DbcSignalDescription
+{
+    return {std::move(name), false, "", 0, 8, true, false, factor, offset, 0.0, 255.0, "", {}};
+}
+
+/**
+ * @brief Two messages that both have a signal named "Counter", with value descriptions, comments
+ * and the attributes the flat configuration resolves.
+ */
+auto makeConfig() -> Core::DbcConfig
+{
+    Core::DbcConfig config;
+    config.nodeDefinitions = {"ECU", "Gateway"};
+
+    auto gear = makeSignal("Gear");
+    gear.receivers = {"Gateway", "ECU"};
+    auto speed = makeSignal("Speed", 0.5, -10.0);
+    config.messageDefinitions.push_back(
+        {0x100, "Engine", 8, "ECU", {makeSignal("Counter"), gear, speed}});
+    config.messageDefinitions.push_back(
+        {0x200, "Body", 4, "Gateway", {makeSignal("Counter"), makeSignal("Door")}});
+
+    config.signalValueDescriptions.push_back({0x100, "Gear", {{0, "Neutral"}, {1, "First"}}});
+    config.signalValueDescriptions.push_back({0x100, "Speed", {{20, "Limit"}}});
+    // Neither the message nor the signal exist, both are ignored.
+    config.signalValueDescriptions.push_back({0x300, "Gear", {{0, "Lost"}}});
+    config.signalValueDescriptions.push_back({0x200, "Gear", {{0, "Lost"}}});
+    config.comments = {"A comment"};
+
+    config.attributeDefinitions.push_back(
+        {DbcAttributeObjectType::Message, "GenMsgCycleTime", DbcAttributeValueType::Int, 0,
+         10000, {}, "0"});
+    config.attributeDefinitions.push_back({DbcAttributeObjectType::Message, "GenMsgSendType",
+                                           DbcAttributeValueType::Enum, 0, 0,
+                                           {"Cyclic", "OnEvent"}, "1"});
+    config.attributeDefinitions.push_back(
+        {DbcAttributeObjectType::Signal, "GenSigStartValue", DbcAttributeValueType::Int, 0, 255,
+         {}, ""});
+    config.attributeDefinitions.push_back({DbcAttributeObjectType::Network, "BusType",
+                                           DbcAttributeValueType::String, 0, 0, {}, "CAN"});
+
+    config.attributeValues.push_back(
+        {"GenMsgCycleTime", DbcAttributeObjectType::Message, "", 0x100, "", "50"});
+    // A later value for the same object overrides the earlier one.
+    config.attributeValues.push_back(
+        {"GenMsgCycleTime", DbcAttributeObjectType::Message, "", 0x100, "", "100"});
+    config.attributeValues.push_back(
+        {"GenMsgSendType", DbcAttributeObjectType::Message, "", 0x100, "", "0"});
+    config.attributeValues.push_back(
+        {"GenSigStartValue", DbcAttributeObjectType::Signal, "", 0x100, "Speed", "40"});
+    config.attributeValues.push_back(
+        {"Undefined", DbcAttributeObjectType::Network, "", 0, "", "1"});
+    return config;
+}
+
+TEST(FlatDbcConfigTest, FindsMessagesByIdAndName)
+{
+    const auto config = Core::FlatDbcConfig::fromConfig(makeConfig());
+    ASSERT_EQ(config->messages().size(), 2U);
+    ASSERT_EQ(config->signalDescriptions().size(), 5U);
+
+    const auto* engine = config->findMessage(0x100);
+    ASSERT_NE(engine, nullptr);
+    EXPECT_EQ(engine->messageName, "Engine");
+    EXPECT_EQ(config->findMessage("Body"), &config->messages()[1]);
+    EXPECT_EQ(config->findMessage(0x300), nullptr);
+    EXPECT_EQ(config->findMessage("Chassis"), nullptr);
+
+    const auto engineSignals = config->signalsOf(*engine);
+    ASSERT_EQ(engineSignals.size(), 3U);
+    EXPECT_EQ(engineSignals[0].signalName, "Counter");
+    EXPECT_EQ(engineSignals[2].signalName, "Speed");
+    EXPECT_EQ(&config->messageOf(engineSignals[2]), engine);
+}
+
+TEST(FlatDbcConfigTest, SignalNamesAreScopedToTheirMessage)
+{
+    const auto config = Core::FlatDbcConfig::fromConfig(makeConfig());
+    const auto* engineCounter = config->findSignal(0x100, "Counter");
+    const auto* bodyCounter = config->findSignal(0x200, "Counter");
+    ASSERT_NE(engineCounter, nullptr);
+    ASSERT_NE(bodyCounter, nullptr);
+    EXPECT_NE(engineCounter, bodyCounter);
+    EXPECT_EQ(config->messageOf(*bodyCounter).messageId, 0x200U);
+
+    EXPECT_EQ(config->findSignal(0x200, "Gear"), nullptr);
+    EXPECT_EQ(config->findSignal(0x300, "Counter"), nullptr);
+
+    const auto receivers = config->receiversOf(*config->findSignal(0x100, "Gear"));
+    ASSERT_EQ(receivers.size(), 2U);
+    EXPECT_EQ(receivers[0], "Gateway");
+    EXPECT_EQ(receivers[1], "ECU");
+    EXPECT_TRUE(config->receiversOf(*engineCounter).empty());
+}
+
+TEST(FlatDbcConfigTest, AttachesValueDescriptionsToTheirSignals)
+{
+    const auto config = Core::FlatDbcConfig::fromConfig(makeConfig());
+    const auto& gear = *config->findSignal(0x100, "Gear");
+    ASSERT_EQ(config->valueDescriptionsOf(gear).size(), 2U);
+    EXPECT_NE(config->valueTableOf(gear), nullptr);
+    EXPECT_EQ(config->describeValue(gear, 1.0), "First");
+    EXPECT_EQ(config->describeValue(gear, 2.0), "");
+
+    // Descriptions hold raw values, describeValue() takes physical ones: 20 * 0.5 - 10.
+    const auto& speed = *config->findSignal(0x100, "Speed");
+    EXPECT_EQ(config->describeValue(speed, 0.0), "Limit");
+    EXPECT_EQ(config->describeValue(speed, 20.0), "");
+
+    const auto& door = *config->findSignal(0x200, "Door");
+    EXPECT_EQ(config->valueTableOf(door), nullptr);
+    EXPECT_EQ(config->describeValue(door, 0.0), "");
+}
+
+TEST(FlatDbcConfigTest, ResolvesAttributes)
+{
+    const auto config = Core::FlatDbcConfig::fromConfig(makeConfig());
+    const auto& engine = *config->findMessage(0x100);
+    const auto& body = *config->findMessage(0x200);
+
+    EXPECT_EQ(engine.cycleTimeMs, 100U);
+    EXPECT_EQ(engine.sendType, "Cyclic");
+    EXPECT_EQ(body.cycleTimeMs, 0U);
+    EXPECT_EQ(body.sendType, "OnEvent");
+    EXPECT_EQ(config->messageAttribute(engine, "GenMsgCycleTime"), "100");
+    EXPECT_EQ(config->networkAttribute("BusType"), "CAN");
+    EXPECT_EQ(config->networkAttribute("Undefined"), "");
+    EXPECT_EQ(config->findAttributeDefinition("Undefined"), nullptr);
+    ASSERT_NE(config->findAttributeDefinition("GenMsgSendType"), nullptr);
+    EXPECT_EQ(config->findAttributeDefinition("GenMsgSendType")->defaultValue, "OnEvent");
+
+    // The start value is stored raw and resolved with the scaling of the signal.
+    const auto& speed = *config->findSignal(0x100, "Speed");
+    ASSERT_TRUE(speed.startValue.has_value());
+    EXPECT_DOUBLE_EQ(*speed.startValue, 10.0);
+    EXPECT_FALSE(config->findSignal(0x100, "Gear")->startValue.has_value());
+}
+
+TEST(FlatDbcConfigTest, ContentHashCoversDecodingOnly)
+{
+    const auto hash = Core::FlatDbcConfig::fromConfig(makeConfig())->contentHash();
+    EXPECT_EQ(Core::FlatDbcConfig::fromConfig(makeConfig())->contentHash(), hash);
+
+    auto commented = makeConfig();
+    commented.comments.push_back("Another comment");
+    commented.attributeValues.clear();
+    EXPECT_EQ(Core::FlatDbcConfig::fromConfig(commented)->contentHash(), hash);
+
+    auto rescaled = makeConfig();
+    rescaled.messageDefinitions.front().signalDescriptions.back().factor = 0.25;
+    EXPECT_NE(Core::FlatDbcConfig::fromConfig(rescaled)->contentHash(), hash);
+
+    auto relabeled = makeConfig();
+    relabeled.signalValueDescriptions.front().signalDescriptions.back().meaning = "Second";
+    EXPECT_NE(Core::FlatDbcConfig::fromConfig(relabeled)->contentHash(), hash);
+}
+
+}  // namespace
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/util/payload_pool.hpp"
+
+namespace {
+
+using Core::PayloadPool;
+using Core::PayloadRef;
+
+/** @brief Counts the payloads alive, to check that the pool releases its slabs. */
+struct Counted {
+    Counted()
+    {
+        ++alive;
+    }
+    Counted(const Counted&) = delete;
+    auto operator=(const Counted&) -> Counted& = delete;
+    ~Counted()
+    {
+        --alive;
+    }
+
+    std::string text;
+
+    static inline std::atomic<int> alive{0};
+};
+
+TEST(PayloadPoolTest, GrowsBySlabsOfDoublingSize)
+{
+    PayloadPool<int> pool(4);
+    EXPECT_EQ(pool.capacity(), 0U);
+    EXPECT_EQ(pool.available(), 0U);
+
+    std::vector<PayloadRef<int>> handles;
+    handles.push_back(pool.acquire());
+    EXPECT_EQ(pool.capacity(), 4U);
+    EXPECT_EQ(pool.available(), 3U);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        handles.push_back(pool.acquire());
+    }
+    EXPECT_EQ(pool.capacity(), 12U);
+    EXPECT_EQ(pool.available(), 7U);
+
+    handles.clear();
+    EXPECT_EQ(pool.capacity(), 12U);
+    EXPECT_EQ(pool.available(), 12U);
+}
+
+TEST(PayloadPoolTest, RecyclesWithoutGrowingInSteadyState)
+{
+    PayloadPool<std::string> pool(8);
+    std::vector<PayloadRef<std::string>> inFlight;
+    for (int round = 0; round < 100; ++round)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            auto handle = pool.acquire();
+            handle.edit() = "payload that does not fit into the small string buffer";
+            inFlight.push_back(std::move(handle));
+        }
+        inFlight.clear();
+    }
+    EXPECT_EQ(pool.capacity(), 8U);
+    EXPECT_EQ(pool.available(), 8U);
+
+    // Recycled payloads keep their content and their capacity.
+    const auto handle = pool.acquire();
+    EXPECT_EQ(*handle, "payload that does not fit into the small string buffer");
+}
+
+TEST(PayloadPoolTest, PayloadReturnsWithTheLastHandle)
+{
+    PayloadPool<int> pool(2);
+    auto handle = pool.acquire();
+    handle.edit() = 7;
+    const auto copy = handle;
+    EXPECT_EQ(copy.useCount(), 2U);
+    EXPECT_EQ(pool.available(), 1U);
+
+    handle = PayloadRef<int>();
+    EXPECT_FALSE(handle);
+    EXPECT_EQ(*copy, 7);
+    EXPECT_EQ(copy.useCount(), 1U);
+    EXPECT_EQ(pool.available(), 1U);
+}
+
+TEST(PayloadPoolTest, HandlesOutliveThePool)
+{
+    std::optional<PayloadRef<Counted>> survivor;
+    {
+        PayloadPool<Counted> pool(4);
+        auto handle = pool.acquire();
+        handle.edit().text = "survivor";
+        survivor = std::move(handle);
+        EXPECT_EQ(Counted::alive, 4);
+    }
+    // The slab stays until the last handle is gone.
+    EXPECT_EQ(Counted::alive, 4);
+    EXPECT_EQ((*survivor)->text, "survivor");
+    survivor.reset();
+    EXPECT_EQ(Counted::alive, 0);
+}
+
+TEST(PayloadPoolTest, ThreadsShareThePool)
+{
+    PayloadPool<int> pool(16);
+    constexpr int threads = 4;
+    constexpr int perThread = 20000;
+    {
+        std::vector<std::jthread> workers;
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&pool, t]() -> void {
+                std::vector<PayloadRef<int>> held;
+                for (int i = 0; i < perThread; ++i)
+                {
+                    auto handle = pool.acquire();
+                    handle.edit() = t;
+                    held.push_back(std::move(handle));
+                    if (held.size() == 8)
+                    {
+                        for (const auto& payload : held)
+                        {
+                            EXPECT_EQ(*payload, t);
+                        }
+                        held.clear();
+                    }
+                }
+            });
+        }
+    }
+    // Every payload came back, no block was handed out twice.
+    EXPECT_EQ(pool.available(), pool.capacity());
+    EXPECT_LE(pool.capacity(), static_cast<std::size_t>(16 + 32 + 64));
+}
+
+}  // namespace
@@ -0,0 +1,851 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/event/lifecycle_event.hpp"
+#include "event_broker/event_broker.hpp"
+
+namespace {
+
+struct Sample {
+    int value;
+};
+
+struct Trigger {
+    int count;
+};
+
+/** @brief A keyed event, routed by its ID and interface like a received CAN frame. */
+struct Frame {
+    uint32_t id;
+    uint8_t interfaceId;
+    int value;
+};
+
+auto eventKey(const Frame& frame) -> Core::EventKey
+{
+    return {frame.id, frame.interfaceId};
+}
+
+/**
+ * @brief The test thread is a consumer of the broker, events published on another thread are
+ * queued in the mailboxes of its subscriptions until the test drains them.
+ */
+class EventBrokerTest : public ::testing::Test
+{
+   protected:
+    void SetUp() override
+    {
+        m_broker.attachConsumer([this](const std::chrono::milliseconds delay) -> void {
+            m_lastDelay = delay.count();
+            ++m_wakeups;
+        });
+    }
+
+    void TearDown() override
+    {
+        m_broker.detachConsumer();
+    }
+
+    /** @brief Publishes the samples first to last on another thread and waits for it. */
+    void publishFromOtherThread(const int first, const int last)
+    {
+        std::thread([this, first, last]() -> void {
+            for (int value = first; value <= last; ++value)
+            {
+                m_broker.publish(Sample{value});
+            }
+        }).join();
+    }
+
+    void drainAll()
+    {
+        while (m_broker.drain() > 0)
+        {
+        }
+    }
+
+    /** @brief Waits up to ten seconds for a condition, draining the test thread meanwhile. */
+    auto waitUntil(const std::function<bool()>& condition) -> bool
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!condition())
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                return false;
+            }
+            m_broker.drain();
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    auto diagnostics(const std::string& label) -> Core::SubscriptionDiagnostics
+    {
+        const auto all = m_broker.subscriptionDiagnostics();
+        const auto it =
+            std::find_if(all.begin(), all.end(), [&](const Core::SubscriptionDiagnostics& entry)
+                                                     -> bool { return entry.label == label; });
+        return it != all.end() ? *it : Core::SubscriptionDiagnostics{};
+    }
+
+    EventBroker::EventBroker m_broker;
+    std::atomic<int> m_wakeups{0};
+    /** @brief The delay the last wakeup asked for, in milliseconds. */
+    std::atomic<std::chrono::milliseconds::rep> m_lastDelay{-1};
+    std::vector<int> m_received;
+};
+
+TEST_F(EventBrokerTest, DropOldestKeepsTheNewestEvents)
+{
+    auto options = Core::SubscriptionOptions::lossy("drop-oldest", 4);
+    const auto connection = m_broker.subscribe<Sample>(
+        [this](const Sample& sample) -> void { m_received.push_back(sample.value); },
+        std::move(options));
+
+    publishFromOtherThread(0, 9);
+    EXPECT_TRUE(m_received.empty());
+    EXPECT_GE(m_wakeups, 1);
+    drainAll();
+
+    EXPECT_EQ(m_received, (std::vector<int>{6, 7, 8, 9}));
+    EXPECT_EQ(connection.stats()->queued, 10U);
+    EXPECT_EQ(connection.stats()->dropped, 6U);
+    EXPECT_EQ(connection.stats()->delivered, 4U);
+
+    const auto entry = diagnostics("drop-oldest");
+    EXPECT_EQ(entry.policy, Core::DeliveryPolicy::DropOldest);
+    EXPECT_EQ(entry.capacity, 4U);
+    EXPECT_EQ(entry.dropped, 6U);
+}
+
+TEST_F(EventBrokerTest, DropNewestKeepsTheOldestEvents)
+{
+    const auto connection = m_broker.subscribe<Sample>(
+        [this](const Sample& sample) -> void { m_received.push_back(sample.value); },
+        Core::SubscriptionOptions{.policy = Core::DeliveryPolicy::DropNewest,
+                                  .capacity = 4,
+                                  .label = "drop-newest"});
+
+    publishFromOtherThread(0, 9);
+    drainAll();
+
+    EXPECT_EQ(m_received, (std::vector<int>{0, 1, 2, 3}));
+    EXPECT_EQ(connection.stats()->queued, 4U);
+    EXPECT_EQ(connection.stats()->dropped, 6U);
+    EXPECT_EQ(connection.stats()->delivered, 4U);
+}
+
+TEST_F(EventBrokerTest, ConflateKeepsOnlyTheLatestEvent)
+{
+    const auto connection = m_broker.subscribe<Sample>(
+        [this](const Sample& sample) -> void { m_received.push_back(sample.value); },
+        Core::SubscriptionOptions{.policy = Core::DeliveryPolicy::Conflate, .label = "conflate"});
+
+    publishFromOtherThread(0, 9);
+    drainAll();
+
+    EXPECT_EQ(m_received, (std::vector<int>{9}));
+    EXPECT_EQ(connection.stats()->dropped, 9U);
+    EXPECT_EQ(connection.stats()->delivered, 1U);
+}
+
+TEST_F(EventBrokerTest, BlockMakesThePublisherWait)
+{
+    auto options = Core::SubscriptionOptions::lossless("block");
+    options.capacity = 2;
+    const auto connection = m_broker.subscribe<Sample>(
+        [this](const Sample& sample) -> void { m_received.push_back(sample.value); },
+        std::move(options));
+
+    std::jthread publisher([this]() -> void {
+        for (int value = 0; value < 100; ++value)
+        {
+            m_broker.publish(Sample{value});
+        }
+    });
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (m_received.size() < 100 && std::chrono::steady_clock::now() < deadline)
+    {
+        m_broker.drain();
+        std::this_thread::yield();
+    }
+    publisher.join();
+
+    ASSERT_EQ(m_received.size(), 100U);
+    for (int value = 0; value < 100; ++value)
+    {
+        EXPECT_EQ(m_received[value], value);
+    }
+    EXPECT_EQ(connection.stats()->dropped, 0U);
+    EXPECT_EQ(diagnostics("block").policy, Core::DeliveryPolicy::Block);
+}
+
+TEST_F(EventBrokerTest, SubscriptionsOfOtherThreadsAreCalledInline)
+{
+    Core::Connection connection;
+    std::thread([&]() -> void {
+        connection = m_broker.subscribe<Sample>(
+            [this](const Sample& sample) -> void { m_received.push_back(sample.value); },
+            Core::SubscriptionOptions{.executor = Core::Executor::publisher()});
+    }).join();
+
+    m_broker.publish(Sample{1});
+    publishFromOtherThread(2, 2);
+    EXPECT_EQ(m_received, (std::vector<int>{1, 2}));
+    EXPECT_EQ(m_wakeups, 0);
+}
+
+TEST_F(EventBrokerTest, CountersStayExactUnderConcurrentPublishers)
+{
+    std::atomic<int> calls{0};
+    const auto connection = m_broker.subscribe<Sample>(
+        [&](const Sample&) -> void { calls.fetch_add(1, std::memory_order_relaxed); },
+        Core::SubscriptionOptions{.executor = Core::Executor::publisher()});
+
+    constexpr int threads = 4;
+    constexpr int perThread = 10000;
+    {
+        std::vector<std::jthread> publishers;
+        for (int i = 0; i < threads; ++i)
+        {
+            publishers.emplace_back([this]() -> void {
+                for (int value = 0; value < perThread; ++value)
+                {
+                    m_broker.publish(Sample{value});
+                }
+            });
+        }
+    }
+
+    EXPECT_EQ(calls, threads * perThread);
+    EXPECT_EQ(connection.stats()->delivered, static_cast<uint64_t>(threads * perThread));
+#if BROKER_METRICS
+    const auto channels = m_broker.channelDiagnostics();
+    const auto channel = std::find_if(
+        channels.begin(), channels.end(), [](const Core::ChannelDiagnostics& entry) -> bool {
+            return entry.eventType == Core::eventTypeId<Sample>();
+        });
+    ASSERT_NE(channel, channels.end());
+    EXPECT_EQ(channel->published, static_cast<uint64_t>(threads * perThread));
+#endif
+}
+
+TEST_F(EventBrokerTest, SubscribersChangeWhileOtherThreadsPublish)
+{
+    std::atomic<bool> stop{false};
+    std::atomic<int> calls{0};
+    const auto options = Core::SubscriptionOptions{.executor = Core::Executor::publisher()};
+    const auto count = [&](const Sample&) -> void {
+        calls.fetch_add(1, std::memory_order_relaxed);
+    };
+    const auto connection = m_broker.subscribe<Sample>(count, options);
+    {
+        std::vector<std::jthread> publishers;
+        for (int i = 0; i < 2; ++i)
+        {
+            publishers.emplace_back([&]() -> void {
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    m_broker.publish(Sample{0});
+                }
+            });
+        }
+        // Every change replaces the snapshot the publishers are reading from.
+        for (int i = 0; i < 2000 || calls < 1000; ++i)
+        {
+            auto churn = m_broker.subscribe<Sample>(count, options);
+            churn.release();
+        }
+        stop = true;
+    }
+
+    EXPECT_GT(connection.stats()->delivered, 0U);
+    EXPECT_EQ(m_broker.subscriptionDiagnostics().size(), 1U);
+}
+
+TEST_F(EventBrokerTest, ControlEventsOvertakeQueuedData)
+{
+    std::vector<std::string> order;
+    const auto frames = m_broker.subscribe<Sample>(
+        [&](const Sample&) -> void { order.emplace_back("data"); },
+        Core::SubscriptionOptions::lossless("data"));
+    const auto stops = m_broker.subscribe<Core::AppStoppedEvent>(
+        [&](const Core::AppStoppedEvent&) -> void { order.emplace_back("stop"); },
+        Core::SubscriptionOptions::lossless("control"));
+
+    std::thread([this]() -> void {
+        for (int value = 0; value < 1000; ++value)
+        {
+            m_broker.publish(Sample{value});
+        }
+        m_broker.publish(Core::AppStoppedEvent{});
+    }).join();
+
+    // The first delivery of the drain is the stop event, although it was published last.
+    EXPECT_EQ(m_broker.drain(1), 1U);
+    ASSERT_EQ(order.size(), 1U);
+    EXPECT_EQ(order.front(), "stop");
+    drainAll();
+    EXPECT_EQ(order.size(), 1001U);
+
+    const auto lanes = m_broker.laneDiagnostics();
+    ASSERT_EQ(lanes.size(), Core::eventPriorityCount);
+    EXPECT_EQ(lanes[0].lane, Core::EventPriority::Control);
+    EXPECT_EQ(lanes[1].lane, Core::EventPriority::Data);
+#if BROKER_METRICS
+    EXPECT_EQ(lanes[0].deliveries, 1U);
+    EXPECT_EQ(lanes[1].deliveries, 1000U);
+    EXPECT_LE(lanes[0].p50, lanes[0].max);
+#endif
+}
+
+TEST_F(EventBrokerTest, ControlEventsAreDeliveredBeforeTheRestOfADrain)
+{
+    std::vector<std::string> order;
+    const auto frames = m_broker.subscribe<Sample>(
+        [&](const Sample& sample) -> void {
+            order.emplace_back("data");
+            // Published while the data mailbox is being drained.
+            if (sample.value == 0)
+            {
+                std::thread([this]() -> void { m_broker.publish(Core::AppStoppedEvent{}); })
+                    .join();
+            }
+        },
+        Core::SubscriptionOptions::lossless("data"));
+    const auto otherFrames = m_broker.subscribe<Sample>(
+        [&](const Sample&) -> void { order.emplace_back("other"); },
+        Core::SubscriptionOptions::lossless("other"));
+    const auto stops = m_broker.subscribe<Core::AppStoppedEvent>(
+        [&](const Core::AppStoppedEvent&) -> void { order.emplace_back("stop"); },
+        Core::SubscriptionOptions::lossless("control"));
+
+    publishFromOtherThread(0, 0);
+    drainAll();
+    EXPECT_EQ(order, (std::vector<std::string>{"data", "stop", "other"}));
+}
+
+TEST_F(EventBrokerTest, DeferredSubscriptionsRunFromTheNextDrain)
+{
+    int depth = 0;
+    int maxDepth = 0;
+    const auto deferred = m_broker.subscribe<Sample>(
+        [&](const Sample& sample) -> void {
+            maxDepth = std::max(maxDepth, ++depth);
+            m_received.push_back(sample.value);
+            // Publishing from the callback never re-enters it.
+            if (sample.value < 3)
+            {
+                m_broker.publish(Sample{sample.value + 1});
+            }
+            --depth;
+        },
+        Core::SubscriptionOptions::lossless("deferred").deferred());
+    int immediate = 0;
+    const auto direct = m_broker.subscribe<Sample>([&](const Sample&) -> void { ++immediate; });
+
+    m_broker.publish(Sample{0});
+    EXPECT_TRUE(m_received.empty());
+    EXPECT_EQ(immediate, 1);
+    EXPECT_EQ(m_wakeups, 1);
+
+    drainAll();
+    EXPECT_EQ(m_received, (std::vector<int>{0, 1, 2, 3}));
+    EXPECT_EQ(maxDepth, 1);
+    EXPECT_EQ(immediate, 4);
+}
+
+TEST_F(EventBrokerTest, DrainBoundsTheWorkPerTick)
+{
+    const auto deferred = m_broker.subscribe<Sample>(
+        [this](const Sample& sample) -> void { m_received.push_back(sample.value); },
+        Core::SubscriptionOptions::lossless("tick").deferred());
+    for (int value = 0; value < 5; ++value)
+    {
+        m_broker.publish(Sample{value});
+    }
+
+    const auto wakeups = m_wakeups.load();
+    EXPECT_EQ(m_broker.drain(2), 2U);
+    EXPECT_EQ(m_received, (std::vector<int>{0, 1}));
+    // Events are left, so the consumer is woken up again.
+    EXPECT_EQ(m_wakeups, wakeups + 1);
+    EXPECT_EQ(m_broker.drain(2), 2U);
+    EXPECT_EQ(m_broker.drain(2), 1U);
+    EXPECT_EQ(m_broker.drain(2), 0U);
+    EXPECT_EQ(m_received, (std::vector<int>{0, 1, 2, 3, 4}));
+}
+
+TEST_F(EventBrokerTest, DeferredLosslessMailboxGrowsOnItsOwnThread)
+{
+    auto options = Core::SubscriptionOptions::lossless("self").deferred();
+    options.capacity = 4;
+    const auto connection = m_broker.subscribe<Sample>(
+        [this](const Sample& sample) -> void { m_received.push_back(sample.value); },
+        std::move(options));
+
+    // The consumer can not wait for itself, so nothing may be dropped nor block.
+    for (int value = 0; value < 10; ++value)
+    {
+        m_broker.publish(Sample{value});
+    }
+    EXPECT_EQ(connection.stats()->queued, 10U);
+    EXPECT_EQ(connection.stats()->dropped, 0U);
+
+    drainAll();
+    ASSERT_EQ(m_received.size(), 10U);
+    for (int value = 0; value < 10; ++value)
+    {
+        EXPECT_EQ(m_received[value], value);
+    }
+}
+
+TEST_F(EventBrokerTest, DeferredRequiresAConsumerThread)
+{
+    EXPECT_THROW(
+        {
+            const auto connection = m_broker.subscribe<Sample>(
+                [](const Sample&) -> void {},
+                Core::SubscriptionOptions{.executor = Core::Executor::publisher()}.deferred());
+        },
+        std::logic_error);
+}
+
+TEST_F(EventBrokerTest, GuiExecutorDeliversOnTheGuiThread)
+{
+    const auto onGui = Core::SubscriptionOptions{.executor = Core::Executor::gui()};
+    EXPECT_THROW(m_broker.subscribe<Sample>([](const Sample&) -> void {}, onGui),
+                 std::logic_error);
+
+    m_broker.attachGuiConsumer([this](std::chrono::milliseconds) -> void { ++m_wakeups; });
+    std::vector<std::thread::id> threads;
+    Core::Connection connection;
+    // Subscribed from another thread, still delivered on the GUI thread.
+    std::thread([&]() -> void {
+        connection = m_broker.subscribe<Sample>(
+            [&](const Sample& sample) -> void {
+                m_received.push_back(sample.value);
+                threads.push_back(std::this_thread::get_id());
+            },
+            onGui);
+    }).join();
+
+    publishFromOtherThread(0, 2);
+    EXPECT_TRUE(m_received.empty());
+    EXPECT_GE(m_wakeups, 1);
+    drainAll();
+    EXPECT_EQ(m_received, (std::vector<int>{0, 1, 2}));
+    EXPECT_EQ(threads, std::vector<std::thread::id>(3, std::this_thread::get_id()));
+}
+
+TEST_F(EventBrokerTest, WorkersAreSharedByName)
+{
+    std::mutex mutex;
+    std::vector<std::thread::id> disk;
+    std::vector<std::thread::id> network;
+    std::vector<int> values;
+    const auto record = [&](std::vector<std::thread::id>& threads, const int value) -> void {
+        std::lock_guard lock(mutex);
+        threads.push_back(std::this_thread::get_id());
+        values.push_back(value);
+    };
+    const auto first = m_broker.subscribe<Sample>(
+        [&](const Sample& sample) -> void { record(disk, sample.value); },
+        Core::SubscriptionOptions::lossless("first").on(Core::Executor::worker("disk")));
+    const auto second = m_broker.subscribe<Trigger>(
+        [&](const Trigger& trigger) -> void { record(disk, trigger.count); },
+        Core::SubscriptionOptions::lossless("second").on(Core::Executor::worker("disk")));
+    const auto third = m_broker.subscribe<Trigger>(
+        [&](const Trigger&) -> void { record(network, -1); },
+        Core::SubscriptionOptions::lossless("third").on(Core::Executor::worker("network")));
+
+    for (int value = 0; value < 100; ++value)
+    {
+        m_broker.publish(Sample{value});
+    }
+    m_broker.publish(Trigger{100});
+    ASSERT_TRUE(waitUntil([&]() -> bool {
+        std::lock_guard lock(mutex);
+        return values.size() == 102;
+    }));
+
+    std::lock_guard lock(mutex);
+    EXPECT_EQ(std::set<std::thread::id>(disk.begin(), disk.end()).size(), 1U);
+    ASSERT_EQ(network.size(), 1U);
+    EXPECT_NE(disk.front(), network.front());
+    EXPECT_NE(disk.front(), std::this_thread::get_id());
+    // One worker delivers the events of a subscription in order.
+    std::erase(values, -1);
+    for (int value = 0; value <= 100; ++value)
+    {
+        EXPECT_EQ(values[value], value);
+    }
+}
+
+TEST_F(EventBrokerTest, PoolDeliversOneSubscriptionAtATime)
+{
+    std::atomic<int> running{0};
+    std::atomic<int> overlaps{0};
+    std::atomic<int> calls{0};
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    const auto connection = m_broker.subscribe<Sample>(
+        [&](const Sample&) -> void {
+            if (running.fetch_add(1) > 0)
+            {
+                ++overlaps;
+            }
+            {
+                std::lock_guard lock(mutex);
+                threads.insert(std::this_thread::get_id());
+            }
+            running.fetch_sub(1);
+            ++calls;
+        },
+        Core::SubscriptionOptions::lossless("pool").on(Core::Executor::pool()));
+
+    std::vector<std::jthread> publishers;
+    for (int i = 0; i < 2; ++i)
+    {
+        publishers.emplace_back([this]() -> void {
+            for (int value = 0; value < 500; ++value)
+            {
+                m_broker.publish(Sample{value});
+            }
+        });
+    }
+    publishers.clear();
+    ASSERT_TRUE(waitUntil([&]() -> bool { return calls == 1000; }));
+
+    EXPECT_EQ(overlaps, 0);
+    EXPECT_EQ(connection.stats()->delivered, 1000U);
+    std::lock_guard lock(mutex);
+    EXPECT_EQ(threads.count(std::this_thread::get_id()), 0U);
+}
+
+TEST_F(EventBrokerTest, ReleaseWaitsForRunningCallbacks)
+{
+    std::atomic<bool> entered{false};
+    std::atomic<bool> finished{false};
+    auto connection = m_broker.subscribe<Sample>(
+        [&](const Sample&) -> void {
+            entered = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            finished = true;
+        },
+        Core::SubscriptionOptions::lossless("slow").on(Core::Executor::worker("slow")));
+
+    m_broker.publish(Sample{0});
+    ASSERT_TRUE(waitUntil([&]() -> bool { return entered.load(); }));
+    connection.release();
+    EXPECT_TRUE(finished);
+
+    // Nothing is delivered after the release returned.
+    m_broker.publish(Sample{1});
+    EXPECT_EQ(connection.stats()->delivered, 1U);
+}
+
+TEST_F(EventBrokerTest, ReleaseDoesNotWaitForCallbacksBlockedOnTheReleasingThread)
+{
+    auto options = Core::SubscriptionOptions::lossless("sink");
+    options.capacity = 2;
+    const auto sink = m_broker.subscribe<Sample>(
+        [this](const Sample& sample) -> void { m_received.push_back(sample.value); },
+        std::move(options));
+    // Blocks on the full mailbox of the test thread, which does not drain until it released.
+    auto relay = m_broker.subscribe<Trigger>(
+        [this](const Trigger& trigger) -> void {
+            for (int value = 0; value < trigger.count; ++value)
+            {
+                m_broker.publish(Sample{value});
+            }
+        },
+        Core::SubscriptionOptions::lossless("relay").on(Core::Executor::worker("relay")));
+
+    m_broker.publish(Trigger{10});
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (sink.stats()->queued < 2 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+    ASSERT_EQ(sink.stats()->queued, 2U);
+    relay.release();
+
+    EXPECT_EQ(sink.stats()->queued, 10U);
+    drainAll();
+    ASSERT_EQ(m_received.size(), 10U);
+    for (int value = 0; value < 10; ++value)
+    {
+        EXPECT_EQ(m_received[value], value);
+    }
+}
+
+TEST_F(EventBrokerTest, FiltersSelectIdsAndInterfaces)
+{
+    const auto inlineOptions = Core::SubscriptionOptions{.executor = Core::Executor::publisher()};
+    std::vector<int> byId;
+    std::vector<int> byInterface;
+    std::vector<int> byBoth;
+    const auto ids = m_broker.subscribe<Frame>(
+        Core::EventFilter::forIds({0x300, 0x100, 0x100}),
+        [&](const Frame& frame) -> void { byId.push_back(frame.value); }, inlineOptions);
+    const auto interfaces = m_broker.subscribe<Frame>(
+        Core::EventFilter{{}, 0b10},
+        [&](const Frame& frame) -> void { byInterface.push_back(frame.value); }, inlineOptions);
+    const std::array<uint64_t, 5> bitmap{0, 0, 0, 0, uint64_t{1} << 0};
+    const auto both = m_broker.subscribe<Frame>(
+        Core::EventFilter::forBitmap(bitmap, 0b01),
+        [&](const Frame& frame) -> void { byBoth.push_back(frame.value); }, inlineOptions);
+
+    m_broker.publish(Frame{0x100, 0, 0});
+    m_broker.publish(Frame{0x100, 1, 1});
+    m_broker.publish(Frame{0x200, 1, 2});
+    // Filtered per event of the batch.
+    const std::vector<Frame> burst{{0x300, 0, 3}, {0x400, 0, 4}, {0x100, 2, 5}, {0x300, 1, 6}};
+    m_broker.publishBatch<Frame>(burst);
+
+    EXPECT_EQ(byId, (std::vector<int>{0, 1, 3, 5, 6}));
+    EXPECT_EQ(byInterface, (std::vector<int>{1, 2, 6}));
+    EXPECT_EQ(byBoth, (std::vector<int>{0}));
+}
+
+TEST_F(EventBrokerTest, SubscribedIdsMergeTheFiltersPerInterface)
+{
+    const auto ignore = [](const Frame&) -> void {};
+    EXPECT_EQ(m_broker.subscribedIds<Frame>(0), std::vector<uint32_t>{});
+
+    const auto first =
+        m_broker.subscribe<Frame>(Core::EventFilter::forIds({0x200, 0x100}, 0b01), ignore);
+    const auto second =
+        m_broker.subscribe<Frame>(Core::EventFilter::forIds({0x300, 0x100}, 0b10), ignore);
+    EXPECT_EQ(m_broker.subscribedIds<Frame>(0), (std::vector<uint32_t>{0x100, 0x200}));
+    EXPECT_EQ(m_broker.subscribedIds<Frame>(1), (std::vector<uint32_t>{0x100, 0x300}));
+    EXPECT_EQ(m_broker.subscribedIds<Frame>(2), std::vector<uint32_t>{});
+
+    {
+        // Every ID on interface 1 is needed while it lives.
+        const auto anyId = m_broker.subscribe<Frame>(Core::EventFilter{{}, 0b10}, ignore);
+        EXPECT_EQ(m_broker.subscribedIds<Frame>(1), std::nullopt);
+        EXPECT_EQ(m_broker.subscribedIds<Frame>(0), (std::vector<uint32_t>{0x100, 0x200}));
+    }
+    EXPECT_EQ(m_broker.subscribedIds<Frame>(1), (std::vector<uint32_t>{0x100, 0x300}));
+
+    const auto unfiltered = m_broker.subscribe<Frame>(ignore);
+    EXPECT_EQ(m_broker.subscribedIds<Frame>(0), std::nullopt);
+    EXPECT_EQ(m_broker.subscribedIds<Frame>(2), std::nullopt);
+}
+
+TEST_F(EventBrokerTest, LatestSubscriptionsReceiveTheNewestEventPerKey)
+{
+    std::vector<std::vector<Frame>> flushes;
+    const auto latest = m_broker.subscribeLatest<Frame>(
+        std::chrono::milliseconds::zero(), [&](const std::span<const Frame> frames) -> void {
+            flushes.emplace_back(frames.begin(), frames.end());
+        });
+
+    std::thread([this]() -> void {
+        for (int value = 0; value < 100; ++value)
+        {
+            m_broker.publish(Frame{0x100, 0, value});
+            m_broker.publish(Frame{0x200, 0, -value});
+            m_broker.publish(Frame{0x100, 1, value * 10});
+        }
+    }).join();
+    EXPECT_TRUE(flushes.empty());
+    EXPECT_GE(m_wakeups, 1);
+
+    drainAll();
+    ASSERT_EQ(flushes.size(), 1U);
+    // One event per key, in the order the keys first changed.
+    ASSERT_EQ(flushes[0].size(), 3U);
+    EXPECT_EQ(flushes[0][0].value, 99);
+    EXPECT_EQ(flushes[0][1].value, -99);
+    EXPECT_EQ(flushes[0][2].value, 990);
+    EXPECT_EQ(flushes[0][2].interfaceId, 1U);
+
+    // Nothing changed, nothing to flush.
+    drainAll();
+    EXPECT_EQ(flushes.size(), 1U);
+    // Also collected when published on the consumer thread itself, never called inline.
+    m_broker.publish(Frame{0x200, 0, 7});
+    EXPECT_EQ(flushes.size(), 1U);
+    drainAll();
+    ASSERT_EQ(flushes.size(), 2U);
+    ASSERT_EQ(flushes[1].size(), 1U);
+    EXPECT_EQ(flushes[1][0].value, 7);
+
+    EXPECT_EQ(diagnostics("").policy, Core::DeliveryPolicy::Conflate);
+}
+
+TEST_F(EventBrokerTest, LatestSubscriptionsAskForATimedWakeupUntilTheirIntervalPassed)
+{
+    constexpr auto interval = std::chrono::milliseconds(300);
+    std::vector<int> flushed;
+    const auto latest = m_broker.subscribeLatest<Frame>(
+        interval, [&](const std::span<const Frame> frames) -> void {
+            for (const auto& frame : frames)
+            {
+                flushed.push_back(frame.value);
+            }
+        });
+
+    // The first flush is due at once.
+    m_broker.publish(Frame{0x100, 0, 1});
+    EXPECT_EQ(m_lastDelay, 0);
+    drainAll();
+    EXPECT_EQ(flushed, (std::vector<int>{1}));
+
+    const auto published = std::chrono::steady_clock::now();
+    m_broker.publish(Frame{0x100, 0, 2});
+    m_broker.publish(Frame{0x100, 0, 3});
+    // The consumer is asked to wake up when the interval passed, not polled until then.
+    EXPECT_GT(m_lastDelay, 0);
+    EXPECT_LE(m_lastDelay, interval.count());
+    const auto wakeups = m_wakeups.load();
+    drainAll();
+    if (std::chrono::steady_clock::now() - published < interval)
+    {
+        EXPECT_EQ(flushed, (std::vector<int>{1}));
+        // The timed wakeup is still pending, draining early does not ask again.
+        EXPECT_EQ(m_wakeups, wakeups);
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(m_lastDelay.load()));
+    ASSERT_TRUE(waitUntil([&]() -> bool { return flushed.size() == 2; }));
+    EXPECT_EQ(flushed, (std::vector<int>{1, 3}));
+}
+
+TEST_F(EventBrokerTest, BatchAndSingleSubscribersReceiveEitherKindOfPublish)
+{
+    std::vector<std::vector<int>> batches;
+    const auto batched = m_broker.subscribeBatch<Sample>(
+        [&](const std::span<const Sample> samples) -> void {
+            auto& batch = batches.emplace_back();
+            for (const auto& sample : samples)
+            {
+                batch.push_back(sample.value);
+            }
+        },
+        Core::SubscriptionOptions::lossless("batched"));
+    const auto single = m_broker.subscribe<Sample>(
+        [this](const Sample& sample) -> void { m_received.push_back(sample.value); },
+        Core::SubscriptionOptions::lossless("single"));
+    std::vector<std::size_t> inlineSizes;
+    const auto inlineBatched = m_broker.subscribeBatch<Sample>(
+        [&](const std::span<const Sample> samples) -> void {
+            inlineSizes.push_back(samples.size());
+        },
+        Core::SubscriptionOptions{.executor = Core::Executor::publisher()});
+
+    std::thread([this]() -> void {
+        m_broker.publish(Sample{0});
+        const std::vector<Sample> burst{{1}, {2}, {3}};
+        m_broker.publishBatch<Sample>(burst);
+        m_broker.publish(Sample{4});
+    }).join();
+    // An empty batch is not published at all.
+    m_broker.publishBatch<Sample>(std::span<const Sample>());
+    drainAll();
+
+    // A single event arrives as a batch of one, a batch stays one call.
+    EXPECT_EQ(batches, (std::vector<std::vector<int>>{{0}, {1, 2, 3}, {4}}));
+    EXPECT_EQ(inlineSizes, (std::vector<std::size_t>{1, 3, 1}));
+    // Single-event subscribers are called once per event of a batch, in order.
+    EXPECT_EQ(m_received, (std::vector<int>{0, 1, 2, 3, 4}));
+    EXPECT_EQ(batched.stats()->delivered, 5U);
+    EXPECT_EQ(single.stats()->delivered, 5U);
+}
+
+TEST_F(EventBrokerTest, PartitionsDeliverTheirBusesAndUnfilteredSubscribersSeeAll)
+{
+    const auto inlineOptions = Core::SubscriptionOptions{.executor = Core::Executor::publisher()};
+    std::mutex mutex;
+    std::vector<std::vector<int>> merged;
+    std::vector<int> busOne;
+    std::vector<int> busNine;
+    const auto all = m_broker.subscribeBatch<Frame>(
+        [&](const std::span<const Frame> frames) -> void {
+            std::lock_guard lock(mutex);
+            auto& batch = merged.emplace_back();
+            for (const auto& frame : frames)
+            {
+                batch.push_back(frame.value);
+            }
+        },
+        inlineOptions);
+    // Buses 1 and 9 share a partition, the filter still tells them apart.
+    static_assert(EventBroker::EventBroker::interfacePartitions == 8);
+    const auto one = m_broker.subscribe<Frame>(
+        Core::EventFilter{{}, uint32_t{1} << 1},
+        [&](const Frame& frame) -> void { busOne.push_back(frame.value); }, inlineOptions);
+    const auto nine = m_broker.subscribe<Frame>(
+        Core::EventFilter{{}, uint32_t{1} << 9},
+        [&](const Frame& frame) -> void { busNine.push_back(frame.value); }, inlineOptions);
+
+    const std::vector<Frame> burst{{0x100, 0, 0}, {0x100, 0, 1}, {0x100, 1, 2},
+                                   {0x100, 9, 3}, {0x100, 0, 4}, {0x100, 8, 5}};
+    m_broker.publishBatch<Frame>(burst);
+
+    // A mixed batch reaches the merged view as one call per run of the same partition.
+    EXPECT_EQ(merged, (std::vector<std::vector<int>>{{0, 1}, {2, 3}, {4, 5}}));
+    EXPECT_EQ(busOne, (std::vector<int>{2}));
+    EXPECT_EQ(busNine, (std::vector<int>{3}));
+
+    // Buses published concurrently all reach the merged view, each in its own order.
+    merged.clear();
+    constexpr int perBus = 1000;
+    {
+        std::vector<std::jthread> receivers;
+        for (uint8_t bus = 0; bus < 4; ++bus)
+        {
+            receivers.emplace_back([this, bus]() -> void {
+                for (int value = 0; value < perBus; ++value)
+                {
+                    m_broker.publish(Frame{0x200, bus, bus * perBus + value});
+                }
+            });
+        }
+    }
+    std::vector<int> lastOfBus(4, -1);
+    std::size_t received = 0;
+    for (const auto& batch : merged)
+    {
+        ASSERT_EQ(batch.size(), 1U);
+        auto& last = lastOfBus[batch.front() / perBus];
+        EXPECT_GT(batch.front(), last);
+        last = batch.front();
+        ++received;
+    }
+    EXPECT_EQ(received, 4U * perBus);
+    EXPECT_EQ(busOne.size(), 1U + perBus);
+    EXPECT_EQ(busNine.size(), 1U);
+
+#if BROKER_METRICS
+    const auto channels = m_broker.channelDiagnostics();
+    const auto channel = std::find_if(
+        channels.begin(), channels.end(), [](const Core::ChannelDiagnostics& entry) -> bool {
+            return entry.eventType == Core::eventTypeId<Frame>();
+        });
+    ASSERT_NE(channel, channels.end());
+    // Counted per partition, reported over all of them.
+    EXPECT_EQ(channel->published, burst.size() + 4U * perBus);
+    EXPECT_EQ(channel->subscribers, 3U);
+#endif
+}
+
+}  // namespace
@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "event_broker/event_broker.hpp"
+#include "event_broker/event_journal.hpp"
+
+namespace {
+
+using EventBroker::EventJournal;
+using EventBroker::JournalReplayer;
+
+/**
+ * @brief Records into a temporary journal and replays it into a second broker, whose inline
+ * subscriptions collect the replayed events.
+ */
+class EventJournalTest : public ::testing::Test
+{
+   protected:
+    void TearDown() override
+    {
+        std::filesystem::remove(m_path);
+    }
+
+    static auto rawEvent(const uint32_t messageId, const uint8_t dlc) -> Core::ReceivedCanRawEvent
+    {
+        Core::ReceivedCanRawEvent event;
+        event.canMessage = {1234, {1, 2, 3, 4, 5, 6, 7, 8}, messageId, 3, dlc};
+        return event;
+    }
+
+    auto replay() -> EventBroker::ReplayStats
+    {
+        const auto options = Core::SubscriptionOptions{.executor = Core::Executor::publisher()};
+        const auto raw = m_replayed.subscribe<Core::ReceivedCanRawEvent>(
+            [this](const Core::ReceivedCanRawEvent& event) -> void {
+                m_raw.push_back(event.canMessage);
+            },
+            options);
+        const auto decoded = m_replayed.subscribe<Core::ReceivedCanDbcEvent>(
+            [this](const Core::ReceivedCanDbcEvent& event) -> void { m_decoded.push_back(event); },
+            options);
+        const auto requests = m_replayed.subscribe<Core::ParseDBCRequestEvent>(
+            [this](const Core::ParseDBCRequestEvent& event) -> void {
+                m_requests.push_back(event);
+            },
+            options);
+        return JournalReplayer(m_path).replay(m_replayed, JournalReplayer::maxSpeed);
+    }
+
+    const std::filesystem::path m_path =
+        std::filesystem::temp_directory_path() / "event_journal_test.journal";
+    EventBroker::EventBroker m_broker;
+    EventBroker::EventBroker m_replayed;
+    Core::PayloadPool<Core::DbcCanMessage> m_messages;
+    std::vector<Core::RawCanMessage> m_raw;
+    std::vector<Core::ReceivedCanDbcEvent> m_decoded;
+    std::vector<Core::ParseDBCRequestEvent> m_requests;
+};
+
+TEST_F(EventJournalTest, ReplaysTheRecordedEventsInOrder)
+{
+    {
+        EventJournal journal(m_broker, m_path);
+        journal.record<Core::ReceivedCanRawEvent>();
+        journal.record<Core::ReceivedCanDbcEvent>();
+        journal.record<Core::ParseDBCRequestEvent>();
+
+        const std::vector<Core::ReceivedCanRawEvent> burst{rawEvent(0x100, 8), rawEvent(0x101, 2)};
+        m_broker.publishBatch<Core::ReceivedCanRawEvent>(burst);
+
+        Core::ReceivedCanDbcEvent decoded;
+        decoded.canMessage = m_messages.acquire();
+        decoded.canMessage.edit() = {5678, {{"Speed", 12.5}, {"Gear", -1.0}}, 0x200, 1};
+        m_broker.publish(decoded);
+
+        Core::ParseDBCRequestEvent request;
+        request.filePath = "powertrain.dbc";
+        request.interfaces = {"can0", "can1"};
+        m_broker.publish(request);
+        // Not recorded.
+        m_broker.publish(Core::SendCanMessageRawEvent{});
+        EXPECT_EQ(journal.recordedEvents(), 4U);
+    }
+
+    const auto stats = replay();
+    EXPECT_EQ(stats.events, 4U);
+    ASSERT_EQ(m_raw.size(), 2U);
+    EXPECT_EQ(m_raw[0].messageId, 0x100U);
+    EXPECT_EQ(m_raw[0].dlc, 8U);
+    EXPECT_EQ(m_raw[0].data[7], 8);
+    EXPECT_EQ(m_raw[1].messageId, 0x101U);
+    EXPECT_EQ(m_raw[1].dlc, 2U);
+    EXPECT_EQ(m_raw[1].interfaceId, 3U);
+    EXPECT_EQ(m_raw[1].receiveTime, 1234);
+
+    ASSERT_EQ(m_decoded.size(), 1U);
+    const auto& message = *m_decoded.front().canMessage;
+    EXPECT_EQ(message.messageId, 0x200U);
+    EXPECT_EQ(message.interfaceId, 1U);
+    ASSERT_EQ(message.signalValues.size(), 2U);
+    EXPECT_EQ(message.signalValues[0].name, "Speed");
+    EXPECT_DOUBLE_EQ(message.signalValues[0].value, 12.5);
+    EXPECT_EQ(message.signalValues[1].name, "Gear");
+
+    ASSERT_EQ(m_requests.size(), 1U);
+    EXPECT_EQ(m_requests.front().filePath, "powertrain.dbc");
+    EXPECT_EQ(m_requests.front().interfaces, (std::list<std::string>{"can0", "can1"}));
+}
+
+TEST_F(EventJournalTest, TruncatesCountsToTheirFieldWidth)
+{
+    constexpr std::size_t tooMany = UINT16_MAX + 10;
+    {
+        EventJournal journal(m_broker, m_path);
+        journal.record<Core::ReceivedCanDbcEvent>();
+        journal.record<Core::ParseDBCRequestEvent>();
+
+        Core::ReceivedCanDbcEvent decoded;
+        decoded.canMessage = m_messages.acquire();
+        decoded.canMessage.edit() = {0, std::vector<Core::DbcCanSignal>(tooMany, {"S", 1.0}), 1, 0};
+        m_broker.publish(decoded);
+
+        Core::ParseDBCRequestEvent request;
+        request.interfaces.assign(tooMany, "can0");
+        m_broker.publish(request);
+    }
+
+    // The count matches the elements written, so the records stay readable.
+    EXPECT_EQ(replay().events, 2U);
+    ASSERT_EQ(m_decoded.size(), 1U);
+    EXPECT_EQ(m_decoded.front().canMessage->signalValues.size(), UINT16_MAX);
+    ASSERT_EQ(m_requests.size(), 1U);
+    EXPECT_EQ(m_requests.front().interfaces.size(), UINT16_MAX);
+}
+
+TEST_F(EventJournalTest, TimestampsFollowTheRecordOrder)
+{
+    constexpr int perThread = 2000;
+    {
+        EventJournal journal(m_broker, m_path);
+        journal.record<Core::ReceivedCanRawEvent>();
+        std::vector<std::jthread> publishers;
+        for (uint32_t id = 0; id < 2; ++id)
+        {
+            publishers.emplace_back([this, id]() -> void {
+                for (int i = 0; i < perThread; ++i)
+                {
+                    m_broker.publish(rawEvent(id, 8));
+                }
+            });
+        }
+    }
+
+    // Header: magic and version. Record: tag, payload size and timestamp, then the payload.
+    std::ifstream file(m_path, std::ios::binary);
+    const std::vector<char> content{std::istreambuf_iterator<char>(file),
+                                    std::istreambuf_iterator<char>()};
+    std::size_t offset = 8;
+    int64_t previous = 0;
+    int records = 0;
+    while (offset + 14 <= content.size())
+    {
+        uint32_t size = 0;
+        int64_t timestamp = 0;
+        std::memcpy(&size, content.data() + offset + 2, sizeof(size));
+        std::memcpy(&timestamp, content.data() + offset + 6, sizeof(timestamp));
+        EXPECT_GE(timestamp, previous);
+        previous = timestamp;
+        offset += 14 + size;
+        ++records;
+    }
+    EXPECT_EQ(offset, content.size());
+    EXPECT_EQ(records, 2 * perThread);
+    EXPECT_EQ(replay().events, static_cast<uint64_t>(2 * perThread));
+}
+
+TEST_F(EventJournalTest, RejectsFilesThatAreNoJournal)
+{
+    std::ofstream(m_path, std::ios::binary) << "CBMX";
+    EXPECT_THROW(JournalReplayer{m_path}, std::runtime_error);
+    EXPECT_THROW(JournalReplayer{m_path / "missing"}, std::runtime_error);
+}
+
+}  // namespace
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/util/task.hpp"
+#include "event_broker/event_broker.hpp"
+
+namespace {
+
+struct Pong {
+    Core::RequestId requestId = 0;
+    int value = 0;
+};
+
+struct PingFailed {
+    Core::RequestId requestId = 0;
+    std::string errorMessage;
+};
+
+struct Ping {
+    using Response = Pong;
+    using Failure = PingFailed;
+
+    Core::RequestId requestId = 0;
+    int value = 0;
+};
+
+/** @brief Where a coroutine awaiting a Pong ended up. */
+struct Outcome {
+    std::optional<int> value;
+    std::optional<std::string> error;
+    std::thread::id thread;
+};
+
+auto ping(Core::IEventBroker& broker, const int value, Outcome& outcome) -> Core::Task
+{
+    try
+    {
+        const auto pong = co_await broker.request(Ping{0, value});
+        outcome.value = pong.value;
+    }
+    catch (const Core::RequestError& error)
+    {
+        outcome.error = error.what();
+    }
+    outcome.thread = std::this_thread::get_id();
+}
+
+/**
+ * @brief The test thread is the GUI consumer of the broker, so replies published on another
+ * thread are queued until the test drains them.
+ */
+class RequestTest : public ::testing::Test
+{
+   protected:
+    void SetUp() override
+    {
+        m_broker.attachGuiConsumer([](std::chrono::milliseconds) -> void {});
+    }
+
+    void TearDown() override
+    {
+        m_broker.detachConsumer();
+    }
+
+    /** @brief Waits up to ten seconds for a condition, draining the test thread meanwhile. */
+    auto waitUntil(const std::function<bool()>& condition) -> bool
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!condition())
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                return false;
+            }
+            m_broker.drain();
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    auto replySubscriptions() -> std::size_t
+    {
+        const auto all = m_broker.subscriptionDiagnostics();
+        return std::count_if(all.begin(), all.end(),
+                             [](const Core::SubscriptionDiagnostics& entry) -> bool {
+                                 return entry.label == "reply";
+                             });
+    }
+
+    template <typename Event>
+    void publishFromOtherThread(const Event& event)
+    {
+        std::thread([this, &event]() -> void { m_broker.publish(event); }).join();
+    }
+
+    EventBroker::EventBroker m_broker;
+};
+
+TEST_F(RequestTest, ReplyPublishedBeforeTheAwaitIsKept)
+{
+    std::vector<Core::RequestId> requests;
+    // Answers inline, so the reply arrives while request() still publishes.
+    const auto responder = m_broker.subscribe<Ping>(
+        [&](const Ping& ping) -> void {
+            requests.push_back(ping.requestId);
+            m_broker.publish(Pong{ping.requestId, ping.value * 2});
+        },
+        Core::SubscriptionOptions{.executor = Core::Executor::publisher()});
+
+    Outcome outcome;
+    ping(m_broker, 21, outcome);
+    // The coroutine never suspended, it finished before ping() returned.
+    ASSERT_EQ(outcome.value, 42);
+    EXPECT_EQ(outcome.thread, std::this_thread::get_id());
+    ASSERT_EQ(requests.size(), 1U);
+    EXPECT_NE(requests.front(), 0U);
+    EXPECT_EQ(replySubscriptions(), 0U);
+}
+
+TEST_F(RequestTest, FailuresAreCorrelatedByRequestId)
+{
+    auto first = m_broker.request(Ping{0, 1});
+    auto second = m_broker.request(Ping{0, 2});
+    EXPECT_NE(first.requestId(), second.requestId());
+
+    m_broker.publish(PingFailed{second.requestId(), "no route"});
+    EXPECT_FALSE(first.ready());
+    ASSERT_TRUE(second.ready());
+    try
+    {
+        second.get();
+        FAIL() << "The failed request returned a response";
+    }
+    catch (const Core::RequestError& error)
+    {
+        EXPECT_STREQ(error.what(), "no route");
+    }
+
+    m_broker.publish(Pong{first.requestId(), 7});
+    ASSERT_TRUE(first.ready());
+    EXPECT_EQ(first.get().value, 7);
+}
+
+TEST_F(RequestTest, RepliesForOtherRequestsAreIgnored)
+{
+    auto reply = m_broker.request(Ping{0, 1});
+    const auto id = reply.requestId();
+
+    m_broker.publish(Pong{id + 1, 1});
+    m_broker.publish(Pong{0, 2});
+    m_broker.publish(PingFailed{id + 1, "other request"});
+    EXPECT_FALSE(reply.ready());
+
+    // Only the first reply with the ID counts.
+    m_broker.publish(Pong{id, 3});
+    m_broker.publish(Pong{id, 4});
+    m_broker.publish(PingFailed{id, "too late"});
+    ASSERT_TRUE(reply.ready());
+    EXPECT_EQ(reply.get().value, 3);
+}
+
+TEST_F(RequestTest, ReplyDestroyedBeforeTheAnswerIsIgnored)
+{
+    Core::RequestId id = 0;
+    {
+        const auto reply = m_broker.request(Ping{0, 1});
+        id = reply.requestId();
+        EXPECT_EQ(replySubscriptions(), 2U);
+        // Queued in the mailbox of the reply subscription, never delivered.
+        publishFromOtherThread(Pong{id, 1});
+    }
+    EXPECT_EQ(replySubscriptions(), 0U);
+    EXPECT_EQ(m_broker.drain(), 0U);
+
+    m_broker.publish(Pong{id, 2});
+    publishFromOtherThread(PingFailed{id, "late"});
+    EXPECT_EQ(m_broker.drain(), 0U);
+}
+
+TEST_F(RequestTest, CoroutineResumesOnTheGuiThread)
+{
+    std::thread::id responderThread;
+    const auto responder = m_broker.subscribe<Ping>(
+        [&](const Ping& ping) -> void {
+            responderThread = std::this_thread::get_id();
+            if (ping.value < 0)
+            {
+                m_broker.publish(PingFailed{ping.requestId, "negative"});
+                return;
+            }
+            m_broker.publish(Pong{ping.requestId, ping.value + 1});
+        },
+        Core::SubscriptionOptions::lossless("responder").on(Core::Executor::worker("responder")));
+
+    Outcome answered;
+    Outcome failed;
+    ping(m_broker, 1, answered);
+    ping(m_broker, -1, failed);
+    ASSERT_TRUE(waitUntil([&]() -> bool { return answered.value && failed.error; }));
+
+    EXPECT_EQ(answered.value, 2);
+    EXPECT_EQ(failed.error, "negative");
+    EXPECT_NE(responderThread, std::this_thread::get_id());
+    EXPECT_EQ(answered.thread, std::this_thread::get_id());
+    EXPECT_EQ(failed.thread, std::this_thread::get_id());
+}
+
+}  // namespace
@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/dto/can_dto.hpp"
+#include "core/util/flat_dbc_config.hpp"
+#include "logging/model/csv_exporter.hpp"
+#include "logging/model/session_file.hpp"
+
+namespace {
+
+using Logging::CsvExporter;
+using Logging::CsvExportState;
+using Logging::SessionWriter;
+
+constexpr std::time_t startSecond = 1'700'000'000;
+
+auto makeSignal(std::string name) -> Core::DbcSignalDescription
+{
+    return {std::move(name), false, "", 0, 8, true, false, 1.0, 0.0, 0.0, 255.0, "", {}};
+}
+
+/** @brief The DBC of the decoded frames, Gear has value descriptions. */
+auto makeDbc(const std::string& neutral) -> Core::DbcConfigPtr
+{
+    Core::DbcConfig config;
+    config.messageDefinitions.push_back(
+        {0x100, "Engine", 8, "ECU", {makeSignal("EngineSpeed"), makeSignal("Gear")}});
+    config.signalValueDescriptions.push_back(
+        {0x100, "Gear", {{0, neutral}, {1, "First, slow"}, {2, "Say \"two\""}}});
+    return Core::FlatDbcConfig::fromConfig(config);
+}
+
+auto readText(const std::filesystem::path& path) -> std::string
+{
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+class CsvExporterTest : public ::testing::Test
+{
+   protected:
+    void SetUp() override
+    {
+        const std::string name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        const auto directory = std::filesystem::temp_directory_path();
+        m_session = directory / ("csv_exporter_test_" + name +
+                                 std::string(Logging::SessionFormat::extension));
+        m_csv = directory / ("csv_exporter_test_" + name + ".csv");
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(m_session);
+        std::filesystem::remove(m_csv);
+    }
+
+    /** @brief Writes two raw and three decoded frames, decoded with a DBC of @p dbcHash. */
+    void writeMixedSession(const uint64_t dbcHash)
+    {
+        SessionWriter writer(m_session, {"mixed", "vcan0", 0, dbcHash});
+        std::vector<Core::RawCanMessage> burst{
+            {startSecond, {9, 1, 2, 3, 4, 5, 6, 7}, 0x123, 1},
+            {startSecond, {-1, 0x10, 0, 0, 0, 0, 0, 0}, 0x7FF, 2, 2}};
+        writer.append(burst);
+        writer.append(Core::DbcCanMessage{
+            startSecond + 1, {{"EngineSpeed", 2100.5}, {"Gear", 0.0}}, 0x100, 0});
+        writer.append(Core::DbcCanMessage{startSecond + 2, {{"Gear", 1.0}}, 0x100, 0});
+        writer.append(
+            Core::DbcCanMessage{startSecond + 3, {{"Gear", 2.0}, {"Oil,Temp", -4.25}}, 0x100, 0});
+    }
+
+    /** @brief Writes a session of raw frames spanning many chunks. */
+    void writeLargeSession(const std::size_t frames)
+    {
+        SessionWriter writer(m_session, {"large", "vcan0", 0, 0});
+        for (std::size_t i = 0; i < frames; ++i)
+        {
+            const Core::RawCanMessage frame{startSecond, {static_cast<char>(i)},
+                                            static_cast<uint32_t>(0x100 + i % 16), 0};
+            writer.append(std::span(&frame, 1));
+        }
+    }
+
+    std::filesystem::path m_session;
+    std::filesystem::path m_csv;
+};
+
+TEST_F(CsvExporterTest, WritesRawAndDecodedRows)
+{
+    writeMixedSession(0);
+    CsvExporter exporter(m_session, m_csv, nullptr, 2);
+    const auto progress = exporter.wait();
+
+    EXPECT_EQ(progress.state, CsvExportState::Finished);
+    EXPECT_EQ(progress.frames, 5U);
+    EXPECT_EQ(progress.totalFrames, 5U);
+    EXPECT_EQ(progress.rows, 7U);
+    const auto text = readText(m_csv);
+    EXPECT_EQ(progress.bytes, text.size());
+    // Names and texts with separators or quotes are quoted, quotes doubled.
+    EXPECT_EQ(text,
+              "Timestamp,Interface,ID,DLC,Data,Signal,Value\n"
+              "1700000000.000000000,1,0x123,8,09 01 02 03 04 05 06 07,,\n"
+              "1700000000.000000000,2,0x7FF,2,FF 10,,\n"
+              "1700000001.000000000,0,0x100,,,EngineSpeed,2100.5\n"
+              "1700000001.000000000,0,0x100,,,Gear,0\n"
+              "1700000002.000000000,0,0x100,,,Gear,1\n"
+              "1700000003.000000000,0,0x100,,,Gear,2\n"
+              "1700000003.000000000,0,0x100,,,\"Oil,Temp\",-4.25\n");
+}
+
+TEST_F(CsvExporterTest, WritesValueDescriptionsOnlyForTheDbcOfTheSession)
+{
+    const auto dbc = makeDbc("Neutral");
+    writeMixedSession(dbc->contentHash());
+    {
+        CsvExporter exporter(m_session, m_csv, dbc, 1);
+        EXPECT_EQ(exporter.wait().state, CsvExportState::Finished);
+    }
+    EXPECT_EQ(readText(m_csv),
+              "Timestamp,Interface,ID,DLC,Data,Signal,Value\n"
+              "1700000000.000000000,1,0x123,8,09 01 02 03 04 05 06 07,,\n"
+              "1700000000.000000000,2,0x7FF,2,FF 10,,\n"
+              "1700000001.000000000,0,0x100,,,EngineSpeed,2100.5\n"
+              "1700000001.000000000,0,0x100,,,Gear,Neutral\n"
+              "1700000002.000000000,0,0x100,,,Gear,\"First, slow\"\n"
+              "1700000003.000000000,0,0x100,,,Gear,\"Say \"\"two\"\"\"\n"
+              "1700000003.000000000,0,0x100,,,\"Oil,Temp\",-4.25\n");
+
+    // Another DBC could describe other values, its texts are not used.
+    const auto other = makeDbc("Idle");
+    ASSERT_NE(other->contentHash(), dbc->contentHash());
+    CsvExporter exporter(m_session, m_csv, other, 1);
+    EXPECT_EQ(exporter.wait().state, CsvExportState::Finished);
+    const auto text = readText(m_csv);
+    EXPECT_NE(text.find("0x100,,,Gear,0\n"), std::string::npos);
+    EXPECT_EQ(text.find("Idle"), std::string::npos);
+}
+
+TEST_F(CsvExporterTest, CancelRemovesTheIncompleteFile)
+{
+    writeLargeSession(300'000);
+    CsvExporter exporter(m_session, m_csv, nullptr, 1);
+    exporter.cancel();
+    const auto progress = exporter.wait();
+
+    EXPECT_EQ(progress.state, CsvExportState::Cancelled);
+    EXPECT_LT(progress.frames, progress.totalFrames);
+    EXPECT_FALSE(std::filesystem::exists(m_csv));
+}
+
+TEST_F(CsvExporterTest, WaitRethrowsTheErrorOfTheExport)
+{
+    writeLargeSession(40'000);
+    std::vector<Logging::SessionChunk> chunks;
+    {
+        const Logging::SessionReader reader(m_session);
+        chunks.assign(reader.chunks().begin(), reader.chunks().end());
+    }
+    ASSERT_GE(chunks.size(), 3U);
+    // An unknown record kind in the middle of the session, the index still looks intact.
+    {
+        std::fstream file(m_session, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(chunks[1].offset +
+                                               Logging::SessionFormat::chunkHeaderSize));
+        file.put(static_cast<char>(0x7F));
+    }
+
+    CsvExporter exporter(m_session, m_csv, nullptr, 2);
+    EXPECT_THROW(exporter.wait(), std::runtime_error);
+    EXPECT_EQ(exporter.progress().state, CsvExportState::Failed);
+    EXPECT_FALSE(std::filesystem::exists(m_csv));
+
+    EXPECT_THROW(CsvExporter(m_session, m_csv / "missing" / "export.csv", nullptr),
+                 std::runtime_error);
+}
+
+}  // namespace
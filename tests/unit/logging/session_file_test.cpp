@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "core/dto/can_dto.hpp"
+#include "logging/model/session_file.hpp"
+
+namespace {
+
+using Logging::FrameQuery;
+using Logging::LogEntry;
+using Logging::SessionReader;
+using Logging::SessionWriter;
+using Logging::SignalValue;
+
+constexpr std::time_t startSecond = 1'700'000'000;
+
+auto rawFrame(const std::time_t receiveTime, const uint32_t messageId,
+              const Core::InterfaceId interfaceId, const char firstByte) -> Core::RawCanMessage
+{
+    return {receiveTime, {firstByte, 1, 2, 3, 4, 5, 6, 7}, messageId, interfaceId};
+}
+
+/** @brief Reads a whole file, for tests that damage it. */
+auto readBytes(const std::filesystem::path& path) -> std::vector<char>
+{
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+void writeBytes(const std::filesystem::path& path, const std::vector<char>& bytes)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+class SessionFileTest : public ::testing::Test
+{
+   protected:
+    void SetUp() override
+    {
+        m_path = std::filesystem::temp_directory_path() /
+                 (std::string("session_file_test_") +
+                  ::testing::UnitTest::GetInstance()->current_test_info()->name() +
+                  std::string(Logging::SessionFormat::extension));
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(m_path);
+    }
+
+    /**
+     * @brief Writes a closed session of raw frames of the IDs 0x100 to 0x10F, one second per
+     * 1000 frames, spanning several chunks.
+     * @return The chunks of the session.
+     */
+    auto writeRawSession(const std::size_t frames) -> std::vector<Logging::SessionChunk>
+    {
+        SessionWriter writer(m_path, {"raw", "vcan0", 0, 0});
+        for (std::size_t i = 0; i < frames; ++i)
+        {
+            const auto frame =
+                rawFrame(startSecond + static_cast<std::time_t>(i / 1000),
+                         static_cast<uint32_t>(0x100 + i % 16), 0, static_cast<char>(i));
+            writer.append(std::span(&frame, 1));
+        }
+        writer.close();
+        EXPECT_EQ(writer.summary().droppedFrames, 0U);
+        return writer.chunks();
+    }
+
+    std::filesystem::path m_path;
+};
+
+TEST_F(SessionFileTest, RoundTripKeepsMetadataAndFrames)
+{
+    const Logging::SessionMetadata metadata{"session-1", "can0", 42, 0xABCDEF};
+    {
+        SessionWriter writer(m_path, metadata);
+        std::vector<Core::RawCanMessage> burst{rawFrame(startSecond, 0x123, 1, 9),
+                                               rawFrame(startSecond, 0x7FF, 2, -1)};
+        burst[1].dlc = 2;
+        writer.append(burst);
+        writer.append(Core::DbcCanMessage{
+            startSecond + 1, {{"EngineSpeed", 2100.5}, {"Gear", 3.0}}, 0x100, 0});
+        writer.append(Core::DbcCanMessage{startSecond + 2, {{"Gear", 4.0}}, 0x100, 0});
+    }
+
+    SessionReader reader(m_path);
+    EXPECT_TRUE(reader.complete());
+    EXPECT_EQ(reader.metadata().id, metadata.id);
+    EXPECT_EQ(reader.metadata().deviceName, metadata.deviceName);
+    EXPECT_EQ(reader.metadata().startTime, metadata.startTime);
+    EXPECT_EQ(reader.metadata().dbcHash, metadata.dbcHash);
+    EXPECT_EQ(reader.summary().frames, 4U);
+    EXPECT_EQ(reader.summary().firstTimestamp, Logging::SessionFormat::toTimestamp(startSecond));
+    EXPECT_EQ(reader.summary().lastTimestamp,
+              Logging::SessionFormat::toTimestamp(startSecond + 2));
+    ASSERT_EQ(reader.signalNames().size(), 2U);
+
+    LogEntry entry;
+    std::vector<SignalValue> values;
+    ASSERT_TRUE(reader.next(entry, values));
+    EXPECT_EQ(entry.messageId, 0x123U);
+    EXPECT_EQ(entry.interfaceId, 1);
+    EXPECT_EQ(entry.flags & LogEntry::Decoded, 0);
+    EXPECT_EQ(entry.dlc, 8);
+    EXPECT_EQ(entry.data[0], 9);
+    EXPECT_TRUE(values.empty());
+
+    ASSERT_TRUE(reader.next(entry, values));
+    EXPECT_EQ(entry.messageId, 0x7FFU);
+    EXPECT_EQ(entry.dlc, 2);
+    EXPECT_EQ(entry.data[0], 0xFF);
+
+    ASSERT_TRUE(reader.next(entry, values));
+    EXPECT_NE(entry.flags & LogEntry::Decoded, 0);
+    EXPECT_EQ(entry.dlc, 0);
+    EXPECT_EQ(entry.timestamp, Logging::SessionFormat::toTimestamp(startSecond + 1));
+    ASSERT_EQ(values.size(), 2U);
+    EXPECT_EQ(reader.signalNames().name(values[0].signal), "EngineSpeed");
+    EXPECT_DOUBLE_EQ(values[0].value, 2100.5);
+    EXPECT_EQ(reader.signalNames().name(values[1].signal), "Gear");
+
+    ASSERT_TRUE(reader.next(entry, values));
+    ASSERT_EQ(values.size(), 1U);
+    EXPECT_EQ(reader.signalNames().name(values[0].signal), "Gear");
+    EXPECT_DOUBLE_EQ(values[0].value, 4.0);
+
+    EXPECT_FALSE(reader.next(entry, values));
+}
+
+TEST_F(SessionFileTest, RecoversTornFileUpToLastCompleteChunk)
+{
+    const auto chunks = writeRawSession(40'000);
+    ASSERT_GE(chunks.size(), 3U);
+
+    // A crash while writing the last chunk: no footer, no trailer and half a chunk.
+    const auto& torn = chunks.back();
+    auto bytes = readBytes(m_path);
+    bytes.resize(torn.offset + Logging::SessionFormat::chunkHeaderSize + torn.size / 2);
+    writeBytes(m_path, bytes);
+
+    SessionReader reader(m_path);
+    EXPECT_FALSE(reader.complete());
+    ASSERT_EQ(reader.chunks().size(), chunks.size() - 1);
+    uint64_t expectedFrames = 0;
+    for (std::size_t i = 0; i + 1 < chunks.size(); ++i)
+    {
+        EXPECT_EQ(reader.chunks()[i].offset, chunks[i].offset);
+        EXPECT_EQ(reader.chunks()[i].frames, chunks[i].frames);
+        EXPECT_EQ(reader.chunks()[i].messageIds, chunks[i].messageIds);
+        expectedFrames += chunks[i].frames;
+    }
+    EXPECT_EQ(reader.summary().frames, expectedFrames);
+
+    std::vector<LogEntry> entries;
+    Logging::SignalStore store;
+    reader.readAll(entries, store);
+    ASSERT_EQ(entries.size(), expectedFrames);
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        ASSERT_EQ(entries[i].messageId, 0x100 + i % 16);
+        ASSERT_EQ(entries[i].data[0], static_cast<uint8_t>(i));
+    }
+}
+
+TEST_F(SessionFileTest, FrameQueryFiltersByTimeAndId)
+{
+    const auto chunks = writeRawSession(40'000);
+    SessionReader reader(m_path);
+    ASSERT_TRUE(reader.complete());
+
+    FrameQuery query;
+    query.from = Logging::SessionFormat::toTimestamp(startSecond + 12);
+    query.to = Logging::SessionFormat::toTimestamp(startSecond + 13);
+    query.firstId = 0x104;
+    query.lastId = 0x105;
+
+    std::vector<LogEntry> entries;
+    Logging::SignalStore store;
+    reader.read(query, entries, store);
+
+    // Seconds 12 and 13 hold frames 12000 to 13999, two of every 16 IDs match.
+    ASSERT_EQ(entries.size(), 2000U / 16 * 2);
+    for (const auto& entry : entries)
+    {
+        EXPECT_TRUE(query.matches(entry));
+    }
+
+    // The chunk index rules out the chunks outside the time range without reading them.
+    std::size_t candidates = 0;
+    for (const auto& chunk : reader.chunks())
+    {
+        candidates += chunk.mayMatch(query) ? 1 : 0;
+    }
+    EXPECT_GE(candidates, 1U);
+    EXPECT_LT(candidates, chunks.size());
+
+    FrameQuery noId;
+    noId.firstId = 0x200;
+    noId.lastId = 0x2FF;
+    for (const auto& chunk : reader.chunks())
+    {
+        EXPECT_FALSE(chunk.mayMatch(noId));
+    }
+    entries.clear();
+    reader.read(noId, entries, store);
+    EXPECT_TRUE(entries.empty());
+}
+
+TEST_F(SessionFileTest, RejectsCorruptFooter)
+{
+    writeRawSession(100);
+    auto bytes = readBytes(m_path);
+
+    // The trailer holds the footer offset; the footer starts with the dropped frame count and
+    // the number of signal names, which is zero, followed by the number of chunks.
+    uint64_t footerOffset = 0;
+    std::memcpy(&footerOffset, bytes.data() + bytes.size() - Logging::SessionFormat::trailerSize,
+                sizeof(footerOffset));
+    const auto chunkCountOffset = footerOffset + sizeof(uint64_t) + sizeof(uint32_t);
+    ASSERT_LT(chunkCountOffset + sizeof(uint32_t), bytes.size());
+    const uint32_t hugeCount = 0x7FFFFFFF;
+    std::memcpy(bytes.data() + chunkCountOffset, &hugeCount, sizeof(hugeCount));
+    writeBytes(m_path, bytes);
+
+    EXPECT_THROW(SessionReader reader(m_path), std::runtime_error);
+}
+
+TEST_F(SessionFileTest, RejectsFileThatIsNoSession)
+{
+    writeBytes(m_path, {'n', 'o', 't', ' ', 'a', ' ', 's', 'e', 's', 's', 'i', 'o', 'n'});
+    EXPECT_THROW(SessionReader reader(m_path), std::runtime_error);
+}
+
+}  // namespace
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "logging/model/signal_store.hpp"
+
+namespace {
+
+using Logging::SignalHandle;
+using Logging::SignalStore;
+using Logging::SignalValue;
+
+constexpr std::chrono::nanoseconds chunkDuration(100);
+
+/**
+ * @brief A store with the signals "Ramp" (the timestamp) and "Negative" (minus the timestamp, only
+ * at even timestamps), one frame per nanosecond from 0 to 999, i.e. ten chunks.
+ */
+class SignalStoreTest : public ::testing::Test
+{
+   protected:
+    void SetUp() override
+    {
+        m_ramp = m_store.signal("Ramp");
+        m_negative = m_store.signal("Negative");
+        for (int64_t timestamp = 0; timestamp < 1000; ++timestamp)
+        {
+            appendFrame(timestamp);
+        }
+    }
+
+    void appendFrame(const int64_t timestamp)
+    {
+        const auto value = static_cast<double>(timestamp);
+        const std::vector<SignalValue> values{{m_ramp, value}, {m_negative, -value}};
+        m_store.append(timestamp, std::span(values).first(timestamp % 2 == 0 ? 2 : 1));
+    }
+
+    SignalStore m_store{chunkDuration};
+    SignalHandle m_ramp = 0;
+    SignalHandle m_negative = 0;
+};
+
+TEST_F(SignalStoreTest, InternsSignalNamesOnce)
+{
+    EXPECT_EQ(m_store.signal("Ramp"), m_ramp);
+    EXPECT_EQ(m_store.dictionary().size(), 2U);
+    EXPECT_EQ(m_store.dictionary().name(m_negative), "Negative");
+    EXPECT_EQ(m_store.dictionary().find("Negative"), m_negative);
+    EXPECT_FALSE(m_store.dictionary().find("Missing").has_value());
+    EXPECT_EQ(m_store.chunkCount(), 10U);
+    EXPECT_EQ(m_store.valueCount(), 1500U);
+}
+
+TEST_F(SignalStoreTest, RangeReturnsTheValuesInTimeOrder)
+{
+    std::vector<int64_t> timestamps;
+    std::vector<double> values;
+    m_store.range(m_ramp, 150, 349, timestamps, values);
+    ASSERT_EQ(timestamps.size(), 200U);
+    ASSERT_EQ(values.size(), 200U);
+    for (std::size_t i = 0; i < timestamps.size(); ++i)
+    {
+        EXPECT_EQ(timestamps[i], static_cast<int64_t>(150 + i));
+        EXPECT_DOUBLE_EQ(values[i], static_cast<double>(150 + i));
+    }
+
+    // Results are appended.
+    m_store.range(m_negative, 0, 9, timestamps, values);
+    ASSERT_EQ(timestamps.size(), 205U);
+    EXPECT_EQ(timestamps.back(), 8);
+    EXPECT_DOUBLE_EQ(values.back(), -8.0);
+
+    timestamps.clear();
+    values.clear();
+    m_store.range(m_ramp, 1000, 2000, timestamps, values);
+    m_store.range(m_ramp, 300, 299, timestamps, values);
+    EXPECT_TRUE(timestamps.empty());
+}
+
+TEST_F(SignalStoreTest, AboveReturnsTheTimestampsOverTheThreshold)
+{
+    std::vector<int64_t> timestamps;
+    m_store.above(m_ramp, 849.5, 0, 999, timestamps);
+    ASSERT_EQ(timestamps.size(), 150U);
+    EXPECT_EQ(timestamps.front(), 850);
+    EXPECT_EQ(timestamps.back(), 999);
+
+    timestamps.clear();
+    m_store.above(m_ramp, 100.0, 0, 120, timestamps);
+    ASSERT_EQ(timestamps.size(), 20U);
+    EXPECT_EQ(timestamps.front(), 101);
+
+    timestamps.clear();
+    m_store.above(m_negative, 0.0, 0, 999, timestamps);
+    EXPECT_TRUE(timestamps.empty());
+}
+
+TEST_F(SignalStoreTest, ZoneSummarizesTheTimeRange)
+{
+    const auto zone = m_store.zone(m_ramp, 250, 449);
+    EXPECT_EQ(zone.count, 200U);
+    EXPECT_DOUBLE_EQ(zone.min, 250.0);
+    EXPECT_DOUBLE_EQ(zone.max, 449.0);
+    EXPECT_EQ(zone.firstTimestamp, 250);
+    EXPECT_EQ(zone.lastTimestamp, 449);
+
+    const auto negative = m_store.zone(m_negative, 0, 999);
+    EXPECT_EQ(negative.count, 500U);
+    EXPECT_DOUBLE_EQ(negative.min, -998.0);
+    EXPECT_DOUBLE_EQ(negative.max, 0.0);
+
+    EXPECT_EQ(m_store.zone(m_ramp, 5000, 6000).count, 0U);
+}
+
+TEST_F(SignalStoreTest, LateValuesStayQueryable)
+{
+    // Stored in the last chunk, which starts at 900, but belongs to the time of the first.
+    const std::vector<SignalValue> late{{m_ramp, 5000.0}};
+    m_store.append(50, late);
+    EXPECT_EQ(m_store.chunkCount(), 10U);
+
+    std::vector<int64_t> timestamps;
+    std::vector<double> values;
+    m_store.range(m_ramp, 40, 60, timestamps, values);
+    ASSERT_EQ(timestamps.size(), 22U);
+    EXPECT_EQ(timestamps.back(), 50);
+    EXPECT_DOUBLE_EQ(values.back(), 5000.0);
+
+    timestamps.clear();
+    m_store.above(m_ramp, 999.0, 0, 100, timestamps);
+    ASSERT_EQ(timestamps.size(), 1U);
+    EXPECT_EQ(timestamps.front(), 50);
+
+    const auto zone = m_store.zone(m_ramp, 0, 99);
+    EXPECT_EQ(zone.count, 101U);
+    EXPECT_DOUBLE_EQ(zone.max, 5000.0);
+
+    // The late value does not leak into ranges that exclude its timestamp.
+    timestamps.clear();
+    values.clear();
+    m_store.range(m_ramp, 900, 999, timestamps, values);
+    EXPECT_EQ(timestamps.size(), 100U);
+    EXPECT_DOUBLE_EQ(m_store.zone(m_ramp, 900, 999).max, 999.0);
+}
+
+TEST_F(SignalStoreTest, AppendRejectsUnknownHandles)
+{
+    const std::vector<SignalValue> values{{m_ramp, 1.0}, {7, 2.0}};
+    EXPECT_THROW(m_store.append(1000, values), std::out_of_range);
+    EXPECT_EQ(m_store.valueCount(), 1500U);
+    EXPECT_EQ(m_store.zone(m_ramp, 1000, 1000).count, 0U);
+}
+
+TEST(SignalStoreChunkDurationTest, RejectsNonPositiveDuration)
+{
+    EXPECT_THROW(SignalStore(std::chrono::nanoseconds(0)), std::invalid_argument);
+    EXPECT_THROW(SignalStore(std::chrono::nanoseconds(-1)), std::invalid_argument);
+}
+
+}  // namespace